@@ -3,7 +3,12 @@
 
 • Painel de LOG só mostra lines 'log'.  
 • Parâmetro --debug continua igual.  
-• Agora interpreta DATA‑<des‑val>‑<s1>‑<s2>‑<mixer>.  
+• Agora interpreta DATA‑<des‑val>‑<s1>‑<s2>‑<mixer>; temperaturas em °C
+  com 2 casas (ex. DATA-67.00-66.81-66.94-0).  
+• EST-t=<°C> r=<°C/s> e1=<res1> e2=<res2> (estimador): curva ESTIMADO,
+  resíduos só no --debug.  
+• ETA-rest=<s> etapa=<s> rampa=<s> (tempo restante da receita): título
+  do gráfico com o fim previsto da brassagem e da etapa.  
 """
 
 from __future__ import annotations
@@ -49,6 +54,8 @@ class SerialReader(threading.Thread):
 
 # ---------- parsing -----------------------------------------------------
 _RE_DATA=re.compile(r"^DATA-(.+)$")
+_RE_EST =re.compile(r"^EST-(.+)$")
+_RE_ETA =re.compile(r"^ETA-(.+)$")
 _RE_BOOT=re.compile(r"^(load:|entry |rst:|clk_ets |configsip:|mode:|q_drv:|d_drv:|Boot|ESP-ROM)", re.I)
 
 def parse_line(line:str):
@@ -56,18 +63,32 @@ def parse_line(line:str):
     if not line: return "log",""
     if (m:=_RE_DATA.match(line)):
         parts=[p for p in m.group(1).split("-") if p]
-        try: vals=list(map(int,parts))
+        try: vals=list(map(float,parts))   # °C com 2 casas (firmware em centésimos)
         except ValueError: return "error",f"ERRO-Invalid DATA: {line}"
         if len(vals)<4:    return "error",f"ERRO-Incomplete DATA: {line}"
         desejo,s1,s2,mix=vals[-4:]     # garante 4 valores
-        mix = 0 if str(mix).lower() in ("0","false","f") else 1
+        mix = 1 if mix else 0
         return "data",(desejo,s1,s2,mix)
+    if (m:=_RE_EST.match(line)):
+        try: est={k:float(v) for k,v in (kv.split("=",1) for kv in m.group(1).split())}
+        except ValueError: return "error",f"ERRO-Invalid EST: {line}"
+        if "t" not in est: return "error",f"ERRO-Incomplete EST: {line}"
+        return "est",est
+    if (m:=_RE_ETA.match(line)):
+        try: eta={k:float(v) for k,v in (kv.split("=",1) for kv in m.group(1).split())}
+        except ValueError: return "error",f"ERRO-Invalid ETA: {line}"
+        if "rest" not in eta: return "error",f"ERRO-Incomplete ETA: {line}"
+        return "eta",eta
     if _RE_BOOT.match(line):            return "log",line
     if line.lower().startswith("log-"): return "log",line.split("-",1)[1]
     if line.startswith("E ("):          return "error",f"ERRO-{line}"
     if line.startswith("ERROR-"):       return "error",line
     return "log",line
 
+def fmt_sec(s:float)->str:
+    if s<0: return "--:--:--"
+    s=int(round(s)); return f"{s//3600:d}:{s//60%60:02d}:{s%60:02d}"
+
 # ---------- GUI helpers -------------------------------------------------
 def build_tx_entry(root, send_cb):
     f=tk.Frame(root); f.pack(side=tk.BOTTOM,fill=tk.X)
@@ -91,13 +112,15 @@ def live_plot(port:str, baud:int, debug:bool, max_pts=200):
         if cmd: reader.ser.write((cmd+"\n").encode()); dprint(debug,f"[TX] {cmd}")
     threading.Thread(target=lambda:[serial_send(l.strip()) for l in sys.stdin],daemon=True).start()
 
-    xs,des,s1,s2,mix=(deque(maxlen=max_pts) for _ in range(5)); idx=0
+    xs,des,s1,s2,mix,est=(deque(maxlen=max_pts) for _ in range(6)); idx=0
+    last_est=float("nan")
     style.use("ggplot"); fig,ax=plt.subplots()
     ax.set(xlabel="Sample #",ylabel="Value",xlim=(0,max_pts),ylim=(0,100))
     lineD,=ax.plot([],"b-",lw=2,label="DESEJADO")        # azul
     lineS1,=ax.plot([],"r-",lw=2,label="SENSOR1")        # vermelho
     lineS2,=ax.plot([],"g-",lw=2,label="SENSOR2")        # verde
     lineM,=ax.plot([],"y-",lw=2,label="MIXER_STATUS")    # amarelo
+    lineE,=ax.plot([],"k--",lw=1,label="ESTIMADO")       # preto tracejado
     ax.legend(loc="upper left")
 
     root=fig.canvas.manager.window
@@ -107,7 +130,7 @@ def live_plot(port:str, baud:int, debug:bool, max_pts=200):
     splitter=re.compile(r"(?:\\n|\n|/n)")
 
     def update(_):
-        nonlocal idx
+        nonlocal idx,last_est
         while not rx_q.empty():
             for part in splitter.split(rx_q.get()):
                 if not part: continue
@@ -116,15 +139,22 @@ def live_plot(port:str, baud:int, debug:bool, max_pts=200):
                     log_append(pay); print(f"[LOG] {pay}") if debug else None
                 elif kind=="error" and debug:
                     print(pay)
+                elif kind=="eta":
+                    ax.set_title(f"Fim em {fmt_sec(pay['rest'])}  (etapa {fmt_sec(pay.get('etapa',-1))})")
+                    dprint(debug,f"[ETA] {pay}")
+                elif kind=="est":
+                    last_est=pay["t"]
+                    dprint(debug,f"[EST] {pay}")
                 elif kind=="data":
                     desejo,s1v,s2v,mixv=pay
                     des.append(desejo); s1.append(s1v); s2.append(s2v); mix.append(mixv)
+                    est.append(last_est)
                     xs.append(idx); idx+=1
                     dprint(debug,f"[DATA] {pay}")
         lineD.set_data(xs,des); lineS1.set_data(xs,s1)
-        lineS2.set_data(xs,s2); lineM.set_data(xs,mix)
+        lineS2.set_data(xs,s2); lineM.set_data(xs,mix); lineE.set_data(xs,est)
         if xs: ax.set_xlim(xs[0], xs[-1]+1)
-        return lineD,lineS1,lineS2,lineM
+        return lineD,lineS1,lineS2,lineM,lineE
 
     ani=animation.FuncAnimation(fig,update,interval=100,blit=False,cache_frame_data=False)
     globals()['_ani']=ani
@@ -0,0 +1,86 @@
+#include "ApproachController.hpp"
+
+void ApproachController::setEnabled(bool en)
+{
+    enabled_ = en;
+    if (!en && phase_ == Phase::FullPower) {
+        phase_    = Phase::Pid;
+        handover_ = true;
+        loss_     = -1.0f;       // rampa interrompida: volta ao modelo
+        lostSum_  = devSum_ = 0;
+    }
+    lastSp_ = -1000.0f;          // reavalia na próxima chamada
+}
+
+float ApproachController::coastRise(float sp, float pv, const ThermalModel& m)
+{
+    // durante o tempo morto o tanque ainda recebe a diferença entre
+    // plena potência e o duty de regime que o PID assumirá
+    float excess = m.slope(pv, 1.0f) - m.slope(pv, m.steadyDuty(sp));
+    return (excess > 0.0f) ? excess * m.deadTime : 0.0f;
+}
+
+bool ApproachController::update(float sp, float pv, const ThermalModel& m)
+{
+    if (!enabled_) return false;
+
+    // nova etapa: decide se vale a pena a aproximação a plena potência
+    if (sp != lastSp_) {
+        lastSp_ = sp;
+        if (sp - pv > p_.engageBand) {
+            phase_   = Phase::FullPower;
+            elapsed_ = 0;
+        }
+    }
+
+    // perda medida na rampa: só depois do tempo morto e do atraso da PV
+    // o calor da plena potência aparece na leitura; trapézios entre as
+    // leituras novas, já que a PV fica retida entre amostras
+    if (phase_ == Phase::FullPower) {
+        elapsed_ += p_.period;
+        if (elapsed_ <= m.deadTime + p_.settle) {
+            fromAt_ = -1.0f;
+            lastPv_ = pv;
+        } else if (fromAt_ < 0.0f) {
+            if (pv != lastPv_) {
+                from_    = lastPv_ = pv;
+                fromAt_  = lastAt_ = elapsed_;
+                rampDev_ = 0;
+            }
+        } else if (pv != lastPv_) {
+            rampDev_ += 0.5f * (pv + lastPv_ - 2.0f * m.ambient) * (elapsed_ - lastAt_);
+            lastPv_ = pv;
+            lastAt_ = elapsed_;
+        }
+    }
+
+    const float coast = p_.predictive ? coastRise(sp, pv, m) : 0.0f;
+    if (phase_ == Phase::FullPower && pv + coast >= sp - p_.switchMargin) {
+        phase_    = Phase::Pid;
+        handover_ = true;
+        // a perda é da planta: acumula as rampas medidas (as longas pesam
+        // mais, pelo ∫(T − Ta)·dt); rampa curta demais não muda a estimativa
+        const float lost = m.heatGain * (lastAt_ - fromAt_) - (lastPv_ - from_);
+        if (fromAt_ >= 0.0f && lost >= p_.minLoss && rampDev_ > 0.0f) {
+            lostSum_ += lost;
+            devSum_  += rampDev_;
+            loss_     = lostSum_ / devSum_;
+        }
+    }
+    return phase_ == Phase::FullPower;
+}
+
+float ApproachController::steadyDuty(float sp, const ThermalModel& m) const
+{
+    if (loss_ < 0.0f) return m.steadyDuty(sp);
+    ThermalModel measured = m;
+    measured.lossCoef = loss_;
+    return measured.steadyDuty(sp);
+}
+
+bool ApproachController::takeHandover()
+{
+    bool h = handover_;
+    handover_ = false;
+    return h;
+}
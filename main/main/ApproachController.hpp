@@ -0,0 +1,85 @@
+/*  ApproachController.hpp
+ *  -------------------------------------------------------------
+ *  Aproximação de tempo mínimo para cada etapa da curva.
+ *
+ *  Longe do set-point o PID satura de qualquer forma; a saída da
+ *  saturação é onde surge o sobressinal. Este controlador mantém o
+ *  aquecedor a 100 % até o ponto de comutação previsto pelo
+ *  ThermalModel (calor ainda "em trânsito" durante o tempo morto) e
+ *  então devolve o controle ao PID com o integrador pré-carregado
+ *  com o duty de regime do novo set-point (transferência sem salto).
+ *
+ *  O duty de regime usa a perda medida na própria rampa, e não a
+ *  lossCoef do modelo: a plena potência dT/dt = G − k·(T − Ta), logo
+ *
+ *      k = (G·Δt − ΔT) / ∫(T − Ta)·dt
+ *
+ *  entre leituras novas (a PV só muda a cada amostra do I2CTask)
+ *  depois do tempo morto e do atraso da PV. Só G e Ta vêm do modelo; um erro
+ *  de 2× na perda desloca o pré-carregamento o bastante para o PID
+ *  (integral dominante) ir abaixo da banda e voltar com sobressinal.
+ *  As rampas medidas se acumulam (Σ perdido / Σ ∫(T − Ta)·dt): degraus
+ *  pequenos (poucos segundos de rampa na planta rápida) medem mal ou
+ *  nada, e a do modelo só vale até a primeira rampa medida.
+ *
+ *  Com predictive = false comuta já na borda sp − switchMargin, sem
+ *  prever o calor em trânsito: é o anti-windup do PID puro, que
+ *  evita integrar a rampa inteira e o sobressinal que vem dela.
+ */
+#pragma once
+#include "ThermalModel.hpp"
+
+class ApproachController {
+public:
+    enum class Phase { Pid, FullPower };
+
+    struct Params {
+        float engageBand   = 2.0f;   // °C abaixo do sp para iniciar plena potência
+        float switchMargin = 0.25f;  // °C de folga no ponto de comutação
+        bool  predictive   = true;   // false: ignora o tempo morto (coastRise)
+        float period       = 0.01f;  // s entre chamadas de update() (PidTask)
+        float settle       = 4.0f;   // s além do tempo morto até a PV seguir a rampa
+        float minLoss      = 1.0f;   // °C perdidos na rampa para confiar na medida
+    };
+
+    ApproachController() = default;
+    explicit ApproachController(const Params& p) : p_(p) {}
+
+    void setEnabled(bool en);
+    bool enabled() const { return enabled_; }
+
+    /** Avalia a fase para o ciclo atual.
+     *  @return true enquanto o aquecedor deve ficar a plena potência. */
+    bool update(float sp, float pv, const ThermalModel& m);
+
+    /** true uma única vez, no ciclo da passagem FullPower → Pid. */
+    bool takeHandover();
+
+    /** Duty de regime (0..1) para `sp` com a perda medida nas rampas;
+     *  a do modelo se nenhuma rampa pôde medi-la. */
+    float steadyDuty(float sp, const ThermalModel& m) const;
+
+    /** Perda (1/s) medida nas rampas; < 0 se nenhuma mensurável. */
+    float measuredLoss() const { return loss_; }
+
+    Phase phase() const { return phase_; }
+
+    /** Elevação prevista (°C) após cortar para o duty de regime. */
+    static float coastRise(float sp, float pv, const ThermalModel& m);
+
+private:
+    Params p_{};
+    Phase  phase_    = Phase::Pid;
+    float  lastSp_   = -1000.0f;
+    bool   handover_ = false;
+    bool   enabled_  = false;
+    float  elapsed_  = 0;        // s desde o início da rampa
+    float  from_     = 0;        // °C na 1ª leitura medida
+    float  fromAt_   = -1.0f;    // s da 1ª leitura medida (<0: nenhuma)
+    float  lastPv_   = 0;        // °C da última leitura nova
+    float  lastAt_   = 0;        // s da última leitura nova
+    float  rampDev_  = 0;        // ∫(T − Ta)·dt entre as leituras (°C·s)
+    float  lostSum_  = 0;        // °C perdidos nas rampas medidas
+    float  devSum_   = 0;        // ∫(T − Ta)·dt nas mesmas rampas (°C·s)
+    float  loss_     = -1.0f;
+};
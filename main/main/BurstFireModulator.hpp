@@ -0,0 +1,55 @@
+/*  BurstFireModulator.hpp
+ *  -------------------------------------------------------------
+ *  Modulador sigma-delta de primeira ordem para relés de estado
+ *  sólido (SSR) de rede: converte o duty do controlador em blocos
+ *  de semiciclos inteiros, ligando ou desligando só nas passagens
+ *  por zero.
+ *
+ *  A cada bloco de `block` semiciclos o duty é somado a um
+ *  acumulador; quando passa de maxDuty o bloco inteiro conduz e
+ *  maxDuty é subtraído. Os blocos ligados ficam distribuídos
+ *  uniformemente e a potência média é exatamente duty/maxDuty.
+ *  block = 2 (ciclo completo) evita componente DC na rede; blocos
+ *  maiores reduzem o número de comutações na mesma proporção.
+ *
+ *  Só aritmética inteira, inline, para ser chamado de ISR.
+ */
+#pragma once
+#include <stdint.h>
+
+class BurstFireModulator {
+public:
+    explicit BurstFireModulator(uint8_t block = 2) : block_(block ? block : 1) {}
+
+    void reset() { acc_ = 0; left_ = 0; }
+
+    /** Chamado a cada passagem por zero. @return true se o semiciclo
+     *  que começa deve conduzir. */
+    bool step(uint16_t duty, uint16_t maxDuty) {
+        if (left_ == 0) {
+            if (duty > maxDuty) duty = maxDuty;
+            acc_ += duty;
+            bool on = acc_ >= maxDuty;
+            if (on) acc_ -= maxDuty;
+
+            if (on != on_) ++switches_;
+            on_   = on;
+            left_ = block_;
+        }
+        --left_;
+        ++halfCycles_;
+        return on_;
+    }
+
+    bool     on() const         { return on_; }
+    uint32_t switches() const   { return switches_; }     // comutações do SSR
+    uint32_t halfCycles() const { return halfCycles_; }
+
+private:
+    uint8_t  block_;
+    uint8_t  left_       = 0;     // semiciclos restantes do bloco atual
+    uint32_t acc_        = 0;
+    bool     on_         = false;
+    uint32_t switches_   = 0;
+    uint32_t halfCycles_ = 0;
+};
@@ -8,7 +8,7 @@ void CallbackModule::configUART() { UartModule::configUART(); }
 
 void CallbackModule::configGPIO() {
     GPIO_Module::initPin(PIN_HEATER);
-    GPIO_Module::initPin(PIN_MIXER);
+    GPIO_Module::initPwm(PIN_MIXER, MIXER_PWM_FREQ, MIXER_PWM_BITS);
 }
 
 /* ---------- controle físico ---------- */
@@ -20,14 +20,25 @@ void CallbackModule::configGPIO() {
 
 void CallbackModule::writeMixer(sc::integer val)
 {
-    GPIO_Module::writePin(PIN_MIXER, val);
+    mixerOn = (val != 0);
+    GPIO_Module::writePwm(PIN_MIXER, mixerOn ? mixerDuty : 0);
+}
+
+void CallbackModule::setMixerSpeed(float speed)
+{
+    if (speed < 0.0f) speed = 0.0f;
+    if (speed > 1.0f) speed = 1.0f;
+    mixerDuty = static_cast<uint32_t>(lroundf(speed * MIXER_MAX_DUTY));
+    if (mixerOn) GPIO_Module::writePwm(PIN_MIXER, mixerDuty);
 }
 
 /* ---------- UART helpers ---------- */
 void CallbackModule::writeUartString(std::string msg) { UartModule::writeUart(msg); }
 void CallbackModule::writeUartInt(sc::integer v)      { UartModule::writeUartInt(v); }
+void CallbackModule::writeUartTemp(sc::integer v)     { UartModule::writeUartTemp(v); }
 
-sc::integer CallbackModule::op_getUartInt() { return lastUartInt; }
+sc::integer CallbackModule::op_getUartInt()  { return lastUartInt; }
+sc::integer CallbackModule::op_getUartTemp() { return lastUartTemp; }
 
 /* ---------- ConfigManager wrappers ---------- */
 void CallbackModule::op_InitConfig()          { ConfigManager::init(); }
@@ -62,6 +73,51 @@ bool CallbackModule::op_IsTimerRunning()          { return timerRunning; }
 //}
 sc::integer CallbackModule::op_SetTemperature(sc::integer value)
 {
-    setPoint = value;            // write já protegida pelo withSM()
+    setPoint = static_cast<centi_t>(value);   // write já protegida pelo withSM()
     return setPoint;
 }
+
+/* ---------- contabilidade (RF-10) ---------- */
+void CallbackModule::op_EnergyReset() { energy.startBrew(); }
+
+static void printAccount(const EnergyMeter& m, const char* name,
+                         const EnergyMeter::Account& a)
+{
+    float total = m.seconds(a.ticks);
+    float full  = m.heaterFullSec(a);
+    printf("log-%s: %.0f s | aquecedor %.0f s a plena potencia (%.0f %%)",
+           name, total, full, total > 0 ? 100.0f * full / total : 0.0f);
+    if (m.heaterWatts() > 0) printf(", %.1f Wh", m.heaterWh(a));
+    printf(" | misturador %.0f s\n", m.seconds(a.mixTicks));
+}
+
+// entrada de END_PROCESS (com smMtx): só pede; a PidTask congela os
+// contadores no próximo tick e a TempTask imprime fora do statechart
+void CallbackModule::op_EnergyReport()
+{
+    energy.stopBrew();
+    energyReportReq = true;
+}
+
+void CallbackModule::printEnergyReport()
+{
+    char name[24];
+    printf("log----- Aquecimento e mistura ----\n");
+    for (int i = 0; i < energy.steps(); ++i) {
+        snprintf(name, sizeof(name), "etapa %d", i);
+        printAccount(energy, name, energy.step(i));
+    }
+    printAccount(energy, "TOTAL", energy.total());
+}
+
+/* ---------- falhas (RF-07) ---------- */
+void CallbackModule::op_ReportFault(sc::integer code)
+{
+    // a saída do aquecedor já foi zerada pela PidTask; aqui só o aviso
+    switch (code) {
+    case 1:  printf("log-FALHA aquecedor: temperatura nao acompanha o duty (saida desligada, \"fault_clear\" libera)\n"); break;
+    case 2:  printf("log-FALHA sonda travada: leitura parada, estimador usa a outra\n"); break;
+    case 3:  printf("log-FALHA sondas divergentes\n"); break;
+    default: printf("log-FALHA codigo %ld\n", (long)code); break;
+    }
+}
@@ -5,12 +5,24 @@
 #include "ConfigManager.h"
 #include "GPIO_Module.hpp"
 #include "Uart_Module.hpp"
+#include "EnergyMeter.hpp"
+#include "Temperature.hpp"
 //#include "driver/gpio.h"
 
 // ajuste se seus pinos estiverem em outro header
 constexpr gpio_num_t PIN_HEATER = GPIO_NUM_18;
 constexpr gpio_num_t PIN_MIXER  = GPIO_NUM_5;
 
+// PWM do misturador (driver do motor)
+constexpr uint32_t MIXER_PWM_FREQ = 20000;   // Hz, acima da faixa audível
+constexpr uint8_t  MIXER_PWM_BITS = 8;
+constexpr uint32_t MIXER_MAX_DUTY = (1u << MIXER_PWM_BITS) - 1;
+
+// potência nominal do aquecedor para o relatório em Wh (0 = não informada;
+// ajustável pela serial com WATTSxxxx)
+constexpr float HEATER_WATTS = 0.0f;
+static_assert(EnergyMeter::MAX_STEPS == MAX_STEPS, "uma conta por etapa da curva");
+
 /**
  * Implementa TODAS as operações exigidas por Statechart::OperationCallback.
  * Qualquer método que você ainda não queira usar agora pode ficar vazio.
@@ -25,13 +37,19 @@ public:
     //void writeHeater(sc::integer val) override;
     void writeMixer (sc::integer val) override;
 
+    /** Velocidade do misturador (0..1) usada enquanto a statechart o
+     *  mantiver ligado (writeMixer(1)). */
+    void setMixerSpeed(float speed);
+    bool mixerRunning() const { return mixerOn; }
 
     /* ---- escrita UART ---- */
     void writeUartString(std::string msg) override;
     void writeUartInt(sc::integer v)      override;
+    void writeUartTemp(sc::integer v)     override;   // centésimos → "67.50"
 
-    /* ---- UART inteiro recebido ---- */
+    /* ---- UART inteiro / temperatura recebidos ---- */
     sc::integer op_getUartInt() override;
+    sc::integer op_getUartTemp() override;            // centésimos de °C
 
     /* ---- persistência / curvas ---- */
     void op_InitConfig()            override;
@@ -60,9 +78,26 @@ public:
     /* ---- set-point ---- */
     sc::integer op_SetTemperature(sc::integer idx) override;
 
+    /* ---- contabilidade de aquecimento/mistura (RF-10) ---- */
+    void op_EnergyReset()               override;
+    void op_EnergyReport()              override;
+
+    /* ---- falhas detectadas (RF-07) ---- */
+    void op_ReportFault(sc::integer code) override;
+
     /* ---- variáveis compartilhadas com as tasks ---- */
     int32_t lastUartInt = 0;
+    centi_t lastUartTemp = 0;                // mesma linha, lida com casas decimais
     bool    timerRunning = false;
     int32_t secLeft      = 0;
-    volatile int setPoint = 0;   // <-- TODO verificar volatile
+    volatile centi_t setPoint = 0;           // centésimos de °C
+    volatile centi_t nextSetPoint = TEMP_INVALID;   // set-point da próxima etapa (TEMP_INVALID = nenhuma)
+    EnergyMeter  energy;                     // alimentado pela PidTask a cada tick
+    volatile bool energyReportReq = false;   // op_EnergyReport → TempTask
+    /** Relatório do RF-10; chamar com os contadores congelados (energy.stopped()). */
+    void printEnergyReport();
+
+private:
+    bool     mixerOn   = false;
+    uint32_t mixerDuty = MIXER_MAX_DUTY;     // velocidade plena até o 1º ajuste
 };
@@ -9,15 +9,18 @@
 /*  Estáticos                                                                */
 /* ------------------------------------------------------------------------- */
 SemaphoreHandle_t ConfigManager::mutex_ = nullptr;
-int16_t  ConfigManager::temps_[MAX_STEPS]     = {0};
+centi_t  ConfigManager::temps_[MAX_STEPS]     = {0};
 uint32_t ConfigManager::durations_[MAX_STEPS] = {0};
 size_t   ConfigManager::stepCount_            = 0;
+CtrlMode ConfigManager::ctrlMode_             = CTRL_PID;
 
 /* Default de fábrica ------------------------------------------------------ */
 const BrewConfig ConfigManager::FACTORY_DEFAULT = {
     3,
-    {67, 78, 85},                 // temperaturas °C
-    {120, 180, 50}            // durações  s
+    {6700, 7800, 8500},           // temperaturas, centésimos de °C
+    {120, 180, 50},           // durações  s
+    CTRL_PID,
+    TEMP_SCALE
 };
 
 /* ------------------------------------------------------------------------- */
@@ -72,6 +75,8 @@ esp_err_t ConfigManager::saveToFlash()
         cfg.temperatures[i] = temps_[i];
         cfg.durations[i]    = durations_[i];
     }
+    cfg.ctrl_mode  = ctrlMode_;
+    cfg.temp_scale = TEMP_SCALE;
 
     if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
     nvs_handle_t h;
@@ -89,7 +94,7 @@ esp_err_t ConfigManager::loadFromFlash()
 {
     if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
     nvs_handle_t h;
-    BrewConfig cfg;
+    BrewConfig cfg {};                           // blob antigo (menor) → ctrl_mode = 0
     esp_err_t err = nvs_open("brew_cfg", NVS_READONLY, &h);
     if (err == ESP_OK) {
         size_t sz = sizeof(cfg);
@@ -99,9 +104,13 @@ esp_err_t ConfigManager::loadFromFlash()
     xSemaphoreGive(mutex_);
     if (err != ESP_OK) return err;
 
+    // receita gravada antes do ponto fixo: graus inteiros
+    const int scale = (cfg.temp_scale == TEMP_SCALE) ? 1 : TEMP_SCALE;
+
     clearSteps();
     for (size_t i = 0; i < cfg.step_count; ++i)
-        op_PushStep(cfg.temperatures[i], cfg.durations[i]);
+        op_PushStep(static_cast<centi_t>(cfg.temperatures[i] * scale), cfg.durations[i]);
+    setCtrlMode(static_cast<CtrlMode>(cfg.ctrl_mode));
 
     return ESP_OK;
 }
@@ -111,16 +120,127 @@ esp_err_t ConfigManager::resetToFactory()
     clearSteps();
     for (size_t i = 0; i < FACTORY_DEFAULT.step_count; ++i)
         op_PushStep(FACTORY_DEFAULT.temperatures[i], FACTORY_DEFAULT.durations[i]);
+    setCtrlMode(static_cast<CtrlMode>(FACTORY_DEFAULT.ctrl_mode));
 
     return saveToFlash();
 }
 
+/* ------------------------------------------------------------------------- */
+/*  Modelo térmico identificado                                             */
+/* ------------------------------------------------------------------------- */
+esp_err_t ConfigManager::saveModel(const ThermalModel& m)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(h, "model", &m, sizeof(m));
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    return err;
+}
+
+esp_err_t ConfigManager::loadModel(ThermalModel& m)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    ThermalModel tmp;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READONLY, &h);
+    if (err == ESP_OK) {
+        size_t sz = sizeof(tmp);
+        err = nvs_get_blob(h, "model", &tmp, &sz);
+        if (err == ESP_OK && sz != sizeof(tmp)) err = ESP_ERR_NVS_INVALID_LENGTH;
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    if (err == ESP_OK) m = tmp;
+    return err;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Papéis das sondas (SensorRegistry)                                      */
+/* ------------------------------------------------------------------------- */
+esp_err_t ConfigManager::saveSensorRoles(const SensorRoleEntry* e, size_t n)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = n ? nvs_set_blob(h, "sensors", e, n * sizeof(SensorRoleEntry))
+                : nvs_erase_key(h, "sensors");
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;    // nada a apagar
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    return err;
+}
+
+esp_err_t ConfigManager::loadSensorRoles(SensorRoleEntry* e, size_t& n)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READONLY, &h);
+    if (err == ESP_OK) {
+        size_t sz = n * sizeof(SensorRoleEntry);
+        err = nvs_get_blob(h, "sensors", e, &sz);
+        if (err == ESP_OK && sz % sizeof(SensorRoleEntry)) err = ESP_ERR_NVS_INVALID_LENGTH;
+        if (err == ESP_OK) n = sz / sizeof(SensorRoleEntry);
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    return err;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Calibração das sondas (SensorCalibration)                               */
+/* ------------------------------------------------------------------------- */
+esp_err_t ConfigManager::saveSensorCal(const SensorCalEntry* e, size_t n)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = n ? nvs_set_blob(h, "calib", e, n * sizeof(SensorCalEntry))
+                : nvs_erase_key(h, "calib");
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;    // nada a apagar
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    return err;
+}
+
+esp_err_t ConfigManager::loadSensorCal(SensorCalEntry* e, size_t& n)
+{
+    if (!mutex_) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(500)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("brew_cfg", NVS_READONLY, &h);
+    if (err == ESP_OK) {
+        size_t sz = n * sizeof(SensorCalEntry);
+        err = nvs_get_blob(h, "calib", e, &sz);
+        if (err == ESP_OK && sz % sizeof(SensorCalEntry)) err = ESP_ERR_NVS_INVALID_LENGTH;
+        if (err == ESP_OK) n = sz / sizeof(SensorCalEntry);
+        nvs_close(h);
+    }
+    xSemaphoreGive(mutex_);
+    return err;
+}
+
 /* ------------------------------------------------------------------------- */
 /*  Array em RAM                                                            */
 /* ------------------------------------------------------------------------- */
 size_t ConfigManager::getStepCount() { return stepCount_; }
 
-void ConfigManager::op_PushStep(int16_t temp, uint32_t dur)
+void ConfigManager::op_PushStep(centi_t temp, uint32_t dur)
 {
     if (stepCount_ >= MAX_STEPS);
     temps_[stepCount_]     = temp;
@@ -136,9 +256,9 @@ void ConfigManager::op_PopStep()
     durations_[stepCount_] = 0;
 }
 
-int16_t ConfigManager::getTemperature(size_t idx)
+centi_t ConfigManager::getTemperature(size_t idx)
 {
-    return (idx < stepCount_) ? temps_[idx] : INT16_MIN;   // -32768 = inválido
+    return (idx < stepCount_) ? temps_[idx] : TEMP_INVALID;
 }
 
 uint32_t ConfigManager::getDuration(size_t idx)
@@ -146,13 +266,23 @@ uint32_t ConfigManager::getDuration(size_t idx)
     return (idx < stepCount_) ? durations_[idx] : 0;
 }
 
+// só a lista de etapas: a estratégia de controle é escolhida à parte
 void ConfigManager::clearSteps() { stepCount_ = 0; }
 
+CtrlMode ConfigManager::getCtrlMode() { return ctrlMode_; }
+
+void ConfigManager::setCtrlMode(CtrlMode mode)
+{
+    ctrlMode_ = (mode <= CTRL_MPC) ? mode : CTRL_PID;
+}
+
 void ConfigManager::printConfig()
 {
-    printf("---- Config atual (%zu etapas) ----\n", stepCount_);
+    static const char* const MODE_NAME[] = { "PID", "APROXIMACAO", "MPC" };
+    printf("---- Config atual (%zu etapas, controle %s) ----\n",
+           stepCount_, MODE_NAME[ctrlMode_]);
     for (size_t i = 0; i < stepCount_; ++i)
-        printf("%2zu) %d °C  %u s\n", i, temps_[i], durations_[i]);
+        printf("%2zu) %.2f °C  %u s\n", i, tempToC(temps_[i]), durations_[i]);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -6,14 +6,27 @@
 #include <cstddef>
 #include "esp_err.h"
 #include "freertos/semphr.h"
+#include "ThermalModel.hpp"
+#include "SensorRegistry.hpp"
+#include "SensorCalibration.hpp"
+#include "Temperature.hpp"
 
 static constexpr size_t MAX_STEPS = 20;
 
+/* Estratégia de controle usada pela receita ------------------------------- */
+enum CtrlMode : uint8_t {
+    CTRL_PID      = 0,    // PID puro
+    CTRL_APPROACH = 1,    // plena potência até o ponto de comutação + PID
+    CTRL_MPC      = 2,    // controle preditivo sobre o perfil da receita (MpcController)
+};
+
 /* Estrutura gravada na NVS ------------------------------------------------- */
 struct BrewConfig {
     uint8_t  step_count;                         // etapas válidas
-    int16_t  temperatures[MAX_STEPS];            // °C (ou °C × 10 se preferir)
+    centi_t  temperatures[MAX_STEPS];            // centésimos de °C (ver temp_scale)
     uint32_t durations    [MAX_STEPS];           // segundos
+    uint8_t  ctrl_mode;                          // CtrlMode (blobs antigos: 0 = PID)
+    uint8_t  temp_scale;                         // TEMP_SCALE; blobs antigos: 0 = °C inteiros
 };
 
 /* Classe que gerencia RAM + NVS ------------------------------------------- */
@@ -29,18 +42,35 @@ public:
 
     /* ---------- Array em RAM ---------- */
     static size_t   getStepCount();
-    static void      op_PushStep(int16_t temp, uint32_t dur);
+    static void      op_PushStep(centi_t temp, uint32_t dur);
     static void      op_PopStep();
-    static int16_t  getTemperature(size_t idx);
+    static centi_t  getTemperature(size_t idx);     // TEMP_INVALID fora da curva
     static uint32_t getDuration   (size_t idx);
-    static void     clearSteps();
+    static void     clearSteps();            // mantém a estratégia de controle
     static void     printConfig();               // opcional: via UART/log
 
+    /* ---------- Estratégia de controle ---------- */
+    static CtrlMode getCtrlMode();
+    static void     setCtrlMode(CtrlMode mode);
+
+    /* ---------- Modelo térmico identificado (chave "model") ---------- */
+    static esp_err_t saveModel(const ThermalModel& m);
+    static esp_err_t loadModel(ThermalModel& m);   // ESP_ERR_NVS_NOT_FOUND se não houver
+
+    /* ---------- Papéis das sondas por endereço (chave "sensors") ---------- */
+    static esp_err_t saveSensorRoles(const SensorRoleEntry* e, size_t n);
+    static esp_err_t loadSensorRoles(SensorRoleEntry* e, size_t& n);   // n: capacidade → lidas
+
+    /* ---------- Calibração das sondas por endereço (chave "calib") ---------- */
+    static esp_err_t saveSensorCal(const SensorCalEntry* e, size_t n);
+    static esp_err_t loadSensorCal(SensorCalEntry* e, size_t& n);       // n: capacidade → lidas
+
 private:
     static SemaphoreHandle_t mutex_;
-    static int16_t  temps_[MAX_STEPS];
+    static centi_t  temps_[MAX_STEPS];
     static uint32_t durations_[MAX_STEPS];
     static size_t   stepCount_;
+    static CtrlMode ctrlMode_;
     static const BrewConfig FACTORY_DEFAULT;
 };
 
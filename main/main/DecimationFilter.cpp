@@ -0,0 +1,51 @@
+#include "DecimationFilter.hpp"
+
+void DecimationFilter::configure(const Params& p)
+{
+    p_ = p;
+    if (p_.order < 1)         p_.order = 1;
+    if (p_.order > MAX_ORDER) p_.order = MAX_ORDER;
+    if (p_.ratio < 1)         p_.ratio = 1;
+    if (p_.ratio > MAX_RATIO) p_.ratio = MAX_RATIO;
+    if (p_.iirShift > 8)      p_.iirShift = 8;
+    gain_ = 1;
+    for (uint8_t i = 0; i < p_.order; ++i) gain_ *= p_.ratio;
+    phase_ = 0;
+    reset();
+}
+
+void DecimationFilter::reset()
+{
+    for (uint8_t i = 0; i < MAX_ORDER; ++i) integ_[i] = comb_[i] = 0;
+    primed_ = false;
+    iirOn_  = false;
+    out_    = TEMP_INVALID;
+}
+
+/* histórico constante em x: order blocos inteiros pelos integradores
+ * e pelos pentes, mais as phase_ leituras já contadas no bloco atual */
+void DecimationFilter::fill(centi_t x)
+{
+    primed_ = true;
+    const uint32_t v0 = static_cast<uint32_t>(static_cast<int32_t>(x));
+    for (uint16_t k = 0; k < p_.order * p_.ratio + phase_; ++k) {
+        uint32_t v = v0;
+        for (uint8_t i = 0; i < p_.order; ++i) v = (integ_[i] += v);
+        if ((k + 1) % p_.ratio == 0)
+            for (uint8_t i = 0; i < p_.order; ++i) { uint32_t d = v - comb_[i]; comb_[i] = v; v = d; }
+    }
+}
+
+void DecimationFilter::decimate()
+{
+    uint32_t v = integ_[p_.order - 1];
+    for (uint8_t i = 0; i < p_.order; ++i) { uint32_t d = v - comb_[i]; comb_[i] = v; v = d; }
+
+    const int32_t sum = static_cast<int32_t>(v);          // ratio^order · média
+    const int32_t avg = (sum >= 0 ? sum + gain_ / 2 : sum - gain_ / 2) / gain_;
+
+    if (p_.iirShift == 0) { out_ = static_cast<centi_t>(avg); return; }
+    if (!iirOn_) { iir_ = avg * 256; iirOn_ = true; }
+    else           iir_ += (avg * 256 - iir_) >> p_.iirShift;
+    out_ = static_cast<centi_t>((iir_ + 128) >> 8);
+}
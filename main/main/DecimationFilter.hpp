@@ -0,0 +1,81 @@
+/*  DecimationFilter.hpp
+ *  -------------------------------------------------------------
+ *  Filtro decimador inteiro da aquisição sobreamostrada das sondas:
+ *  `ratio` leituras entram (10–50 Hz), uma sai na taxa do controle
+ *  (1 Hz), com o ruído de uma leitura isolada diluído no bloco.
+ *
+ *   CIC de ordem 1 ou 2 — ordem 1 é a média móvel em blocos; ordem
+ *   2 é a média de duas médias (janela triangular de 2·ratio − 1
+ *   leituras, rejeição maior fora da banda, o dobro de atraso).
+ *   Por leitura: `order` somas nos integradores. Por saída: `order`
+ *   subtrações nos pentes e uma divisão pelo ganho ratio^order,
+ *   arredondada;
+ *   IIR de 1ª ordem opcional na taxa de saída, y += (x − y)/2^iirShift,
+ *   com 8 bits de fração (iirShift = 0 desliga).
+ *
+ *  Tudo em inteiros de 32 bits. Os integradores podem dar a volta
+ *  (aritmética modular, desfeita pelos pentes) desde que
+ *  ratio^order · 32768 caiba em 31 bits: ratio até MAX_RATIO.
+ *
+ *  Atraso de grupo: order·(ratio − 1)/2 leituras (média a 20 Hz:
+ *  ~0,5 s). Após reset() a primeira leitura preenche o histórico,
+ *  como se a sonda estivesse parada nela (sem transiente de partida).
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "Temperature.hpp"
+
+class DecimationFilter {
+public:
+    static constexpr uint8_t  MAX_ORDER = 2;
+    static constexpr uint16_t MAX_RATIO = 128;   // 128² · 32768 < 2^31
+
+    struct Params {
+        uint8_t  order    = 1;      // 1 = média móvel, 2 = CIC de 2ª ordem
+        uint16_t ratio    = 20;     // leituras por saída
+        uint8_t  iirShift = 0;      // IIR na saída, constante 2^iirShift saídas (0 = sem)
+    };
+
+    DecimationFilter() { configure(Params{}); }
+    explicit DecimationFilter(const Params& p) { configure(p); }
+
+    /** Troca os parâmetros (limitados) e zera o filtro e a fase. */
+    void configure(const Params& p);
+    /** Esquece o histórico; a fase do bloco é mantida (saída alinhada
+     *  com a das outras sondas). */
+    void reset();
+
+    /** Uma leitura (centésimos). @return true quando sai um valor novo,
+     *  a cada `ratio` leituras. */
+    bool push(centi_t x)
+    {
+        if (!primed_) fill(x);
+        uint32_t v = static_cast<uint32_t>(static_cast<int32_t>(x));
+        for (uint8_t i = 0; i < p_.order; ++i) v = (integ_[i] += v);
+        if (++phase_ < p_.ratio) return false;
+        phase_ = 0;
+        decimate();
+        return true;
+    }
+
+    /** Último valor decimado (TEMP_INVALID antes do primeiro). */
+    centi_t output() const { return out_; }
+    const Params& params() const { return p_; }
+
+private:
+    void fill(centi_t x);
+    void decimate();
+
+    Params   p_{};
+    uint32_t integ_[MAX_ORDER] = {};
+    uint32_t comb_[MAX_ORDER]  = {};
+    uint16_t phase_  = 0;
+    int32_t  gain_   = 1;                // ratio^order
+    int32_t  iir_    = 0;                // centésimos, 8 bits de fração
+    bool     primed_ = false;
+    bool     iirOn_  = false;
+    centi_t  out_    = TEMP_INVALID;
+};
@@ -0,0 +1,34 @@
+#include "EnergyMeter.hpp"
+
+/* ---------- acumulação (PidTask) ---------- */
+void EnergyMeter::tick(int step, uint32_t duty, bool mixing)
+{
+    if (startReq_) { clear(); running_ = true; startReq_ = false; }
+    if (stopReq_)  { running_ = false; stopReq_ = false; }
+    if (!running_) return;
+
+    Account* acc[2] = { &total_, nullptr };
+    if (step >= 0 && step < MAX_STEPS) {
+        acc[1] = &step_[step];
+        if (step >= steps_) steps_ = step + 1;
+    }
+    for (Account* a : acc) {
+        if (!a) continue;
+        a->ticks    += 1;
+        a->heatDuty += duty;
+        if (mixing) a->mixTicks  += 1;
+    }
+}
+
+void EnergyMeter::clear()
+{
+    for (Account& a : step_) a = Account{};
+    total_ = Account{};
+    steps_ = 0;
+}
+
+/* ---------- conversão para o relatório ---------- */
+float EnergyMeter::heaterFullSec(const Account& a) const
+{
+    return static_cast<float>(static_cast<double>(a.heatDuty) / maxDuty_ * tick_);
+}
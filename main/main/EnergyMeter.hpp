@@ -0,0 +1,81 @@
+/*  EnergyMeter.hpp
+ *  -------------------------------------------------------------
+ *  Contabilidade de aquecimento e mistura (RF-10).
+ *
+ *  A cada tick do laço de controle integra o duty do aquecedor e o
+ *  estado do misturador, por etapa da curva e no total da
+ *  brassagem. Os acumuladores são contadores inteiros de ticks
+ *  (O(1) por tick, sem perda de precisão em brassagens longas);
+ *  a conversão para segundos e Wh só é feita no relatório:
+ *
+ *    aquecimento equivalente (s) = Σ duty / maxDuty · tick
+ *    energia (Wh)                = equivalente · potência / 3600
+ *
+ *  Não há "tempo ligado": com PWM ou burst-fire o duty quase nunca é
+ *  zero no patamar, e só o equivalente a plena potência diz quanto
+ *  aquecimento foi necessário.
+ *
+ *  startBrew()/stopBrew() apenas registram o pedido; quem chama
+ *  tick() (PidTask) o aplica no início do próximo tick, de modo
+ *  que os contadores só são escritos por uma task.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+
+class EnergyMeter {
+public:
+    static constexpr int MAX_STEPS = 20;          // = MAX_STEPS do ConfigManager
+
+    struct Account {
+        uint32_t ticks     = 0;   // duração
+        uint64_t heatDuty  = 0;   // Σ duty (contagens do PWM)
+        uint32_t mixTicks  = 0;   // ticks com o misturador ligado
+    };
+
+    EnergyMeter() = default;
+    EnergyMeter(float tickSec, uint32_t maxDuty) { configure(tickSec, maxDuty); }
+
+    void configure(float tickSec, uint32_t maxDuty) { tick_ = tickSec; maxDuty_ = maxDuty; }
+    /** Potência nominal do aquecedor (W); 0 = não informada (sem Wh). */
+    void  setHeaterWatts(float w) { watts_ = w; }
+    float heaterWatts() const     { return watts_; }
+
+    void startBrew() { startReq_ = true; }
+    void stopBrew()  { stopReq_  = true; }
+    /** true depois que o último stopBrew() foi aplicado. */
+    bool stopped() const { return !running_ && !stopReq_; }
+
+    /** Um tick do laço de controle.
+     *  @param step    etapa atual da curva (fora de 0..MAX_STEPS-1 só
+     *                 entra no total)
+     *  @param duty    duty aplicado ao aquecedor (0..maxDuty)
+     *  @param mixing  misturador ligado                                */
+    void tick(int step, uint32_t duty, bool mixing);
+
+    int            steps() const        { return steps_; }   // etapas com dados
+    const Account& step(int i) const    { return step_[i]; }
+    const Account& total() const        { return total_; }
+
+    float seconds(uint32_t ticks) const { return ticks * tick_; }
+    /** Segundos equivalentes a plena potência. */
+    float heaterFullSec(const Account& a) const;
+    float heaterWh(const Account& a) const { return heaterFullSec(a) * watts_ / 3600.0f; }
+
+private:
+    void clear();
+
+    float    tick_    = 0.01f;
+    uint32_t maxDuty_ = 1;
+    float    watts_   = 0.0f;
+
+    volatile bool startReq_ = false;
+    volatile bool stopReq_  = false;
+    volatile bool running_  = false;
+
+    Account step_[MAX_STEPS];
+    Account total_;
+    int     steps_ = 0;
+};
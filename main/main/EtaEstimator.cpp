@@ -0,0 +1,96 @@
+#include "EtaEstimator.hpp"
+#include <cmath>
+
+/* ---------- ganho efetivo a plena potência ---------- */
+void EtaEstimator::learn(float pv, float dutyFrac, float dt, const ThermalModel& m)
+{
+    if (gain_ <= 0.0f) gain_ = m.heatGain;
+    if (dutyFrac < p_.fullDuty || dt <= 0.0f) { run_ = false; return; }
+    if (!run_) { run_ = true; runT_ = -m.deadTime; }
+
+    // o trecho só começa depois do tempo morto
+    runT_ += dt;
+    if (runT_ <= 0.0f) { segPv_ = pv; segT_ = segU_ = 0.0f; return; }
+    segT_ += dt;
+    segU_ += dutyFrac * dt;
+    if (pv - segPv_ < p_.minRise) return;
+
+    const float mid = 0.5f * (pv + segPv_);
+    const float g   = ((pv - segPv_) + m.lossCoef * (mid - m.ambient) * segT_) / segU_;
+    gain_ += p_.gainAlpha * (g - gain_);
+    if (gain_ < p_.gainMin * m.heatGain) gain_ = p_.gainMin * m.heatGain;
+    if (gain_ > p_.gainMax * m.heatGain) gain_ = p_.gainMax * m.heatGain;
+    segPv_ = pv;
+    segT_ = segU_ = 0.0f;
+}
+
+/* rampa a plena potência com o ganho efetivo (< 0 se inatingível) */
+float EtaEstimator::ramp(float from, float to, const ThermalModel& m) const
+{
+    ThermalModel e = m;
+    if (gain_ > 0.0f) e.heatGain = gain_;
+    return e.rampTime(from, to);
+}
+
+/* ---------- tempo restante ---------- */
+void EtaEstimator::update(const centi_t temps[], const uint32_t durs[], int count, int cur,
+                          int32_t secLeft, bool holding, float pv, float dt, const ThermalModel& m)
+{
+    total_ = step_ = ramp_ = 0.0f;
+    if (cur < 0 || cur >= count) { stepSeen_ = -1; return; }
+
+    // mede a rampa da etapa: da entrada até o cronômetro andar
+    if (cur != stepSeen_) {
+        const float target = tempToC(temps[cur]) - p_.band;
+        // quanto o pré-aquecimento subiu o fim do patamar anterior
+        if (lift_ > 0.0f && stepSeen_ == cur - 1 && cur > 0 && temps[cur] > temps[cur - 1]) {
+            float seen = pv - tempToC(temps[cur - 1]);
+            seen = (seen < 0.0f) ? 0.0f : (seen > lift_ ? lift_ : seen);
+            liftSeen_ += p_.stretchAlpha * (seen - liftSeen_);
+        }
+        stepSeen_ = cur;
+        rampT_    = 0.0f;
+        rampPred_ = ramp(pv, target, m);
+        rampOpen_ = !holding && target - pv >= p_.minRise && rampPred_ > 0.0f;
+    } else if (rampOpen_) {
+        rampT_ += dt;
+        if (holding) {
+            rampOpen_ = false;
+            stretch_ += p_.stretchAlpha * (rampT_ / rampPred_ - stretch_);
+            if (stretch_ < 1.0f)          stretch_ = 1.0f;
+            if (stretch_ > p_.stretchMax) stretch_ = p_.stretchMax;
+        }
+    }
+
+    // temperatura no fim de um patamar: o PID segura o set-point; acima
+    // dele (etapa mais fria) a tina só esfria pelas perdas
+    auto afterHold = [&m](float t, float sp, float hold) {
+        if (t > sp && m.lossCoef > 0.0f)
+            t = m.ambient + (t - m.ambient) * std::exp(-m.lossCoef * hold);
+        return (t > sp) ? t : sp;
+    };
+
+    float t = pv;
+    for (int i = cur; i < count; ++i) {
+        const float sp   = tempToC(temps[i]);
+        const float hold = (i == cur) ? (secLeft > 0 ? secLeft : 0) : durs[i];
+        // cronômetro parado até a banda (na etapa atual, se não está correndo)
+        if (t < sp - p_.band && !(i == cur && holding)) {
+            float r = ramp(t, sp - p_.band, m);
+            if (r < 0.0f) { total_ = -1.0f; if (i == cur) step_ = -1.0f; return; }
+            r *= stretch_;
+            ramp_  += r;
+            total_ += r;
+        }
+        total_ += hold;
+        if (i == cur) step_ = total_;
+        t = afterHold(t, sp, hold);
+        // pré-aquecimento: o patamar termina acima do set-point, dentro da banda
+        const float lift = (liftSeen_ < lift_) ? liftSeen_ : lift_;
+        if (i + 1 < count && lift > 0.0f) {
+            const float next = tempToC(temps[i + 1]);
+            const float top  = (next < sp + lift) ? next : sp + lift;
+            if (next > sp && t < top) t = top;
+        }
+    }
+}
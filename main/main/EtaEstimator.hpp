@@ -0,0 +1,113 @@
+/*  EtaEstimator.hpp
+ *  -------------------------------------------------------------
+ *  Tempo restante da receita em execução (ETA), recalculado a cada
+ *  segundo pela TempTask:
+ *
+ *      restante = rampa até a banda da etapa atual + secLeft
+ *               + Σ (rampa + patamar) das etapas seguintes
+ *
+ *  O cronômetro do patamar só anda com a temperatura dentro da banda
+ *  (sp − band, temp_right), então cada etapa mais quente custa a
+ *  rampa antes do patamar. A rampa é a solução do ThermalModel a
+ *  plena potência (ThermalModel::rampTime, com perda e tempo morto),
+ *  com o ganho do aquecedor trocado por um ganho efetivo aprendido
+ *  da taxa de aquecimento observada a plena potência:
+ *
+ *      Gef = (ΔT/Δt + k·(T − Ta)) / u
+ *
+ *  Assim a taxa medida em uma temperatura vale também nas outras.
+ *  ΔT/Δt é medida em trechos de minRise °C (num trecho longo o LSB e
+ *  o ruído da leitura pesam pouco na taxa), descartando o tempo morto
+ *  no início de cada período a plena potência.
+ *  O PID reduz a potência antes da banda, então a rampa real é mais
+ *  longa que a de plena potência: a razão real/prevista de cada rampa
+ *  de pelo menos minRise °C é aprendida (média exponencial) e aplicada
+ *  às rampas previstas.
+ *  Etapas mais frias não atrasam o cronômetro (não há temp_wrong
+ *  acima do set-point); o resfriamento natural durante o patamar só
+ *  entra como ponto de partida da rampa seguinte. Com o pré-aquecimento
+ *  (setHoldLift) a rampa para uma etapa mais quente parte acima do
+ *  set-point anterior: quanto acima é aprendido na entrada de cada
+ *  etapa mais quente (média exponencial, limitada a `lift`), já que o
+ *  PID nem sempre alcança o set-point antecipado antes do fim.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+#include "Temperature.hpp"
+
+class EtaEstimator {
+public:
+    struct Params {
+        float band      = 1.0f;    // °C abaixo do set-point com o cronômetro andando
+        float fullDuty  = 0.95f;   // fração de duty considerada "plena"
+        float minRise   = 5.0f;    // °C por trecho medido
+        float gainAlpha = 0.3f;    // peso de cada trecho no ganho efetivo
+        float gainMin   = 0.2f;    // limites do ganho efetivo (× heatGain do modelo)
+        float gainMax   = 5.0f;
+        float stretchAlpha = 0.5f; // peso de cada rampa na razão real/prevista
+        float stretchMax   = 4.0f;
+    };
+
+    EtaEstimator() = default;
+    explicit EtaEstimator(const Params& p) : p_(p) {}
+
+    /** Alimenta o ganho efetivo (chamar a cada nova leitura).
+     *  @param pv        temperatura medida (°C)
+     *  @param dutyFrac  duty aplicado no intervalo (0..1)
+     *  @param dt        intervalo desde a última chamada (s)
+     *  @param m         modelo térmico (perda e ambiente)               */
+    void learn(float pv, float dutyFrac, float dt, const ThermalModel& m);
+
+    /** Recalcula o tempo restante.
+     *  @param temps    set-points das etapas (centésimos de °C)
+     *  @param durs     patamares das etapas (s)
+     *  @param count    número de etapas
+     *  @param cur      etapa em execução (currentCurve)
+     *  @param secLeft  segundos restantes do patamar atual
+     *  @param holding  cronômetro do patamar correndo
+     *  @param pv       temperatura atual (°C)
+     *  @param dt       intervalo desde a última chamada (s)
+     *  @param m        modelo térmico                                   */
+    void update(const centi_t temps[], const uint32_t durs[], int count, int cur,
+                int32_t secLeft, bool holding, float pv, float dt, const ThermalModel& m);
+
+    /** °C acima do set-point no fim de um patamar seguido de etapa mais
+     *  quente (PreheatLookahead::lift(); 0 = sem pré-aquecimento). */
+    void  setHoldLift(float c)  { lift_ = c > 0.0f ? c : 0.0f; }
+
+    /** Segundos até END_PROCESS (< 0 se alguma rampa é inatingível). */
+    float remaining() const     { return total_; }
+    /** Segundos até o fim da etapa atual (< 0 idem). */
+    float stepRemaining() const { return step_; }
+    /** Parte de remaining() gasta em rampas. */
+    float rampRemaining() const { return ramp_; }
+    /** Ganho efetivo do aquecedor (°C/s a 100 %; 0 = ainda o do modelo). */
+    float heatGain() const      { return gain_; }
+    /** Razão aprendida entre a rampa real e a de plena potência. */
+    float rampStretch() const   { return stretch_; }
+
+private:
+    float ramp(float from, float to, const ThermalModel& m) const;
+
+    Params p_{};
+    float  gain_    = 0.0f;
+    bool   run_     = false;     // em um período a plena potência
+    float  runT_    = 0.0f;      // s desde o fim do tempo morto (< 0 antes)
+    float  segPv_   = 0.0f;      // início do trecho atual
+    float  segT_    = 0.0f;
+    float  segU_    = 0.0f;      // ∫ duty dt no trecho
+    float  stretch_ = 1.0f;
+    float  lift_    = 0.0f;      // °C, pré-aquecimento no fim do patamar
+    float  liftSeen_ = 0.0f;     // °C acima do sp no fim dos patamares (aprendido)
+    int    stepSeen_  = -1;      // etapa da rampa acompanhada
+    bool   rampOpen_  = false;   // rampa da etapa ainda sem o cronômetro
+    float  rampPred_  = 0.0f;    // s previstos a plena potência na entrada
+    float  rampT_     = 0.0f;    // s decorridos
+    float  total_   = 0.0f;
+    float  step_    = 0.0f;
+    float  ramp_    = 0.0f;
+};
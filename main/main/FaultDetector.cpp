@@ -0,0 +1,180 @@
+#include "FaultDetector.hpp"
+#include <algorithm>
+#include <cmath>
+
+/* ---------- mediana (reordena v) ---------- */
+float FaultDetector::median(float* v, int n)
+{
+    std::nth_element(v, v + n / 2, v + n);
+    return v[n / 2];
+}
+
+/* ---------- janela pelo modelo ---------- */
+float FaultDetector::measurable() const
+{
+    return std::max(2.0f * p_.resolution, noise_);
+}
+
+int FaultDetector::window(const ThermalModel& m) const
+{
+    int win = p_.window;
+    if (win <= 0) {
+        // meia janela: tempo morto e a variação mensurável com G·heatDutyMin
+        const float heat = m.heatGain * p_.heatDutyMin;
+        float half = m.deadTime;
+        if (heat > 0.0f) half = std::max(half, p_.riseMargin * measurable() / heat);
+        win = std::max(static_cast<int>(std::ceil(2.0f * half / p_.dt)), p_.minWindow);
+    }
+    return std::min(std::max(win, 4), MAX_WIN);
+}
+
+/* ---------- nova amostra ---------- */
+void FaultDetector::update(const float z[NUM_PROBES], const bool ok[NUM_PROBES],
+                           float u, const ThermalModel& m)
+{
+    if (!init_) {
+        for (int p = 0; p < NUM_PROBES; ++p) last_[p] = z[p];
+        init_ = true;
+    }
+
+    // duty que está chegando à sonda agora (tempo morto do modelo)
+    uHead_ = (uHead_ + 1) % MAX_DELAY;
+    uHist_[uHead_] = u;
+    int d = static_cast<int>(std::lround(m.deadTime / p_.dt));
+    d = std::min(std::max(d, 0), MAX_DELAY - 1);
+    const float ud = uHist_[(uHead_ - d + MAX_DELAY) % MAX_DELAY];
+
+    // sondas usadas no teste do aquecedor: as não travadas (todas, se nenhuma sobrou)
+    bool use[NUM_PROBES];
+    bool any = false;
+    for (int p = 0; p < NUM_PROBES; ++p) any |= (use[p] = !stuck(p));
+    if (!any) for (bool& b : use) b = true;
+
+    /* --- leituras paradas --- */
+    const bool heater    = faults_ & FAULT_HEATER;
+    const bool saturated = ud <= p_.satLow || ud >= p_.satHigh;
+    float e[NUM_PROBES];
+    for (int p = 0; p < NUM_PROBES; ++p) {
+        e[p] = m.slope(z[p], ud);
+        if (z[p] != last_[p]) {
+            last_[p]   = z[p];
+            expAcc_[p] = 0;
+            same_[p]   = 0;
+            faults_   &= static_cast<uint8_t>(~FAULT_STUCK(p));
+            continue;
+        }
+        if (same_[p] < MAX_WIN) ++same_[p];
+        if (heater)         expAcc_[p] = 0;
+        else if (saturated) expAcc_[p] += e[p] * p_.dt;
+    }
+
+    /* --- janela de inclinação --- */
+    head_ = (head_ + 1) % MAX_WIN;
+    for (int p = 0; p < NUM_PROBES; ++p) {
+        tHist_[p][head_] = z[p];
+        eHist_[p][head_] = e[p];
+    }
+    dHist_[head_] = ud;
+    if (filled_ < MAX_WIN) ++filled_;
+
+    // ruído: mediana de |T[i] − 2T[i−1] + T[i−2]| = 0,6745·√6·σ; a maior
+    // entre as sondas usadas
+    const int nd = std::min(filled_, NOISE_WIN) - 2;
+    if (nd >= 8) {
+        float sigma = 0;
+        for (int p = 0; p < NUM_PROBES; ++p) {
+            if (!use[p]) continue;
+            const float* t = tHist_[p];
+            for (int i = 0; i < nd; ++i) {
+                const int a = (head_ - i + MAX_WIN) % MAX_WIN;
+                work_[0][i] = std::fabs(t[a] - 2.0f * t[(a - 1 + MAX_WIN) % MAX_WIN] +
+                                        t[(a - 2 + MAX_WIN) % MAX_WIN]);
+            }
+            sigma = std::max(sigma, median(work_[0], nd) / 1.652f);
+        }
+        noise_ = sigma;
+    }
+
+    const int win = window(m);
+    if (count_ < win) ++count_;
+    else              count_ = win;          // janela encolheu com o modelo
+    const int   h       = win / 2;
+    const float span    = h * p_.dt;
+    const float minRise = p_.riseMargin * measurable();           // mensurável na janela
+
+    if (count_ > h) {
+        const int first = head_ - (count_ - 1) + MAX_WIN;     // amostra mais antiga
+        const int k     = count_ - h;                          // pares (i, i+h)
+        auto at = [first](const float* v, int i) { return v[(first + i) % MAX_WIN]; };
+
+        // cada sonda usada precisa confirmar a falha
+        bool cold = true, hot = true;
+        for (int p = 0; p < NUM_PROBES; ++p) {
+            const float* t  = tHist_[p];
+            const float* ep = eHist_[p];
+            float eSum = 0, uSum = 0;
+            for (int j = 0; j < h; ++j) { eSum += at(ep, j); uSum += at(dHist_, j); }
+            int nCold = 0, nHot = 0;
+            for (int i = 0; i < k; ++i) {
+                if (i) {
+                    eSum += at(ep, i + h - 1) - at(ep, i - 1);
+                    uSum += at(dHist_, i + h - 1) - at(dHist_, i - 1);
+                }
+                const float ei = eSum / h, ui = uSum / h;
+                const float oi = (at(t, i + h) - at(t, i)) / span;
+                work_[0][i] = oi;
+                work_[1][i] = ei;
+                // não esquenta: o calor entregue (observada + perda do modelo =
+                // oi − ei + G·ui) é menos de heatFrac do que o aquecedor daria
+                const float heat = m.heatGain * ui;
+                nCold += ui >= p_.heatDutyMin && heat * span >= minRise &&
+                         oi - ei + heat < p_.heatFrac * heat;
+                // esquenta sem potência: sobra sobre o modelo mensurável e grande,
+                // e a sonda de fato subindo (perda do modelo alta demais faz
+                // sobra com a temperatura parada no patamar)
+                const float extra = oi - ei;
+                nHot  += ui <= 1.0f - p_.idleFrac && extra * span >= minRise &&
+                         extra > p_.idleFrac * m.heatGain && oi * span >= minRise;
+            }
+            obs_[p] = median(work_[0], k);
+            exp_[p] = median(work_[1], k);
+            if (!use[p]) continue;
+            cold &= 2 * nCold > k;
+            hot  &= 2 * nHot  > k;
+        }
+        heatCnt_ = (cold || hot) ? heatCnt_ + 1 : 0;
+        if (heatCnt_ >= p_.confirm) faults_ |= FAULT_HEATER;
+    }
+
+    /* --- sonda travada: parada a janela inteira e ---
+     *  (a) o modelo, com o aquecedor saturado, previa stuckRise enquanto
+     *      outra sonda mudava (todas paradas fica para o aquecedor), ou
+     *  (b) outra sonda anda de forma mensurável no sentido do modelo  */
+    for (int p = 0; p < NUM_PROBES && !heater && count_ >= win; ++p) {
+        if (same_[p] < win) continue;
+        bool model = false, other = false;
+        for (int q = 0; q < NUM_PROBES; ++q) {
+            if (q == p || stuck(q)) continue;
+            if (same_[q] < win || !ok[p]) model = true;
+            if (std::fabs(obs_[q]) * span >= minRise && obs_[q] * exp_[q] > 0 &&
+                std::fabs(exp_[q]) * span >= minRise) other = true;
+        }
+        if ((model && std::fabs(expAcc_[p]) >= p_.stuckRise) || other)
+            faults_ |= FAULT_STUCK(p);
+    }
+
+    /* --- divergência entre as sondas --- */
+    if (!stuck(0) && !stuck(1)) {
+        float diff = std::fabs(z[0] - z[1]);
+        if (diff >= p_.divLimit) {
+            if (divCnt_ < p_.divSec) ++divCnt_;
+        } else if (diff < p_.divLimit - p_.resolution) {
+            divCnt_ = 0;
+            faults_ &= static_cast<uint8_t>(~FAULT_DIVERGE);
+        }
+        if (divCnt_ * p_.dt >= p_.divSec) faults_ |= FAULT_DIVERGE;
+    } else {
+        divCnt_ = 0;
+        faults_ &= static_cast<uint8_t>(~FAULT_DIVERGE);
+    }
+}
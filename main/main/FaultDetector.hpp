@@ -0,0 +1,152 @@
+/*  FaultDetector.hpp
+ *  -------------------------------------------------------------
+ *  Detecção de falhas (RF-07) pela taxa de variação: compara a
+ *  inclinação esperada pelo ThermalModel para o duty aplicado com
+ *  uma estimativa robusta da inclinação observada nas sondas.
+ *
+ *  Cada par de amostras (i, i+h) da janela (h = metade da janela)
+ *  dá, por sonda, a inclinação observada (T[i+h] − T[i]) / h e a
+ *  esperada, média de model.slope(T, u(t−θ)) no mesmo intervalo com
+ *  T a leitura da própria sonda (uma sonda solta não desloca a
+ *  expectativa da outra). Cada par vota; a sonda confirma a falha
+ *  com mais da metade dos votos, o que equivale a comparar medianas
+ *  e não deixa um pico isolado ou a troca de rampa para patamar no
+ *  meio da janela decidir.
+ *
+ *  Falhas:
+ *    FAULT_HEATER    com duty alto, o calor entregue a todas as sondas
+ *                    (inclinação observada + perda do modelo) é menos de
+ *                    heatFrac de G·u (resistência aberta, SSR ou fiação);
+ *                    ou todas sobem, de forma mensurável, mais que
+ *                    idleFrac·G acima do esperado (SSR em curto). Comparar
+ *                    com G·u, e não com a inclinação esperada, e exigir a
+ *                    subida tolera erro na perda do modelo nos patamares.
+ *                    Fica retida até clear().
+ *    FAULT_STUCK(p)  a leitura da sonda p não mudou nem um LSB na
+ *                    janela inteira enquanto o modelo, com o aquecedor
+ *                    saturado, previa variação de stuckRise, ou enquanto
+ *                    outra sonda andava de forma mensurável no sentido
+ *                    previsto pelo modelo. Uma leitura que falha mantém
+ *                    o último valor e cai no mesmo caso.
+ *                    Sai sozinha quando a leitura volta a variar; não é
+ *                    avaliada com FAULT_HEATER (o modelo não vale mais).
+ *    FAULT_DIVERGE   |s1 − s2| acima de divLimit por divSec segundos.
+ *
+ *  Latência, contada de quando a falha contradiz o processo: aquecedor
+ *  e sonda travada em até tempo morto + janela + confirm amostras;
+ *  divergência em divSec mais uma amostra e o atraso do filtro. SSR em
+ *  curto só aparece quando o controle pede menos de 1 − idleFrac
+ *  (numa rampa a plena potência é o que já se pedia) e sonda travada
+ *  só na rampa seguinte: no patamar a deriva da malha fechada não
+ *  segue o modelo e a leitura parada não é contrariada.
+ *
+ *  Com as duas sondas paradas e lidas sem erro não há como separar
+ *  "sondas congeladas" de "resistência aberta em equilíbrio"; o caso
+ *  é tratado como falha do aquecedor, que é o que desliga a saída.
+ *
+ *  A janela sai do modelo e das leituras (window = 0): a meia janela
+ *  cobre o tempo morto e o tempo para o aquecedor no duty mínimo
+ *  julgado (G·heatDutyMin) mover a sonda riseMargin vezes a variação
+ *  mensurável, com no mínimo minWindow amostras: 20 s na planta do
+ *  simulador slave, ~50 s na tina. Variação mensurável = o maior entre
+ *  2 LSB (o I2CTask informa o LSB das sondas em setResolution a cada
+ *  configuração da aquisição) e o ruído das leituras, estimado aqui
+ *  pela mediana de |2ª diferença| das últimas NOISE_WIN amostras (tira
+ *  rampa e patamar; a troca de um para o outro pesa poucas amostras).
+ *  Sem filtro decimador (1 leitura/s) o ruído da sonda chega inteiro
+ *  e a janela cresce até MAX_WIN.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+
+class FaultDetector {
+public:
+    static constexpr int NUM_PROBES = 2;
+    static constexpr int MAX_WIN    = 256;        // amostras na janela de inclinação
+    static constexpr int MAX_DELAY  = 64;         // amostras de tempo morto no duty
+    static constexpr int NOISE_WIN  = 64;         // amostras na estimativa de ruído
+
+    enum : uint8_t {
+        FAULT_HEATER  = 0x01,
+        FAULT_STUCK1  = 0x02,
+        FAULT_STUCK2  = 0x04,
+        FAULT_DIVERGE = 0x08,
+    };
+    static constexpr uint8_t FAULT_STUCK(int p) { return static_cast<uint8_t>(FAULT_STUCK1 << p); }
+
+    struct Params {
+        float dt          = 1.0f;     // s, período de amostragem
+        int   window      = 0;        // amostras (≤ MAX_WIN); 0 = pelo modelo
+        int   minWindow   = 20;       // amostras, piso da janela pelo modelo
+        float riseMargin  = 4.0f;     // × variação mensurável na meia janela
+        float resolution  = 0.01f;    // °C, LSB das leituras (setResolution)
+        float heatDutyMin = 0.5f;     // duty médio p/ julgar falta de aquecimento
+        float heatFrac    = 0.3f;     // calor entregue < heatFrac · G·u
+        float idleFrac    = 0.5f;     // sobra > idleFrac · heatGain → SSR em curto
+        int   confirm     = 3;        // amostras seguidas p/ confirmar
+        float satLow      = 0.02f;    // duty "desligado" p/ acumular variação esperada
+        float satHigh     = 0.9f;     // duty "plena potência"
+        float stuckRise   = 3.0f;     // °C sem mudar a leitura → travada
+        float divLimit    = 6.0f;     // °C entre as sondas
+        int   divSec      = 10;       // s acima de divLimit
+    };
+
+    FaultDetector() = default;
+    explicit FaultDetector(const Params& p) : p_(p) {}
+
+    /** Nova amostra (a cada p.dt).
+     *  @param z    leituras das sondas (°C; a última boa se a leitura falhou)
+     *  @param ok   leitura da sonda bem-sucedida nesta amostra
+     *  @param u    duty médio (0..1) desde a amostra anterior
+     *  @param m    modelo térmico (inclinação esperada)                 */
+    void update(const float z[NUM_PROBES], const bool ok[NUM_PROBES],
+                float u, const ThermalModel& m);
+
+    /** LSB das leituras (°C); nunca menor que o centésimo de centi_t. */
+    void    setResolution(float lsbC) { p_.resolution = lsbC > 0.01f ? lsbC : 0.01f; }
+    float   resolution() const      { return p_.resolution; }
+    /** Amostras da janela para o modelo m (Params::window se > 0). */
+    int     window(const ThermalModel& m) const;
+    /** °C: max(2 LSB, ruído estimado das leituras). */
+    float   measurable() const;
+    float   noise() const           { return noise_; }     // °C (desvio-padrão)
+
+    uint8_t faults() const          { return faults_; }
+    bool    stuck(int p) const      { return faults_ & FAULT_STUCK(p); }
+    /** Libera FAULT_HEATER (as demais acompanham as leituras). */
+    void    clear()                 { faults_ &= static_cast<uint8_t>(~FAULT_HEATER); heatCnt_ = 0; }
+
+    float observedSlope(int p) const { return obs_[p]; }   // °C/s, última janela
+    float expectedSlope(int p) const { return exp_[p]; }   // °C/s, última janela
+
+private:
+    static float median(float* v, int n);
+
+    Params p_{};
+
+    float tHist_[NUM_PROBES][MAX_WIN] = {};   // leituras (circular)
+    float eHist_[NUM_PROBES][MAX_WIN] = {};   // inclinação esperada por amostra
+    float dHist_[MAX_WIN]   = {};     // duty atrasado de θ por amostra
+    float uHist_[MAX_DELAY] = {};     // duty (p/ o tempo morto)
+    float work_[2][MAX_WIN];          // rascunho das medianas (fora da pilha)
+    int   head_  = 0;
+    int   uHead_ = 0;
+    int   count_ = 0;
+    int   filled_ = 0;                // amostras no histórico (até MAX_WIN)
+    float noise_  = 0;                // °C, ruído das leituras
+
+    float last_[NUM_PROBES]   = {};   // última leitura de cada sonda
+    float expAcc_[NUM_PROBES] = {};   // variação esperada desde a última mudança
+    int   same_[NUM_PROBES]   = {};   // amostras sem mudar a leitura
+    bool  init_ = false;
+
+    int     heatCnt_ = 0;
+    int     divCnt_  = 0;
+    uint8_t faults_  = 0;
+    float   obs_[NUM_PROBES] = {};
+    float   exp_[NUM_PROBES] = {};
+};
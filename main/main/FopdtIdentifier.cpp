@@ -0,0 +1,100 @@
+#include "FopdtIdentifier.hpp"
+#include <cmath>
+
+void FopdtIdentifier::reset(float t)
+{
+    // filtros em repouso: T constante e aquecedor desligado até aqui
+    t1_ = t2_ = t;
+    u1_ = u2_ = 0.0f;
+    for (float& h : uHist_) h = 0.0f;
+    head_ = 0;
+    for (int i = 0; i < NUM_DELAYS; ++i) {
+        for (int r = 0; r < 3; ++r) {
+            th_[i][r] = 0.0f;
+            for (int c = 0; c < 3; ++c) P_[i][r][c] = (r == c) ? p_.pInit : 0.0f;
+        }
+        err_[i] = 0.0f;
+    }
+    best_ = 0;
+    excited_ = 0;
+    init_ = true;
+}
+
+/* ---------- RLS de um candidato ---------- */
+void FopdtIdentifier::rls(int i, const float phi[3], float y)
+{
+    float (*P)[3] = P_[i];
+    float* th = th_[i];
+
+    float e = y - (th[0] * phi[0] + th[1] * phi[1] + th[2] * phi[2]);   // erro a priori
+    err_[i] = p_.errForget * err_[i] + (1.0f - p_.errForget) * e * e;
+
+    float Pphi[3];
+    for (int r = 0; r < 3; ++r)
+        Pphi[r] = P[r][0] * phi[0] + P[r][1] * phi[1] + P[r][2] * phi[2];
+    float trace = P[0][0] + P[1][1] + P[2][2];
+    float lam   = (trace < p_.pMaxTrace) ? p_.forget : 1.0f;
+    float den   = lam + phi[0] * Pphi[0] + phi[1] * Pphi[1] + phi[2] * Pphi[2];
+
+    for (int r = 0; r < 3; ++r) th[r] += Pphi[r] * e / den;
+    for (int r = 0; r < 3; ++r)
+        for (int c = r; c < 3; ++c) {
+            float v = (P[r][c] - Pphi[r] * Pphi[c] / den) / lam;
+            P[r][c] = P[c][r] = v;                 // mantém P simétrica
+        }
+}
+
+/* ---------- nova amostra ---------- */
+void FopdtIdentifier::update(float t, float u)
+{
+    if (!init_) reset(t);
+
+    // filtro de variáveis de estado: x' = (in − x)/τf, duas vezes
+    const float a = 1.0f - std::exp(-p_.dt / p_.filterTau);
+    t1_ += a * (t - t1_);
+    t2_ += a * (t1_ - t2_);
+    u1_ += a * (u - u1_);
+    u2_ += a * (u1_ - u2_);
+
+    head_ = (head_ + 1) % MAX_HIST;
+    uHist_[head_] = u2_;
+
+    const float y = (t1_ - t2_) / p_.filterTau;          // d/dt de T filtrada
+    const float x = -(t2_ - p_.tRef);
+
+    for (int i = 0; i < NUM_DELAYS; ++i) {
+        int d = i * p_.delayStep;
+        const float phi[3] = { uHist_[(head_ - d + MAX_HIST) % MAX_HIST], x, 1.0f };
+        rls(i, phi, y);
+    }
+    if (std::fabs(y) >= p_.minExcite) ++excited_;
+
+    int best = 0;
+    for (int i = 1; i < NUM_DELAYS; ++i)
+        if (err_[i] < err_[best]) best = i;
+    best_ = best;
+}
+
+/* ---------- resultado ---------- */
+float FopdtIdentifier::ambient() const
+{
+    float k = lossCoef();
+    return (k > 0.0f) ? p_.tRef + th_[best_][2] / k : p_.tRef;
+}
+
+bool FopdtIdentifier::valid() const
+{
+    if (!init_ || excited_ < p_.minSamples) return false;
+    float g = heatGain(), k = lossCoef(), ta = ambient();
+    return g > 0.0f && k > 1e-6f && k < 1.0f && ta > -10.0f && ta < 50.0f;
+}
+
+ThermalModel FopdtIdentifier::model() const
+{
+    ThermalModel m;
+    m.heatGain = heatGain();
+    m.lossCoef = lossCoef();
+    m.ambient  = ambient();
+    m.deadTime = deadTime();
+    return m;
+}
@@ -0,0 +1,91 @@
+/*  FopdtIdentifier.hpp
+ *  -------------------------------------------------------------
+ *  Identificação online do modelo de primeira ordem com tempo
+ *  morto (FOPDT) da tina a partir do duty do aquecedor e da sonda,
+ *  durante a brassagem normal:
+ *
+ *      dT/dt = G·u(t−θ) − k·(T − Tref) + c        Ta = Tref + c/k
+ *
+ *  A derivada não é calculada por diferenças (a leitura vem
+ *  quantizada no LSB da sonda e com ruído, que a diferença de um
+ *  segundo amplifica): T e u passam por um filtro de variáveis de
+ *  estado 1/(τf·s + 1)², que fornece a derivada filtrada de T sem
+ *  o ruído de quantização; a mesma filtragem em u e T mantém a
+ *  relação linear acima. [G, k, c] são estimados por mínimos
+ *  quadrados recursivos (RLS) com esquecimento limitado pelo traço
+ *  de P (sem *windup* nos patamares, onde não há excitação).
+ *
+ *  Tempo morto: um RLS por candidato θ = 0, Δθ, 2Δθ, ... usando o u
+ *  filtrado atrasado (filtro e atraso comutam, então basta um
+ *  histórico). Vence o candidato com menor erro de predição médio.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+
+class FopdtIdentifier {
+public:
+    static constexpr int NUM_DELAYS = 31;         // candidatos de tempo morto
+    static constexpr int MAX_HIST   = 64;         // amostras de u filtrado guardadas
+                                                  // (≥ (NUM_DELAYS−1)·delayStep + 1)
+
+    struct Params {
+        float    dt         = 1.0f;     // s, período de amostragem
+        int      delayStep  = 2;        // amostras entre candidatos (0..60 s)
+        float    filterTau  = 20.0f;    // s, filtro de variáveis de estado
+        float    tRef       = 50.0f;    // °C, centro da regressão
+        float    forget     = 0.9999f;  // esquecimento do RLS
+        float    pInit      = 100.0f;   // P inicial (diagonal)
+        float    pMaxTrace  = 300.0f;   // sem esquecimento acima deste traço
+        float    errForget  = 0.995f;   // média do erro de predição
+        uint32_t minSamples = 600;      // amostras com excitação antes de validar
+        float    minExcite  = 0.002f;   // °C/s de |dT/dt filtrada| p/ contar excitação
+    };
+
+    FopdtIdentifier() = default;
+    explicit FopdtIdentifier(const Params& p) : p_(p) {}
+
+    /** Reinicia filtros e estimativas supondo a tina parada em `t`
+     *  com o aquecedor desligado (partida do sistema).               */
+    void reset(float t);
+
+    /** Nova amostra (a cada p.dt): temperatura da sonda e duty médio
+     *  (0..1) aplicado desde a amostra anterior.                       */
+    void update(float t, float u);
+
+    /** Estimativa plausível (G, k > 0, Ta razoável) com excitação suficiente. */
+    bool valid() const;
+
+    int   bestDelay() const        { return best_; }
+    float deadTime() const         { return best_ * p_.delayStep * p_.dt; }
+    float heatGain() const         { return th_[best_][0]; }          // G, °C/s a 100 %
+    float lossCoef() const         { return th_[best_][1]; }          // k, 1/s
+    float ambient() const;
+    float timeConstant() const     { return lossCoef() > 0 ? 1.0f / lossCoef() : 0.0f; }
+    float staticGain() const       { return lossCoef() > 0 ? heatGain() / lossCoef() : 0.0f; }  // °C por duty
+    float predError(int i) const   { return err_[i]; }
+    uint32_t samples() const       { return excited_; }
+
+    /** Modelo identificado (parâmetros na forma do ThermalModel). */
+    ThermalModel model() const;
+
+private:
+    void rls(int i, const float phi[3], float y);
+
+    Params p_{};
+
+    // filtro de variáveis de estado (2ª ordem) em T e u
+    float t1_ = 0, t2_ = 0, u1_ = 0, u2_ = 0;
+    float uHist_[MAX_HIST] = {};      // u filtrado (circular)
+    int   head_  = 0;
+
+    float th_[NUM_DELAYS][3] = {};
+    float P_[NUM_DELAYS][3][3] = {};
+    float err_[NUM_DELAYS] = {};
+    int   best_    = 0;
+    uint32_t excited_ = 0;
+    bool  init_ = false;
+};
@@ -11,3 +11,14 @@ void GPIO_Module::writePin(sc::integer pin, sc::integer value)
 {
     digitalWrite(static_cast<uint8_t>(pin), value ? HIGH : LOW);
 }
+
+void GPIO_Module::initPwm(sc::integer pin, uint32_t freq, uint8_t bits)
+{
+    ledcAttach(static_cast<uint8_t>(pin), freq, bits);
+    ledcWrite(static_cast<uint8_t>(pin), 0);          // inicia desligado
+}
+
+void GPIO_Module::writePwm(sc::integer pin, uint32_t duty)
+{
+    ledcWrite(static_cast<uint8_t>(pin), duty);
+}
@@ -6,5 +6,7 @@ class GPIO_Module {
 public:
     static void initPin(sc::integer pin);               // configura como saída
     static void writePin(sc::integer pin, sc::integer value); // nível 0/1
+    static void initPwm(sc::integer pin, uint32_t freq, uint8_t bits); // saída PWM (LEDC)
+    static void writePwm(sc::integer pin, uint32_t duty);
 };
 
@@ -0,0 +1,133 @@
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "HeaterOutput.hpp"
+
+/* ---------- estado interno ---------- */
+static uint8_t  s_pin      = 0;
+static uint32_t s_freq     = 1000;
+static uint8_t  s_resBits  = 10;
+static uint16_t s_maxDuty  = 1023;
+static int8_t   s_zcPin    = -1;
+static volatile HeaterOutput::Backend s_backend = HeaterOutput::HEATER_LEDC;
+static volatile HeaterOutput::Backend s_requested = HeaterOutput::HEATER_LEDC;
+
+static BurstFireModulator   s_mod(HeaterOutput::BURST_BLOCK);
+static volatile uint16_t    s_duty        = 0;
+static volatile bool        s_inhibit     = false;   // corte de segurança
+static volatile bool        s_started     = false;
+static volatile uint32_t    s_lastZcMs    = 0;
+static uint32_t             s_zcTimeouts  = 0;
+static esp_timer_handle_t   s_timer       = nullptr;
+
+/* ---------- um semiciclo: decide e aplica ---------- */
+static void IRAM_ATTR onHalfCycle()
+{
+    if (s_backend != HeaterOutput::HEATER_BURST) return;
+    digitalWrite(s_pin, (!s_inhibit && s_mod.step(s_duty, s_maxDuty)) ? HIGH : LOW);
+}
+
+static void IRAM_ATTR onZeroCross()
+{
+    s_lastZcMs = millis();
+    onHalfCycle();
+}
+
+static void onTimer(void*) { onHalfCycle(); }
+
+/* ---------- API ---------- */
+bool HeaterOutput::begin(uint8_t pin, uint32_t pwmFreq, uint8_t resBits,
+                         int8_t zeroCrossPin)
+{
+    s_pin     = pin;
+    s_freq    = pwmFreq;
+    s_resBits = resBits;
+    s_maxDuty = (1u << resBits) - 1;
+    s_zcPin   = zeroCrossPin;
+    s_backend = s_requested = HEATER_LEDC;
+
+    if (s_zcPin >= 0) {
+        pinMode(s_zcPin, INPUT);
+        attachInterrupt(digitalPinToInterrupt(s_zcPin), onZeroCross, RISING);
+    } else {
+        const esp_timer_create_args_t args = {
+            .callback = onTimer, .arg = nullptr,
+            .dispatch_method = ESP_TIMER_TASK, .name = "half_cycle",
+            .skip_unhandled_events = true,
+        };
+        esp_timer_create(&args, &s_timer);
+    }
+
+    bool ok   = ledcAttach(s_pin, s_freq, s_resBits);
+    s_started = true;
+    return ok;
+}
+
+/* troca efetiva, sempre no contexto de write() (PidTask) */
+static void applyBackend(HeaterOutput::Backend b)
+{
+    using HO = HeaterOutput;
+    s_duty = 0;
+
+    if (b == HO::HEATER_BURST) {
+        ledcWrite(s_pin, 0);
+        ledcDetach(s_pin);
+        pinMode(s_pin, OUTPUT);
+        digitalWrite(s_pin, LOW);
+        s_mod.reset();
+        s_lastZcMs = millis();
+        s_backend  = HO::HEATER_BURST;
+        if (s_timer) esp_timer_start_periodic(s_timer, HO::HALF_CYCLE_US);
+    } else {
+        s_backend = HO::HEATER_LEDC;
+        if (s_timer) esp_timer_stop(s_timer);
+        digitalWrite(s_pin, LOW);
+        ledcAttach(s_pin, s_freq, s_resBits);
+        ledcWrite(s_pin, 0);
+    }
+}
+
+void HeaterOutput::setBackend(Backend b) { s_requested = b; }
+
+HeaterOutput::Backend HeaterOutput::backend() { return s_backend; }
+
+/* saída em zero já, no backend ativo */
+static void forceOff()
+{
+    s_duty = 0;
+    if (s_backend == HeaterOutput::HEATER_LEDC) ledcWrite(s_pin, 0);
+    else                                        digitalWrite(s_pin, LOW);
+}
+
+void HeaterOutput::inhibit(bool on)
+{
+    s_inhibit = on;
+    if (on && s_started) forceOff();
+}
+
+bool HeaterOutput::inhibited() { return s_inhibit; }
+
+void HeaterOutput::write(uint16_t duty)
+{
+    if (s_requested != s_backend) applyBackend(s_requested);
+    if (s_inhibit) duty = 0;
+
+    if (s_backend == HEATER_LEDC) {
+        ledcWrite(s_pin, duty);
+        // corte entre o teste acima e o ledcWrite: não deixa o duty antigo
+        if (s_inhibit && duty) ledcWrite(s_pin, 0);
+        return;
+    }
+
+    s_duty = duty;
+    if (s_inhibit) s_duty = 0;
+    // detector de zero mudo: não deixa o SSR preso no último estado
+    if (s_zcPin >= 0 && millis() - s_lastZcMs > ZC_TIMEOUT_MS) {
+        digitalWrite(s_pin, LOW);
+        ++s_zcTimeouts;
+        s_lastZcMs = millis();          // conta uma vez por janela
+    }
+}
+
+uint32_t HeaterOutput::switches()          { return s_mod.switches(); }
+uint32_t HeaterOutput::halfCycles()        { return s_mod.halfCycles(); }
+uint32_t HeaterOutput::zeroCrossTimeouts() { return s_zcTimeouts; }
@@ -0,0 +1,54 @@
+/*  HeaterOutput.hpp
+ *  -------------------------------------------------------------
+ *  Saída do aquecedor com duas implementações selecionáveis:
+ *
+ *   HEATER_LEDC   PWM do LEDC (1 kHz), comportamento original;
+ *                 adequado ao simulador escravo / drivers DC.
+ *   HEATER_BURST  semiciclos inteiros de rede via
+ *                 BurstFireModulator, para SSR de rede. O passo do
+ *                 modulador é dado pela interrupção do detector de
+ *                 passagem por zero (se houver) ou por um esp_timer
+ *                 no período de semiciclo, suficiente para SSR com
+ *                 disparo em zero.
+ *
+ *  Com detector de zero, se os pulsos somem por mais de
+ *  ZC_TIMEOUT_MS a saída é desligada (falta de rede ou fio solto).
+ *
+ *  inhibit() é o corte de segurança (OverTempGuard): desliga a saída
+ *  na hora, de qualquer task, e write() fica em zero até liberar.
+ */
+#pragma once
+#include <stdint.h>
+#include "BurstFireModulator.hpp"
+
+class HeaterOutput {
+public:
+    enum Backend : uint8_t { HEATER_LEDC = 0, HEATER_BURST = 1 };
+
+    static constexpr uint32_t MAINS_HZ      = 60;    // rede elétrica (Brasil)
+    static constexpr uint32_t HALF_CYCLE_US = 1000000 / (2 * MAINS_HZ);
+    static constexpr uint32_t ZC_TIMEOUT_MS = 100;
+    static constexpr uint8_t  BURST_BLOCK   = 2;     // semiciclos por decisão (ciclo completo)
+
+    /** Configura o pino; zeroCrossPin < 0 ⇒ sem detector de zero.
+     *  Começa no backend LEDC, desligado. @return false se o LEDC falhou. */
+    static bool begin(uint8_t pin, uint32_t pwmFreq, uint8_t resBits,
+                      int8_t zeroCrossPin = -1);
+
+    /** Pede a troca de backend; aplicada no próximo write(), com a
+     *  saída desligada durante a troca. */
+    static void    setBackend(Backend b);
+    static Backend backend();
+
+    /** Duty 0..(2^resBits − 1), chamado pelo PidTask. */
+    static void write(uint16_t duty);
+
+    /** Corte de segurança: true desliga já e trava write() em zero. */
+    static void inhibit(bool on);
+    static bool inhibited();
+
+    /* ---- diagnóstico (backend burst) ---- */
+    static uint32_t switches();
+    static uint32_t halfCycles();
+    static uint32_t zeroCrossTimeouts();
+};
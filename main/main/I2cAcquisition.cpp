@@ -0,0 +1,223 @@
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "I2cAcquisition.hpp"
+
+static uint32_t usNow() { return static_cast<uint32_t>(esp_timer_get_time()); }
+
+bool I2cAcquisition::begin(int sda, int scl, uint32_t hz)
+{
+    hz_   = hz;
+    done_ = xQueueCreate(MAX_DEVICES, sizeof(uint8_t));
+
+    i2c_master_bus_config_t bc = {};
+    bc.i2c_port          = -1;                       // primeiro controlador livre
+    bc.sda_io_num        = static_cast<gpio_num_t>(sda);
+    bc.scl_io_num        = static_cast<gpio_num_t>(scl);
+    bc.clk_source        = I2C_CLK_SRC_DEFAULT;
+    bc.glitch_ignore_cnt = 7;
+    bc.trans_queue_depth = 2 * MAX_DEVICES;          // > 0 ⇒ modo assíncrono; leitura + disparo
+    bc.flags.enable_internal_pullup = 1;
+    return done_ && i2c_new_master_bus(&bc, &bus_) == ESP_OK;
+}
+
+int I2cAcquisition::addDevice(uint8_t addr, uint8_t readLen, uint32_t timeoutUs,
+                              Callback cb, void* arg)
+{
+    if (!bus_ || count_ >= MAX_DEVICES || readLen == 0 || readLen > MAX_READ) return -1;
+
+    Slot& s = slots_[count_];
+    i2c_device_config_t dc = {};
+    dc.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dc.device_address  = addr;
+    dc.scl_speed_hz    = hz_;
+    if (i2c_master_bus_add_device(bus_, &dc, &s.dev) != ESP_OK) return -1;
+
+    i2c_master_event_callbacks_t cbs = {};
+    cbs.on_trans_done = onDone;
+    if (i2c_master_register_event_callbacks(s.dev, &cbs, &s) != ESP_OK) return -1;
+
+    s.owner   = this;
+    s.idx     = static_cast<uint8_t>(count_);
+    s.addr    = addr;
+    s.len     = readLen;
+    s.timeout = timeoutUs;
+    s.cb      = cb;
+    s.arg     = arg;
+    return count_++;
+}
+
+bool I2cAcquisition::setTransfer(int dev, int reg, const uint8_t* after, uint8_t afterLen)
+{
+    if (dev < 0 || dev >= count_ || afterLen > MAX_AFTER) return false;
+    Slot& s = slots_[dev];
+    s.ptr = reg >= 0;
+    s.reg = static_cast<uint8_t>(reg < 0 ? 0 : reg);
+    for (uint8_t i = 0; i < afterLen; ++i) s.after[i] = after[i];
+    s.afterLen = afterLen;
+    return true;
+}
+
+bool I2cAcquisition::probe(uint8_t addr)
+{
+    return bus_ && i2c_master_probe(bus_, addr, static_cast<int>((PROBE_TIMEOUT_US + 999) / 1000)) == ESP_OK;
+}
+
+/* dispositivo temporário sem callbacks: transações síncronas mesmo com
+ * o barramento em modo assíncrono */
+bool I2cAcquisition::readRegister(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len)
+{
+    if (!bus_) return false;
+    i2c_device_config_t dc = {};
+    dc.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dc.device_address  = addr;
+    dc.scl_speed_hz    = hz_;
+    i2c_master_dev_handle_t dev;
+    if (i2c_master_bus_add_device(bus_, &dc, &dev) != ESP_OK) return false;
+
+    const int     ms   = static_cast<int>((PROBE_TIMEOUT_US + 999) / 1000);
+    const uint8_t zero = 0;
+    bool ok = i2c_master_transmit_receive(dev, &reg, 1, buf, len, ms) == ESP_OK;
+    ok = i2c_master_transmit(dev, &zero, 1, ms) == ESP_OK && ok;
+    i2c_master_bus_rm_device(dev);
+    return ok;
+}
+
+bool I2cAcquisition::writeRegister(uint8_t addr, uint8_t reg, const uint8_t* buf, uint8_t len)
+{
+    if (!bus_ || len > MAX_READ) return false;
+    i2c_device_config_t dc = {};
+    dc.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dc.device_address  = addr;
+    dc.scl_speed_hz    = hz_;
+    i2c_master_dev_handle_t dev;
+    if (i2c_master_bus_add_device(bus_, &dc, &dev) != ESP_OK) return false;
+
+    const int ms = static_cast<int>((PROBE_TIMEOUT_US + 999) / 1000);
+    uint8_t   w[1 + MAX_READ] = { reg };
+    for (uint8_t i = 0; i < len; ++i) w[1 + i] = buf[i];
+    const uint8_t zero = 0;
+    bool ok = i2c_master_transmit(dev, w, 1 + len, ms) == ESP_OK;
+    ok = i2c_master_transmit(dev, &zero, 1, ms) == ESP_OK && ok;
+    i2c_master_bus_rm_device(dev);
+    return ok;
+}
+
+/* ISR do driver: registra o resultado e, na última transação do
+ * dispositivo (leitura + disparo), acorda finish() */
+bool IRAM_ATTR I2cAcquisition::onDone(i2c_master_dev_handle_t, const i2c_master_event_data_t* evt,
+                                      void* arg)
+{
+    if (evt->event == I2C_EVENT_ALIVE) return false;      // ainda em curso
+    Slot& s = *static_cast<Slot*>(arg);
+    if (evt->event != I2C_EVENT_DONE && s.st == ST_PENDING)
+        s.st = (evt->event == I2C_EVENT_NACK) ? ST_NACK : ST_ERROR;
+    if (s.parts.fetch_sub(1) != 1) return false;
+    if (s.st == ST_PENDING) s.st = ST_OK;
+    s.doneUs = usNow();
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(s.owner->done_, &s.idx, &woken);
+    return woken == pdTRUE;
+}
+
+/* conclusão sem ISR (transação que nem entrou na fila) */
+void I2cAcquisition::complete(Slot& s)
+{
+    if (s.st == ST_PENDING) s.st = ST_OK;
+    s.doneUs = usNow();
+    xQueueSend(done_, &s.idx, 0);
+}
+
+void I2cAcquisition::start(uint32_t mask)
+{
+    xQueueReset(done_);                    // conclusões atrasadas do ciclo anterior
+    t0_ = lastDone_ = usNow();
+    uint32_t deadline = t0_;
+    for (int i = 0; i < count_; ++i) {
+        Slot& s = slots_[i];
+        s.active = (mask >> i) & 1u;
+        if (!s.active) continue;
+        // as transações saem em sequência: o prazo de cada uma soma o das anteriores
+        deadline  += s.afterLen ? 2 * s.timeout : s.timeout;
+        s.deadline = deadline;
+        s.reported = false;
+        s.st       = ST_PENDING;
+        s.parts    = s.afterLen ? 2 : 1;
+        int ms = static_cast<int>((s.timeout + 999) / 1000);
+        esp_err_t err = s.ptr ? i2c_master_transmit_receive(s.dev, &s.reg, 1, s.buf, s.len, ms)
+                              : i2c_master_receive(s.dev, s.buf, s.len, ms);
+        if (err != ESP_OK) {
+            s.st    = ST_ERROR;               // fila cheia / barramento em erro
+            s.parts = 0;
+            complete(s);
+            continue;
+        }
+        if (s.afterLen && i2c_master_transmit(s.dev, s.after, s.afterLen, ms) != ESP_OK) {
+            if (s.st == ST_PENDING) s.st = ST_ERROR;
+            if (s.parts.fetch_sub(1) == 1) complete(s);
+        }
+    }
+}
+
+void I2cAcquisition::report(Slot& s)
+{
+    s.reported = true;
+    if (s.st == ST_OK) {
+        bool ones = true;
+        for (uint8_t i = 0; i < s.len && ones; ++i) ones = s.buf[i] == 0xFF;
+        if (ones) s.st = ST_SHORT;
+    }
+    // tempo de barramento: desde a conclusão anterior (as transações saem em fila)
+    const uint32_t lat = int32_t(s.doneUs - lastDone_) > 0 ? s.doneUs - lastDone_ : 0;
+    if (int32_t(s.doneUs - lastDone_) > 0) lastDone_ = s.doneUs;
+    static const I2cStats::Outcome OUT[] = {
+        I2cStats::OUT_ERROR, I2cStats::OUT_ERROR, I2cStats::OUT_OK, I2cStats::OUT_NACK,
+        I2cStats::OUT_TIMEOUT, I2cStats::OUT_ERROR, I2cStats::OUT_SHORT,
+    };
+    stats_.record(s.idx, OUT[s.st], lat);
+
+    const bool ok = s.st == ST_OK;
+    if (s.cb) s.cb(s.idx, s.st, ok ? s.buf : nullptr, ok ? s.len : 0, s.doneUs, s.arg);
+}
+
+uint32_t I2cAcquisition::finish()
+{
+    int  pending  = 0;
+    bool timedOut = false;
+    for (int i = 0; i < count_; ++i) pending += slots_[i].active;
+    uint32_t last = t0_;
+
+    while (pending > 0) {
+        // prazo mais próximo entre as pendentes
+        Slot* next = nullptr;
+        for (int i = 0; i < count_; ++i)
+            if (slots_[i].active && !slots_[i].reported &&
+                (!next || int32_t(slots_[i].deadline - next->deadline) < 0))
+                next = &slots_[i];
+
+        const int32_t left = int32_t(next->deadline - usNow());
+        uint8_t idx;
+        if (left > 0 &&
+            xQueueReceive(done_, &idx, pdMS_TO_TICKS((left + 999) / 1000) + 1) == pdTRUE) {
+            Slot& s = slots_[idx];
+            if (!s.active || s.reported) continue;
+            last = s.doneUs;
+            report(s);
+            --pending;
+        } else if (int32_t(next->deadline - usNow()) <= 0) {
+            next->st     = ST_TIMEOUT;
+            next->doneUs = usNow();
+            last = next->doneUs;
+            report(*next);
+            --pending;
+            timedOut = true;
+        }
+    }
+
+    // transação presa: esvazia a fila do driver ou reinicia o barramento
+    if (timedOut && i2c_master_bus_wait_all_done(bus_, 10) != ESP_OK)
+        i2c_master_bus_reset(bus_);
+
+    cycleUs_ = last - t0_;
+    if (cycleUs_ > cycleMax_) cycleMax_ = cycleUs_;
+    return cycleUs_;
+}
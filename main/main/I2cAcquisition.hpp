@@ -0,0 +1,128 @@
+/*  I2cAcquisition.hpp
+ *  -------------------------------------------------------------
+ *  Leitura das sondas I²C sem bloqueio, pelo driver i2c_master do
+ *  ESP-IDF em modo assíncrono (fila de transações + interrupção):
+ *
+ *   start()   enfileira a leitura dos dispositivos do ciclo de uma vez
+ *             e retorna; o barramento as executa em sequência, sem
+ *             a task no meio;
+ *   finish()  espera as conclusões, avisadas pela ISR numa fila do
+ *             FreeRTOS, e chama o callback de cada dispositivo na
+ *             ordem em que terminam.
+ *
+ *  Cada transação tem prazo próprio (timeoutUs, somado ao das que
+ *  estão antes dela na fila). Sonda ausente responde NACK em
+ *  ~0,1 ms, sem segurar as outras; prazo estourado vira ST_TIMEOUT e
+ *  o barramento é reiniciado antes do ciclo seguinte.
+ *
+ *  Cada leitura pode ser precedida da escrita do ponteiro do
+ *  registrador de temperatura e seguida de uma escrita de disparo
+ *  (setTransfer(): conversão one-shot pedida logo após ler a anterior,
+ *  ver ProbeDriver); a conclusão sai depois das duas transações.
+ *
+ *  O tempo de um ciclo fica perto do tempo de barramento das N
+ *  leituras, em vez de N vezes o custo de Wire.requestFrom().
+ *
+ *  Cada conclusão entra em stats() (I2cStats): resultado e tempo de
+ *  barramento do dispositivo. Leitura só com 0xFF (escravo soltou o
+ *  barramento no meio, pull-up devolvendo 1s) vira ST_SHORT.
+ *
+ *  probe(), readRegister() e writeRegister() são síncronos, para a
+ *  varredura da partida (SensorRegistry), antes de começarem os ciclos.
+ */
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/i2c_master.h"
+#include "I2cStats.hpp"
+
+class I2cAcquisition {
+public:
+    static constexpr int MAX_DEVICES = 16;
+    static constexpr int MAX_READ    = 4;       // bytes por leitura
+    static constexpr int MAX_AFTER   = 2;       // bytes da escrita de disparo
+    static constexpr uint32_t ALL    = 0xFFFFFFFFu;
+    static constexpr uint32_t PROBE_TIMEOUT_US = 10000;   // probe()/readRegister()
+
+    enum Status : uint8_t { ST_IDLE = 0, ST_PENDING, ST_OK, ST_NACK, ST_TIMEOUT, ST_ERROR, ST_SHORT };
+
+    /** Conclusão de uma leitura, chamada dentro de finish() (contexto
+     *  da task). data/len só valem com ST_OK; atUs = instante da ISR. */
+    using Callback = void (*)(int dev, Status st, const uint8_t* data, uint8_t len,
+                              uint32_t atUs, void* arg);
+
+    /** Cria o barramento (pull-ups internos). @return false se falhou. */
+    bool begin(int sda, int scl, uint32_t hz);
+
+    /** @return índice do dispositivo (ordem na fila) ou −1. */
+    int addDevice(uint8_t addr, uint8_t readLen, uint32_t timeoutUs, Callback cb, void* arg);
+
+    /** Leitura com ponteiro `reg` escrito antes (reg < 0: sem ponteiro)
+     *  e `after` escrito depois (afterLen 0: nada). Só entre ciclos. */
+    bool setTransfer(int dev, int reg, const uint8_t* after, uint8_t afterLen);
+
+    /** ACK no endereço? (síncrono; só fora dos ciclos) */
+    bool probe(uint8_t addr);
+    /** Escreve o ponteiro `reg`, lê `len` bytes e volta o ponteiro a 0
+     *  (registrador de temperatura). Síncrono; só fora dos ciclos. */
+    bool readRegister(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len);
+    /** Escreve `len` bytes em `reg` e volta o ponteiro a 0. Síncrono. */
+    bool writeRegister(uint8_t addr, uint8_t reg, const uint8_t* buf, uint8_t len);
+
+    /** Enfileira a leitura dos dispositivos do ciclo (bit i = índice i;
+     *  os outros ficam de fora, sem callback) e retorna. */
+    void start(uint32_t mask = ALL);
+
+    /** Espera as conclusões ou os prazos, chamando os callbacks.
+     *  @return µs de start() até a última conclusão                   */
+    uint32_t finish();
+
+    int      deviceCount() const     { return count_; }
+    uint8_t  address(int dev) const  { return slots_[dev].addr; }
+    Status   status(int dev) const   { return slots_[dev].st; }
+    uint32_t cycleUs() const         { return cycleUs_; }
+    uint32_t cycleMaxUs() const      { return cycleMax_; }
+    const I2cStats& stats() const    { return stats_; }
+    /** Zera as estatísticas (na task dos ciclos). */
+    void     resetStats()            { stats_.reset(); cycleMax_ = 0; }
+
+private:
+    struct Slot {
+        I2cAcquisition*         owner = nullptr;
+        i2c_master_dev_handle_t dev   = nullptr;
+        uint8_t  idx      = 0;
+        uint8_t  addr     = 0;
+        uint8_t  len      = 1;
+        bool     ptr      = false;  // ponteiro escrito antes da leitura
+        uint8_t  reg      = 0;
+        uint8_t  after[MAX_AFTER] = {};
+        uint8_t  afterLen = 0;
+        bool     active   = false;  // no ciclo atual
+        uint32_t timeout  = 0;      // µs, por transação
+        uint32_t deadline = 0;      // µs, absoluto no ciclo atual
+        Callback cb       = nullptr;
+        void*    arg      = nullptr;
+        uint8_t  buf[MAX_READ] = {};
+        volatile Status   st     = ST_IDLE;
+        volatile uint32_t doneUs = 0;
+        std::atomic<uint8_t> parts{0};   // transações ainda em curso
+        bool     reported = false;
+    };
+
+    static bool onDone(i2c_master_dev_handle_t dev, const i2c_master_event_data_t* evt, void* arg);
+    void report(Slot& s);
+    void complete(Slot& s);
+
+    i2c_master_bus_handle_t bus_ = nullptr;
+    QueueHandle_t done_  = nullptr;         // índices concluídos (ISR → task)
+    uint32_t hz_         = 100000;
+    Slot     slots_[MAX_DEVICES];
+    int      count_      = 0;
+    uint32_t t0_         = 0;
+    uint32_t lastDone_   = 0;               // conclusão anterior no ciclo (latência)
+    I2cStats stats_;
+    uint32_t cycleUs_    = 0;
+    uint32_t cycleMax_   = 0;
+};
@@ -0,0 +1,29 @@
+#include "I2cProbeBackend.hpp"
+
+int I2cProbeBackend::addProbe(uint8_t addr, uint8_t readLen, uint32_t timeoutUs)
+{
+    return bus_.addDevice(addr, readLen, timeoutUs, onDone, this);
+}
+
+void I2cProbeBackend::configure(int dev, const ProbeDriver& d)
+{
+    const uint8_t trig[2] = { ProbeDriver::REG_CONFIG, d.trigger() };
+    bus_.setTransfer(dev, d.setPointer() ? ProbeDriver::REG_TEMP : -1, trig, d.oneShot() ? 2 : 0);
+}
+
+void I2cProbeBackend::read(uint32_t mask, Done done, void* arg)
+{
+    done_ = done;
+    arg_  = arg;
+    bus_.start(mask);
+    bus_.finish();
+}
+
+void I2cProbeBackend::onDone(int dev, I2cAcquisition::Status st, const uint8_t* data, uint8_t len,
+                             uint32_t atUs, void* arg)
+{
+    I2cProbeBackend* self = static_cast<I2cProbeBackend*>(arg);
+    if (!self->done_) return;
+    const bool ok = st == I2cAcquisition::ST_OK;
+    self->done_(dev, ok ? data : nullptr, ok ? len : 0, atUs, self->arg_);
+}
@@ -0,0 +1,29 @@
+/*  I2cProbeBackend.hpp
+ *  -------------------------------------------------------------
+ *  ProbeBackend sobre o barramento real: cada sonda é um dispositivo
+ *  do I2cAcquisition (mesmo índice do SensorRegistry); o ciclo é um
+ *  start() + finish(), e as conclusões viram leituras com ou sem dados.
+ */
+#pragma once
+#include "ProbeBackend.hpp"
+#include "I2cAcquisition.hpp"
+
+class I2cProbeBackend : public ProbeBackend {
+public:
+    explicit I2cProbeBackend(I2cAcquisition& bus) : bus_(bus) {}
+
+    /** Registra a sonda no barramento. @return índice ou −1. */
+    int addProbe(uint8_t addr, uint8_t readLen, uint32_t timeoutUs);
+
+    void configure(int dev, const ProbeDriver& d) override;
+    void read(uint32_t mask, Done done, void* arg) override;
+    const char* name() const override { return "i2c"; }
+
+private:
+    static void onDone(int dev, I2cAcquisition::Status st, const uint8_t* data, uint8_t len,
+                       uint32_t atUs, void* arg);
+
+    I2cAcquisition& bus_;
+    Done  done_ = nullptr;
+    void* arg_  = nullptr;
+};
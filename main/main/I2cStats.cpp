@@ -0,0 +1,30 @@
+#include "I2cStats.hpp"
+
+int I2cStats::bin(uint32_t us)
+{
+    int i = 0;
+    for (uint32_t lim = BIN0_US; i < BINS - 1 && us >= lim; lim <<= 1) ++i;
+    return i;
+}
+
+void I2cStats::record(int dev, Outcome o, uint32_t latencyUs)
+{
+    if (dev < 0 || dev >= MAX_DEVICES || o >= OUT_COUNT) return;
+    Device& d = d_[dev];
+    ++d.attempts;
+    ++d.outcome[o];
+    if (o == OUT_OK) {
+        d.failRun = 0;
+    } else if (++d.failRun > d.failRunMax) {
+        d.failRunMax = d.failRun;
+    }
+    if (latencyUs < d.latMin) d.latMin = latencyUs;
+    if (latencyUs > d.latMax) d.latMax = latencyUs;
+    d.latSum += latencyUs;
+    ++d.hist[bin(latencyUs)];
+}
+
+void I2cStats::reset()
+{
+    for (Device& d : d_) d = Device();
+}
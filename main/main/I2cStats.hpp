@@ -0,0 +1,59 @@
+/*  I2cStats.hpp
+ *  -------------------------------------------------------------
+ *  Estatísticas de transação I²C por dispositivo, mantidas pela
+ *  camada de aquisição (I2cAcquisition): tentativas, resultados
+ *  (ok, NACK, prazo estourado, leitura curta, erro do driver), maior
+ *  sequência de falhas e latência (mín./média/máx. e histograma em
+ *  potências de 2: [0,64) [64,128) ... [8192,16384) ≥16384 µs).
+ *
+ *  Latência de um dispositivo = tempo de barramento da sua leitura
+ *  (e do disparo, se houver), medido da conclusão anterior no ciclo
+ *  até a sua. Serve para dimensionar a velocidade do barramento e,
+ *  com a taxa de falhas, acusar fiação degradando antes que a sonda
+ *  saia do controle.
+ *
+ *  Um só escritor (o I2CTask); leitores em outra task veem contadores
+ *  inteiros, não necessariamente do mesmo ciclo.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+
+class I2cStats {
+public:
+    static constexpr int      MAX_DEVICES = 16;
+    static constexpr int      BINS        = 10;
+    static constexpr uint32_t BIN0_US     = 64;      // limite superior da 1ª faixa
+
+    enum Outcome : uint8_t { OUT_OK, OUT_NACK, OUT_TIMEOUT, OUT_SHORT, OUT_ERROR, OUT_COUNT };
+
+    struct Device {
+        uint32_t attempts = 0;
+        uint32_t outcome[OUT_COUNT] = {};
+        uint32_t failRun    = 0;          // falhas seguidas agora
+        uint32_t failRunMax = 0;
+        uint32_t latMin = UINT32_MAX, latMax = 0;
+        uint64_t latSum = 0;
+        uint32_t hist[BINS] = {};
+
+        uint32_t ok()        const { return outcome[OUT_OK]; }
+        uint32_t failures()  const { return attempts - outcome[OUT_OK]; }
+        float    latMean()   const { return attempts ? static_cast<float>(latSum) / attempts : 0.0f; }
+    };
+
+    /** Resultado de uma transação do dispositivo `dev`. */
+    void record(int dev, Outcome o, uint32_t latencyUs);
+    void reset();
+
+    const Device& device(int dev) const { return d_[dev]; }
+
+    /** Faixa do histograma para `us`. */
+    static int bin(uint32_t us);
+    /** Limite inferior (µs) da faixa `i`. */
+    static uint32_t binFloor(int i) { return i == 0 ? 0 : BIN0_US << (i - 1); }
+
+private:
+    Device d_[MAX_DEVICES];
+};
@@ -0,0 +1,51 @@
+#include "LoopStats.hpp"
+
+int LoopStats::bin(uint32_t us)
+{
+    int i = 0;
+    for (uint32_t lim = BIN0_US; i < BINS - 1 && us >= lim; lim <<= 1) ++i;
+    return i;
+}
+
+void LoopStats::begin(uint64_t nowUs)
+{
+    if (!started_) {
+        release_ = nowUs;
+        started_ = true;
+    } else {
+        release_ += periodUs_;
+        uint32_t p = static_cast<uint32_t>(nowUs - lastStart_);
+        if (p < pMin_) pMin_ = p;
+        if (p > pMax_) pMax_ = p;
+        uint32_t dev = (p > periodUs_) ? p - periodUs_ : periodUs_ - p;
+        ++jHist_[bin(dev)];
+
+        // se o laço atrasou mais de um período, o vTaskDelayUntil só
+        // alcança a grade depois; realinha para não acusar perdas em cascata
+        while (nowUs >= release_ + periodUs_) release_ += periodUs_;
+    }
+    uint32_t lat = nowUs > release_ ? static_cast<uint32_t>(nowUs - release_) : 0;
+    if (lat > lMax_) lMax_ = lat;
+    lastStart_ = start_ = nowUs;
+}
+
+void LoopStats::end(uint64_t nowUs)
+{
+    if (!started_) return;
+    uint32_t c = static_cast<uint32_t>(nowUs - start_);
+    ++count_;
+    cSum_ += c;
+    if (c > cMax_) cMax_ = c;
+    ++cHist_[bin(c)];
+    if (nowUs > release_ + periodUs_) ++misses_;
+}
+
+void LoopStats::reset()
+{
+    started_ = false;
+    count_ = misses_ = 0;
+    pMin_ = UINT32_MAX; pMax_ = 0;
+    cMax_ = lMax_ = 0;
+    cSum_ = 0;
+    for (int i = 0; i < BINS; ++i) jHist_[i] = cHist_[i] = 0;
+}
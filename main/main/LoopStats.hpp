@@ -0,0 +1,58 @@
+/*  LoopStats.hpp
+ *  -------------------------------------------------------------
+ *  Instrumentação de laço periódico (PidTask): período real entre
+ *  iterações, tempo de cálculo e perdas de prazo.
+ *
+ *  begin() no início de cada iteração e end() após a escrita da
+ *  saída, com o tempo em µs (esp_timer_get_time() no firmware,
+ *  relógio simulado no host). Os histogramas usam faixas em
+ *  potências de 2:  [0,16) [16,32) ... [8192,16384) ≥16384 µs.
+ *
+ *  Prazo: a iteração k é liberada em t0 + k·período e deve terminar
+ *  antes da liberação seguinte.
+ */
+#pragma once
+#include <stdint.h>
+
+class LoopStats {
+public:
+    static constexpr int      BINS     = 12;
+    static constexpr uint32_t BIN0_US  = 16;     // limite superior da 1ª faixa
+
+    explicit LoopStats(uint32_t periodUs) : periodUs_(periodUs) {}
+
+    void begin(uint64_t nowUs);
+    void end(uint64_t nowUs);
+    void reset();
+
+    /** Faixa do histograma para `us`. */
+    static int bin(uint32_t us);
+    /** Limite inferior (µs) da faixa `i`. */
+    static uint32_t binFloor(int i) { return i == 0 ? 0 : BIN0_US << (i - 1); }
+
+    uint32_t periodUs() const      { return periodUs_; }
+    uint32_t count() const         { return count_; }
+    uint32_t misses() const        { return misses_; }
+    uint32_t periodMin() const     { return pMin_; }
+    uint32_t periodMax() const     { return pMax_; }
+    uint32_t computeMax() const    { return cMax_; }
+    uint32_t latencyMax() const    { return lMax_; }       // atraso início − liberação
+    float    computeMean() const   { return count_ ? static_cast<float>(cSum_) / count_ : 0.0f; }
+    /** |período − nominal| */
+    const uint32_t* jitterHist() const  { return jHist_; }
+    const uint32_t* computeHist() const { return cHist_; }
+
+private:
+    uint32_t periodUs_;
+    uint64_t release_  = 0;       // liberação ideal da iteração atual
+    uint64_t start_    = 0;
+    uint64_t lastStart_ = 0;
+    bool     started_  = false;
+
+    uint32_t count_  = 0, misses_ = 0;
+    uint32_t pMin_   = UINT32_MAX, pMax_ = 0;
+    uint32_t cMax_   = 0, lMax_ = 0;
+    uint64_t cSum_   = 0;
+    uint32_t jHist_[BINS] = {};
+    uint32_t cHist_[BINS] = {};
+};
@@ -0,0 +1,50 @@
+#include "LossFeedForward.hpp"
+#include <math.h>
+
+/* limites de sanidade para o que é gravado no modelo */
+static constexpr float LOSS_MIN    = 1e-6f;
+static constexpr float LOSS_MAX    = 1.0f;
+static constexpr float AMBIENT_MIN = -10.0f;
+static constexpr float AMBIENT_MAX = 50.0f;
+
+void LossFeedForward::learn(float t, float duty, float dt, ThermalModel& m)
+{
+    float rate = hasLast_ && dt > 0.0f ? (t - lastT_) / dt : 0.0f;
+    bool  first = !hasLast_;
+    lastT_   = t;
+    hasLast_ = true;
+    if (!enabled_ || first || fabsf(rate) > p_.maxRate) return;
+
+    /* --- acumula (T, perda líquida) com esquecimento --- */
+    float y = m.heatGain * duty - rate;
+    float l = p_.forget;
+    sw_  = l * sw_  + 1.0f;
+    sx_  = l * sx_  + t;
+    sy_  = l * sy_  + y;
+    sxx_ = l * sxx_ + t * t;
+    sxy_ = l * sxy_ + t * y;
+    ++samples_;
+    if (sw_ < p_.minWeight) return;
+
+    float mx  = sx_ / sw_;
+    float my  = sy_ / sw_;
+    float var = sxx_ / sw_ - mx * mx;
+
+    float k  = m.lossCoef;
+    float ta = m.ambient;
+    if (var >= p_.minSpread * p_.minSpread) {
+        // regressão y = k·T + c  ⇒  Ta = −c / k
+        k  = (sxy_ / sw_ - mx * my) / var;
+        if (k > 0.0f) ta = mx - my / k;
+    } else if (mx - m.ambient >= p_.minRise) {
+        // só um patamar: y = k·(T − Ta) com o ambiente atual
+        k = my / (mx - m.ambient);
+    } else {
+        return;
+    }
+
+    if (k < LOSS_MIN || k > LOSS_MAX) return;
+    if (ta < AMBIENT_MIN || ta > AMBIENT_MAX) return;
+    m.lossCoef = k;
+    m.ambient  = ta;
+}
@@ -0,0 +1,64 @@
+/*  LossFeedForward.hpp
+ *  -------------------------------------------------------------
+ *  Antecipação (feed-forward) das perdas térmicas para o PidTask.
+ *
+ *  Em regime quase todo o duty serve só para repor a perda para o
+ *  ambiente, que o integrador precisa reencontrar a cada troca de
+ *  etapa. O termo
+ *
+ *      uff = lossCoef·(sp − ambient) / heatGain
+ *
+ *  é somado à saída do PID, que passa a corrigir apenas o resíduo.
+ *  Se o modelo aprendido muda uff no mesmo set-point, o PidTask tira
+ *  do integrador a parte da diferença que ele já compensava, senão
+ *  ela entraria duas vezes na saída.
+ *
+ *  lossCoef e ambient são aprendidos nos patamares (taxa ≈ 0): cada
+ *  amostra dá a perda líquida y = heatGain·u − dT/dt = k·T − k·Ta,
+ *  e uma regressão linear com esquecimento sobre (T, y) fornece k e
+ *  Ta. Enquanto as amostras cobrem uma faixa estreita de T só k é
+ *  ajustado, com o ambiente atual.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+
+class LossFeedForward {
+public:
+    struct Params {
+        float maxRate   = 0.01f;   // °C/s   |dT/dt| máximo para considerar regime
+        float minRise   = 5.0f;    // °C     T − ambiente mínimo para ajustar só k
+        float minSpread = 2.0f;    // °C     desvio-padrão de T para ajustar k e Ta
+        float forget    = 0.998f;  //        esquecimento por amostra (~500 s)
+        float minWeight = 30.0f;   //        peso acumulado antes do 1º ajuste
+    };
+
+    LossFeedForward() = default;
+    explicit LossFeedForward(const Params& p) : p_(p) {}
+
+    void setEnabled(bool en) { enabled_ = en; }
+    bool enabled() const     { return enabled_; }
+
+    /** Alimenta o aprendizado (1 Hz) e ajusta m.lossCoef / m.ambient.
+     *  A taxa vem da diferença entre chamadas, e não do modelo, para
+     *  que um lossCoef errado não impeça o próprio aprendizado.
+     *  @param t     temperatura estimada (°C)
+     *  @param duty  duty médio do intervalo (0..1)
+     *  @param dt    intervalo desde a última chamada (s)            */
+    void learn(float t, float duty, float dt, ThermalModel& m);
+
+    /** Duty de antecipação (0..1) para o set-point; 0 se desligado. */
+    float duty(float sp, const ThermalModel& m) const {
+        return enabled_ ? m.steadyDuty(sp) : 0.0f;
+    }
+
+    uint32_t samples() const { return samples_; }
+
+private:
+    Params   p_{};
+    bool     enabled_ = false;
+    float    sw_ = 0, sx_ = 0, sy_ = 0, sxx_ = 0, sxy_ = 0;   // somas ponderadas
+    uint32_t samples_ = 0;
+    float    lastT_   = 0;
+    bool     hasLast_ = false;
+};
@@ -0,0 +1,49 @@
+#include "MixerController.hpp"
+#include <math.h>
+
+bool MixerController::update(float t1, float t2, float dt)
+{
+    const float g = fabsf(t1 - t2);
+    grad_ += p_.alpha * (g - grad_);
+
+    highFor_ = (g > p_.onGrad)      ? highFor_ + dt : 0.0f;   // RF-09: ΔT > 1 °C por 5 s
+    lowFor_  = (grad_ < p_.offGrad) ? lowFor_  + dt : 0.0f;
+
+    /* --- velocidade proporcional ao gradiente --- */
+    float x = (grad_ - p_.offGrad) / (p_.fullGrad - p_.offGrad);
+    if (x < 0.0f) x = 0.0f;
+    if (x > 1.0f) x = 1.0f;
+    speed_ = p_.minSpeed + (1.0f - p_.minSpeed) * x;
+
+    /* --- liga/desliga com histerese e tempos mínimos --- */
+    bool was = running_;
+    if (!running_) {
+        if (highFor_ >= p_.onDelay) {
+            running_ = true;
+            onFor_   = 0.0f;
+            ++starts_;
+        }
+    } else {
+        onFor_ += dt;
+        if (onFor_ >= p_.minRun && lowFor_ >= p_.postMix) running_ = false;
+    }
+    return running_ != was;
+}
+
+bool MixerController::updateBlind(float dt)
+{
+    grad_    = 0.0f;
+    highFor_ = 0.0f;
+    lowFor_  = 0.0f;
+    speed_   = p_.blindSpeed;
+
+    bool was = running_;
+    if (!running_) {
+        running_ = true;
+        onFor_   = 0.0f;
+        ++starts_;
+    } else {
+        onFor_ += dt;
+    }
+    return running_ != was;
+}
@@ -0,0 +1,63 @@
+/*  MixerController.hpp
+ *  -------------------------------------------------------------
+ *  Lei de controle do misturador a partir do gradiente entre as
+ *  sondas (RF-09).
+ *
+ *  O |t1 − t2| é filtrado (média exponencial) e:
+ *   • liga quando o gradiente medido, sem o filtro, fica acima de
+ *     onGrad por onDelay s (o atraso do filtro somaria uns 4 s aos
+ *     5 s do RF-09);
+ *   • a velocidade cresce linearmente de minSpeed (em offGrad) até
+ *     1,0 (em fullGrad);
+ *   • desliga só depois de minRun s ligado e de postMix s seguidos
+ *     com o gradiente abaixo de offGrad (histerese onGrad/offGrad).
+ *
+ *  Com uma sonda fora do controle não há gradiente: updateBlind()
+ *  mantém o misturador ligado em blindSpeed, para a sonda que sobrou
+ *  continuar representando a massa. De volta a update(), o filtro
+ *  parte de zero e a histerese normal desliga.
+ *
+ *  Código C++ puro; chamado pelo TempTask a 1 Hz.
+ */
+#pragma once
+#include <stdint.h>
+
+class MixerController {
+public:
+    struct Params {
+        float onGrad   = 1.0f;    // °C  liga acima disto (RF-09)
+        float offGrad  = 0.5f;    // °C  considera homogêneo abaixo disto
+        float fullGrad = 3.0f;    // °C  velocidade máxima a partir daqui
+        float minSpeed = 0.3f;    //     menor velocidade útil do motor
+        float alpha    = 0.3f;    //     peso de cada amostra no filtro
+        float onDelay  = 5.0f;    // s   gradiente alto antes de ligar (RF-09)
+        float postMix  = 20.0f;   // s   pós-mistura com gradiente baixo (RF-09)
+        float minRun   = 30.0f;   // s   tempo mínimo ligado
+        float blindSpeed = 0.5f;  //     velocidade sem gradiente (uma sonda só)
+    };
+
+    MixerController() = default;
+    explicit MixerController(const Params& p) : p_(p) {}
+
+    /** Um passo da lei de controle.
+     *  @return true se o estado ligado/desligado mudou.              */
+    bool update(float t1, float t2, float dt);
+    /** Passo sem gradiente medido (uma sonda só): liga em blindSpeed.
+     *  @return true se o estado ligado/desligado mudou.              */
+    bool updateBlind(float dt);
+
+    bool  running() const  { return running_; }
+    float speed() const    { return running_ ? speed_ : 0.0f; }
+    float gradient() const { return grad_; }
+    uint32_t starts() const { return starts_; }
+
+private:
+    Params   p_{};
+    float    grad_    = 0.0f;
+    float    speed_   = 0.0f;
+    float    highFor_ = 0.0f;     // s com gradiente medido acima de onGrad
+    float    lowFor_  = 0.0f;     // s com gradiente abaixo de offGrad
+    float    onFor_   = 0.0f;     // s ligado
+    bool     running_ = false;
+    uint32_t starts_  = 0;
+};
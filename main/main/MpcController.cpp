@@ -0,0 +1,195 @@
+#include "MpcController.hpp"
+#include <algorithm>
+#include <cmath>
+
+void MpcController::setEnabled(bool en)
+{
+    if (en && !enabled_) {
+        // recomeça o plano e a estimativa de perturbação
+        for (float& u : u_) u = 0.0f;
+        dist_    = 0.0f;
+        hasLast_ = false;
+    }
+    enabled_ = en;
+}
+
+float MpcController::cost(int N, int M, const int start[], float dt, float uPrev) const
+{
+    float J = 0.0f;
+    for (int j = 0; j < N; ++j) {
+        const float e = err_[j];
+        J += 0.5f * p_.wTrack * e * e;
+        if (e > p_.band)       J += 0.5f * p_.wAbove * (e - p_.band) * (e - p_.band);
+        else if (e < -p_.band) J += 0.5f * p_.wBelow * (e + p_.band) * (e + p_.band);
+    }
+    float left = uPrev;
+    for (int r = 0; r < M; ++r) {
+        J += 0.5f * p_.wEnergy * (start[r + 1] - start[r]) * dt * u_[r];
+        J += 0.5f * p_.wMove * (u_[r] - left) * (u_[r] - left);
+        left = u_[r];
+    }
+    return J;
+}
+
+float MpcController::update(float sp, float spNext, float pv, int32_t secLeft,
+                            bool holding, const ThermalModel& m)
+{
+    if (!enabled_) return 0.0f;
+
+    const float dt = p_.dt;
+    const float a  = (m.lossCoef > 0.0f) ? std::exp(-m.lossCoef * dt) : 1.0f;
+    const float b  = (m.lossCoef > 0.0f) ? m.heatGain * (1.0f - a) / m.lossCoef : m.heatGain * dt;
+    const float c  = m.ambient * (1.0f - a);
+
+    int d = static_cast<int>(std::lround(m.deadTime / dt));
+    d = std::min(std::max(d, 0), MAX_DELAY - 1);
+    const int N  = std::min(std::max(p_.horizon, d + 2), MAX_HORIZON);
+    const int M  = std::min(std::max(p_.blocks, 1), MAX_BLOCKS);
+    const int Nu = N - d;                          // amostras de duty que afetam o horizonte
+    // blocos crescentes (1, 2, 4, … amostras): decisão fina perto,
+    // grossa no fim do horizonte
+    int start[MAX_BLOCKS + 1];
+    start[0] = 0;
+    for (int k = 1; k < M; ++k) {
+        const int s = static_cast<int>(std::lround(float(Nu) * ((1 << k) - 1) / ((1 << M) - 1)));
+        start[k] = std::min(std::max(s, start[k - 1] + 1), Nu - (M - k));
+    }
+    start[M] = Nu;
+    // a troca de etapa cai numa borda de bloco: um bloco que cobrisse
+    // as duas etapas teria de segurar uma e subir para a outra
+    const bool hasNext = holding && spNext > -273.0f;
+    if (hasNext && M > 1) {
+        int js = 0;
+        while (js < N && (js + 1) * dt <= secLeft) ++js;   // 1ª amostra com spNext
+        const int ks = js - d;                             // duty que chega nela
+        if (ks > 0 && ks < Nu) {
+            int kb = 1;
+            for (int k = 2; k < M; ++k)
+                if (std::abs(start[k] - ks) < std::abs(start[kb] - ks)) kb = k;
+            start[kb] = std::min(std::max(ks, kb), Nu - (M - kb));
+            for (int k = kb - 1; k >= 1; --k) start[k] = std::min(start[k], start[k + 1] - 1);
+            for (int k = kb + 1; k < M; ++k)  start[k] = std::max(start[k], start[k - 1] + 1);
+        }
+    }
+    auto past = [&](int i) { return uHist_[(uHead_ - i + MAX_DELAY) % MAX_DELAY]; };  // i ≥ 0: u[−1−i]
+
+    /* --- estado: a PV é a média do último intervalo (atrasada de
+     * pvDelay); o modelo com o duty aplicado dá a inclinação nele --- */
+    if (hasLast_) {
+        const float x1   = a * x_ + b * past(d) + c + dist_;
+        const float meas = x1 - (x1 - x_) * (p_.pvDelay / dt);
+        const float nu   = pv - meas;
+        dist_ += p_.distAlpha / (1 + d) * nu;
+        if (dist_ >  b) dist_ =  b;
+        if (dist_ < -b) dist_ = -b;
+        x_ = x1 + nu;
+    } else {
+        x_ = pv;
+    }
+    hasLast_ = true;
+
+    /* --- resposta livre (duty passado) e perfil de referência --- */
+    float t = x_;
+    for (int j = 0; j < N; ++j) {
+        const int k = j - d;                       // índice do duty que chega em j
+        t = a * t + c + dist_ + (k < 0 ? b * past(-k - 1) : 0.0f);
+        ref_[j] = (hasNext && (j + 1) * dt > secLeft) ? spNext : sp;
+        err_[j] = t - ref_[j];
+    }
+
+    /* --- resposta a cada bloco e erro com o plano anterior --- */
+    for (int blk = 0; blk < M; ++blk) {
+        float x = 0.0f;
+        for (int j = 0; j < N; ++j) {
+            const int k = j - d;
+            x = a * x + ((k >= start[blk] && k < start[blk + 1]) ? b : 0.0f);
+            phi_[j][blk] = x;
+            err_[j] += x * u_[blk];
+        }
+    }
+
+    /* --- Newton projetado com 0 ≤ u ≤ 1 (Gauss-Newton nas penalidades
+     * da banda): os blocos são quase colineares, a descida por
+     * coordenadas não convergia em poucas varreduras --- */
+    const float uPrev = past(0);
+    for (int it = 0; it < p_.iters; ++it) {
+        float H[MAX_BLOCKS][MAX_BLOCKS] = {};
+        float g[MAX_BLOCKS] = {};
+        for (int j = 0; j < N; ++j) {
+            const float e = err_[j];
+            float de = p_.wTrack * e, w = p_.wTrack;
+            if (e > p_.band)       { de += p_.wAbove * (e - p_.band); w += p_.wAbove; }
+            else if (e < -p_.band) { de += p_.wBelow * (e + p_.band); w += p_.wBelow; }
+            for (int r = 0; r < M; ++r) {
+                const float pr = phi_[j][r];
+                if (pr == 0.0f) continue;
+                g[r] += pr * de;
+                for (int q = 0; q <= r; ++q) H[r][q] += pr * phi_[j][q] * w;
+            }
+        }
+        for (int r = 0; r < M; ++r) {
+            // energia: wEnergy por segundo a plena potência
+            g[r] += 0.5f * p_.wEnergy * (start[r + 1] - start[r]) * dt;
+            // suavidade entre blocos (o bloco 0 em relação ao duty aplicado)
+            const float left = (r == 0) ? uPrev : u_[r - 1];
+            g[r] += p_.wMove * (u_[r] - left);
+            H[r][r] += p_.wMove;
+            if (r < M - 1) { g[r] += p_.wMove * (u_[r] - u_[r + 1]); H[r][r] += p_.wMove; }
+            if (r > 0) H[r][r - 1] -= p_.wMove;
+        }
+        // blocos no limite com o gradiente apontando para fora ficam fixos
+        int   fr[MAX_BLOCKS];
+        int   nf = 0;
+        for (int r = 0; r < M; ++r)
+            if (!((u_[r] <= 0.0f && g[r] > 0.0f) || (u_[r] >= 1.0f && g[r] < 0.0f))) fr[nf++] = r;
+        if (nf == 0) break;
+        // Cholesky do bloco livre (H[r][q], q ≤ r) e passo de Newton
+        float Lc[MAX_BLOCKS][MAX_BLOCKS];
+        float x[MAX_BLOCKS];
+        bool  ok = true;
+        for (int r = 0; r < nf && ok; ++r) {
+            for (int q = 0; q <= r; ++q) {
+                float sum = H[fr[r]][fr[q]];
+                for (int k = 0; k < q; ++k) sum -= Lc[r][k] * Lc[q][k];
+                if (q < r) Lc[r][q] = sum / Lc[q][q];
+                else if (sum > 1e-9f) Lc[r][r] = std::sqrt(sum);
+                else ok = false;
+            }
+        }
+        if (!ok) break;
+        for (int r = 0; r < nf; ++r) {
+            float sum = -g[fr[r]];
+            for (int k = 0; k < r; ++k) sum -= Lc[r][k] * x[k];
+            x[r] = sum / Lc[r][r];
+        }
+        for (int r = nf - 1; r >= 0; --r) {
+            float sum = x[r];
+            for (int k = r + 1; k < nf; ++k) sum -= Lc[k][r] * x[k];
+            x[r] = sum / Lc[r][r];
+        }
+        // passo com busca em linha: o modelo quadrático muda de peso
+        // quando um erro cruza a borda da banda
+        const float j0 = cost(N, M, start, dt, uPrev);
+        float du[MAX_BLOCKS] = {};
+        float moved = 0.0f;
+        for (float alpha = 1.0f; alpha > 0.1f; alpha *= 0.5f) {
+            moved = 0.0f;
+            for (int r = 0; r < nf; ++r) {
+                const int   blk = fr[r];
+                const float un  = std::min(std::max(u_[blk] - du[blk] + alpha * x[r], 0.0f), 1.0f);
+                const float dd  = un - u_[blk];
+                for (int j = 0; j < N; ++j) err_[j] += phi_[j][blk] * dd;
+                u_[blk]  = un;
+                du[blk] += dd;
+                moved = std::max(moved, std::fabs(du[blk]));
+            }
+            if (cost(N, M, start, dt, uPrev) <= j0) break;
+        }
+        if (moved < 1e-4f) break;
+    }
+    tEnd_ = err_[N - 1] + ref_[N - 1];
+
+    uHead_ = (uHead_ + 1) % MAX_DELAY;
+    uHist_[uHead_] = u_[0];
+    return u_[0];
+}
@@ -0,0 +1,102 @@
+/*  MpcController.hpp
+ *  -------------------------------------------------------------
+ *  Controle preditivo (MPC) leve sobre o horizonte da receita
+ *  (CTRL_MPC).
+ *
+ *  Modelo: ThermalModel discretizado em dt, com o tempo morto como
+ *  atraso de d = θ/dt amostras no duty,
+ *
+ *      T[j+1] = a·T[j] + b·u[j−d] + c + w      a = e^(−k·dt)
+ *
+ *  e w uma perturbação constante estimada do erro de predição de um
+ *  passo (ação integral, sem erro de regime com modelo imperfeito;
+ *  corrigida a distAlpha/(1 + d) por amostra). A PV é a média das
+ *  leituras do último intervalo, pvDelay atrás: o estado de partida
+ *  é o previsto pelo modelo com o duty aplicado, corrigido pela
+ *  diferença entre a PV e o previsto para pvDelay atrás.
+ *
+ *  A cada dt o duty do horizonte é escolhido com 0 ≤ u ≤ 1, em
+ *  blocos de duty constante que crescem (1, 2, 4, … amostras; a
+ *  troca de etapa sempre numa borda), por Newton projetado com
+ *  busca em linha, minimizando
+ *
+ *      Σ wTrack·e² + wBelow·max(0, −e − band)² + wAbove·max(0, e − band)²
+ *      + wEnergy·Σ u·dt + wMove·Σ (ΔU)²         e = T − r
+ *
+ *  onde r é o perfil de set-point conhecido: o da etapa atual e, com
+ *  o cronômetro correndo, o da próxima a partir de secLeft. Assim a
+ *  passagem de etapa é antecipada e o sobressinal do fim da rampa
+ *  (calor em trânsito no tempo morto) é previsto. Passar da banda por
+ *  cima (RNF-04) custa bem mais que ficar abaixo dela, então a
+ *  antecipação para na borda da banda da etapa atual. Só o primeiro
+ *  bloco é aplicado (horizonte deslizante).
+ *
+ *  Custo fixo e limitado: MAX_HORIZON × MAX_BLOCKS² multiplicações
+ *  por iteração, sem alocação; roda no PidTask uma vez por segundo.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+
+class MpcController {
+public:
+    static constexpr int MAX_HORIZON = 120;       // amostras previstas
+    static constexpr int MAX_BLOCKS  = 8;         // blocos de duty livres
+    static constexpr int MAX_DELAY   = 64;        // amostras de tempo morto
+
+    struct Params {
+        float dt        = 1.0f;    // s entre decisões
+        int   horizon   = 60;      // amostras (≤ MAX_HORIZON, > tempo morto)
+        int   blocks    = 6;       // blocos de duty no horizonte (≤ MAX_BLOCKS)
+        float band      = 0.5f;    // °C, metade da banda do RNF-04 (ruído, sonda atrás da massa)
+        float wTrack    = 1.0f;    // peso de e²
+        float wBelow    = 50.0f;   // peso extra abaixo da banda
+        float wAbove    = 1.0e4f;  // peso extra acima da banda
+        float wEnergy   = 5.0f;    // peso da energia (por segundo a plena potência)
+        float wMove     = 0.02f;   // peso da variação do duty entre blocos
+        int   iters     = 8;       // iterações de Newton projetado
+        float distAlpha = 0.3f;    // filtro da perturbação estimada (÷ 1 + d)
+        float pvDelay   = 0.5f;    // s, atraso da PV (média do bloco, DecimationFilter)
+    };
+
+    MpcController() = default;
+    explicit MpcController(const Params& p) : p_(p) {}
+
+    void setEnabled(bool en);
+    bool enabled() const { return enabled_; }
+
+    /** Nova decisão (a cada p.dt).
+     *  @param sp       set-point da etapa atual (°C)
+     *  @param spNext   set-point da próxima etapa (°C; < −273, ex. tempToC(TEMP_INVALID), se não houver)
+     *  @param pv       temperatura atual (°C)
+     *  @param secLeft  segundos restantes do patamar atual
+     *  @param holding  true enquanto o cronômetro do patamar está correndo
+     *  @param m        modelo térmico
+     *  @return duty (0..1) até a próxima decisão                       */
+    float update(float sp, float spNext, float pv, int32_t secLeft, bool holding,
+                 const ThermalModel& m);
+
+    float duty() const        { return u_[0]; }
+    float disturbance() const { return dist_; }      // °C por amostra
+    /** Temperatura prevista ao fim do horizonte (última decisão). */
+    float predictedEnd() const { return tEnd_; }
+
+private:
+    float cost(int N, int M, const int start[], float dt, float uPrev) const;
+
+    Params p_{};
+    float  u_[MAX_BLOCKS]    = {};   // plano (início a quente)
+    float  uHist_[MAX_DELAY] = {};   // duty aplicado (circular)
+    int    uHead_ = 0;
+    float  phi_[MAX_HORIZON][MAX_BLOCKS];   // resposta a cada bloco (fora da pilha)
+    float  err_[MAX_HORIZON];
+    float  ref_[MAX_HORIZON];
+    float  x_       = 0.0f;   // estado estimado no instante da decisão
+    float  dist_    = 0.0f;
+    float  tEnd_    = 0.0f;
+    bool   hasLast_ = false;
+    bool   enabled_ = false;
+};
@@ -0,0 +1,65 @@
+#include "OverTempGuard.hpp"
+#include <math.h>
+
+void OverTempGuard::setCurve(const centi_t temps[], int count)
+{
+    float lim = p_.absMax;
+    if (count > 0) {
+        centi_t hi = temps[0];
+        for (int i = 1; i < count; ++i)
+            if (temps[i] > hi) hi = temps[i];
+        if (tempToC(hi) + p_.margin < lim) lim = tempToC(hi) + p_.margin;
+    }
+    limit_ = lim;
+}
+
+void OverTempGuard::trip(Trip why, float t, uint32_t sinceUs)
+{
+    if (tripped_) return;
+    tripped_ = true;
+    off_();                                   // primeiro desliga, depois registra
+    latency_  = clock_() - sinceUs;
+    reason_   = why;
+    tripTemp_ = t;
+    ++trips_;
+}
+
+void OverTempGuard::sample(int src, float t, uint32_t nowUs)
+{
+    lastT_  = t;
+    lastOk_ = nowUs;
+    if (src < 0 || src >= MAX_SRC) src = 0;
+    // sem anterior (partida, sonda nova) vale como plausível: lado seguro
+    const float dt   = (nowUs - prevAt_[src]) * 1e-6f;
+    const float d    = t - prevT_[src];
+    const bool  ok   = !seen_[src] || fabsf(d) <= p_.jump + p_.maxSlope * dt;
+    // ruído pela segunda diferença: a rampa da planta não entra em σ
+    if (seen_[src] && ok) {
+        const float dd = d - prevD_[src];
+        var_[src] += p_.noiseAlpha * (dd * dd / 6.0f - var_[src]);
+    }
+    prevD_[src]  = seen_[src] && ok ? d : 0.0f;
+    prevT_[src]  = t;
+    prevAt_[src] = nowUs;
+    seen_[src]   = true;
+    if (t <= limit_) { over_[src] = 0; return; }
+    if (over_[src] == 0) overAt_[src] = nowUs;
+    if (over_[src] < 255) ++over_[src];
+    const bool clear = ok && t > limit_ + p_.noiseK * sqrtf(var_[src]);
+    if (clear || over_[src] >= p_.confirm) trip(TRIP_OVERTEMP, t, overAt_[src]);
+}
+
+void OverTempGuard::poll(uint32_t nowUs)
+{
+    const uint32_t since = lastOk_;
+    if (nowUs - since > p_.timeoutUs) trip(TRIP_TIMEOUT, lastT_, since + p_.timeoutUs);
+}
+
+bool OverTempGuard::clear(uint32_t nowUs)
+{
+    if (nowUs - lastOk_ > p_.timeoutUs) return false;
+    if (lastT_ > limit_ - p_.clearHyst)  return false;
+    reason_  = TRIP_NONE;
+    tripped_ = false;
+    return true;
+}
@@ -0,0 +1,110 @@
+/*  OverTempGuard.hpp
+ *  -------------------------------------------------------------
+ *  Corte de segurança do aquecedor (RNF-09), fora do statechart e
+ *  das tasks de controle:
+ *
+ *   • sample(): chamado a cada leitura nova de sonda, crua (só
+ *     calibrada: um valor alto que o ProbeGuard recusaria como salto
+ *     pode ser a tina de verdade), no I2CTask logo após o I²C;
+ *     uma leitura acima do limite desliga a saída ali mesmo, sem
+ *     esperar a seguinte, quando é alcançável a partir da anterior
+ *     da mesma sonda (salto ≤ jump + maxSlope·dt) e passa do limite
+ *     por mais que noiseK·σ (σ da própria sonda, da segunda diferença
+ *     entre leituras seguidas, sem a rampa; sem ruído, a primeira
+ *     leitura acima corta).
+ *     Salto implausível (bit trocado) ou leitura dentro do ruído do
+ *     limite só corta com confirm leituras seguidas acima. Latência
+ *     (leitura que decide → retorno de off) é só a chamada; da
+ *     primeira leitura acima, no máximo (confirm − 1) períodos de
+ *     leitura (100 ms a 20 leituras/s);
+ *   • poll(): chamado por um timer periódico (esp_timer, alguns ms);
+ *     sem leitura válida por timeoutUs, desliga a saída.
+ *
+ *  Limite = etapa mais quente da curva + margin (RF-07: Max + 2 °C),
+ *  limitado a absMax
+ *  (absMax também vale sem curva). O corte fica travado até clear(),
+ *  que só rearma com leitura recente abaixo de limite − clearHyst.
+ *
+ *  A ação de corte (off) deve ser idempotente e segura de qualquer
+ *  task: sample() e poll() rodam em núcleos diferentes e, no pior
+ *  caso, ambos a chamam uma vez.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "Temperature.hpp"
+
+class OverTempGuard {
+public:
+    enum Trip : uint8_t { TRIP_NONE = 0, TRIP_OVERTEMP = 1, TRIP_TIMEOUT = 2 };
+
+    struct Params {
+        float    margin    = 2.0f;       // °C acima da etapa mais quente (RF-07)
+        float    absMax    = 100.0f;     // °C, teto do limite (e limite sem curva)
+        float    clearHyst = 2.0f;       // °C abaixo do limite para rearmar
+        uint32_t timeoutUs = 3000000;    // sem leitura válida (3 amostras a 1 Hz)
+        float    maxSlope  = 7.5f;       // °C/s plausível (2·G do modelo padrão)
+        float    jump      = 2.0f;       // °C além de maxSlope·dt (ruído, LSB)
+        float    noiseK    = 3.0f;       // corte imediato só noiseK·σ acima do limite
+        float    noiseAlpha = 0.01f;     // média de (Δ²)²/6 por leitura (~5 s a 20/s)
+        uint8_t  confirm   = 3;          // leituras seguidas acima (salto ou no ruído)
+    };
+
+    static constexpr int MAX_SRC = 16;   // = SensorRegistry::MAX_SENSORS
+
+    using Action = void (*)();           // desliga o aquecedor
+    using Clock  = uint32_t (*)();       // µs, para medir a latência do corte
+
+    OverTempGuard(Action off, Clock clock) : off_(off), clock_(clock) {}
+    OverTempGuard(Action off, Clock clock, const Params& p)
+        : p_(p), off_(off), clock_(clock) {}
+
+    /** Começa a contar o timeout (sem leitura desde a partida também corta). */
+    void arm(uint32_t nowUs) { lastOk_ = nowUs; }
+
+    /** Etapa mais quente da receita (centésimos); count = 0 ⇒ só absMax. */
+    void setCurve(const centi_t temps[], int count);
+    float limit() const { return limit_; }
+    /** Inclinação plausível da planta (°C/s), do modelo identificado. */
+    void setMaxSlope(float cPerS) { if (cPerS > 0.0f) p_.maxSlope = cPerS; }
+
+    /** Leitura válida da sonda src, lida em nowUs. */
+    void sample(int src, float t, uint32_t nowUs);
+    /** Verificação periódica do timeout. */
+    void poll(uint32_t nowUs);
+    /** Rearma; false se a condição de corte continua. */
+    bool clear(uint32_t nowUs);
+
+    bool     tripped()   const { return tripped_; }
+    Trip     reason()    const { return static_cast<Trip>(reason_); }
+    float    tripTemp()  const { return tripTemp_; }     // leitura que cortou (°C)
+    float    lastTemp()  const { return lastT_; }
+    /** µs entre a primeira leitura acima (ou o fim do timeout) e o
+     *  retorno da ação de corte. */
+    uint32_t latencyUs() const { return latency_; }
+    uint32_t trips()     const { return trips_; }
+
+private:
+    void trip(Trip why, float t, uint32_t sinceUs);
+
+    Params p_{};
+    Action off_;
+    Clock  clock_;
+    volatile float    limit_    = p_.absMax;
+    volatile uint32_t lastOk_   = 0;
+    volatile float    lastT_    = 0.0f;
+    volatile bool     tripped_  = false;
+    volatile uint8_t  reason_   = TRIP_NONE;
+    float    tripTemp_ = 0.0f;
+    uint32_t latency_  = 0;
+    uint32_t trips_    = 0;
+    uint8_t  over_[MAX_SRC]   = {};    // leituras seguidas acima do limite
+    float    prevT_[MAX_SRC]  = {};    // leitura anterior da sonda (°C)
+    uint32_t prevAt_[MAX_SRC] = {};    // µs dela
+    float    prevD_[MAX_SRC]  = {};    // diferença anterior (°C)
+    float    var_[MAX_SRC]    = {};    // σ² por leitura (°C²)
+    bool     seen_[MAX_SRC]   = {};    // já houve leitura anterior
+    uint32_t overAt_[MAX_SRC] = {};    // µs da primeira delas
+};
@@ -0,0 +1,33 @@
+#include "PreheatLookahead.hpp"
+
+/* ---------- estimador da taxa de aquecimento ---------- */
+void PreheatLookahead::updateRate(float pv, float dutyFrac, float dt)
+{
+    if (hasLast_ && dt > 0.0f && dutyFrac >= p_.fullDuty) {
+        float slope = (pv - lastPv_) / dt;
+        rate_ += p_.rateAlpha * (slope - rate_);
+        if (rate_ < p_.rateMin) rate_ = p_.rateMin;
+        if (rate_ > p_.rateMax) rate_ = p_.rateMax;
+    }
+    lastPv_  = pv;
+    hasLast_ = true;
+}
+
+float PreheatLookahead::rampTime(float from, float to) const
+{
+    return (to > from) ? (to - from) / rate_ : 0.0f;
+}
+
+/* ---------- set-point antecipado ---------- */
+float PreheatLookahead::controlSetPoint(float sp, float spNext, float pv,
+                                        int32_t secLeft, bool holding) const
+{
+    if (!enabled_ || !holding || spNext <= sp) return sp;
+
+    // mira dentro da banda da etapa atual
+    const float top = sp + p_.band - p_.bandMargin;
+    float target = (spNext < top) ? spNext : top;
+    float lead   = p_.follow * rampTime(pv, target) + p_.margin;
+
+    return (static_cast<float>(secLeft) <= lead) ? target : sp;
+}
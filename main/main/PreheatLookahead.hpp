@@ -0,0 +1,74 @@
+/*  PreheatLookahead.hpp
+ *  -------------------------------------------------------------
+ *  Pré-aquecimento antecipado da próxima etapa da curva.
+ *
+ *  Durante o final do patamar N o set-point de controle é elevado
+ *  para dentro da banda, até sp + band − bandMargin (RNF-04), quando
+ *  a etapa N+1 é mais quente, de forma que o tanque chegue ao fim do
+ *  patamar perto da borda da banda, sem encostar nela (o sobressinal
+ *  do PID sobre o set-point antecipado ainda cabe), e com o aquecedor
+ *  em regime.
+ *  O instante de início é calculado a partir de uma estimativa
+ *  online da taxa de aquecimento (°C/s a plena potência). O degrau
+ *  antecipado é menor que a banda do anti-windup e o PID (integral
+ *  dominante) o segue sem saturar, bem mais devagar que a plena
+ *  potência: a antecipação é `follow` vezes o tempo da rampa (~4 min
+ *  para 0,75 °C na tina, segundos na slave).
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+
+class PreheatLookahead {
+public:
+    struct Params {
+        float band       = 1.0f;   // °C acima do set-point permitido (RNF-04)
+        float rateInit   = 0.02f;  // °C/s a plena potência (chute inicial)
+        float rateMin    = 0.001f; // limites da estimativa
+        float rateMax    = 10.0f;
+        float rateAlpha  = 0.05f;  // peso de cada nova amostra no filtro
+        float fullDuty   = 0.95f;  // fração de duty considerada "plena"
+        float follow     = 8.0f;   // × tempo a plena potência até o PID seguir
+        float margin     = 5.0f;   // s de folga na antecipação
+        float bandMargin = 0.25f;  // °C abaixo da borda da banda
+    };
+
+    PreheatLookahead() = default;
+    explicit PreheatLookahead(const Params& p) : p_(p), rate_(p.rateInit) {}
+
+    void setEnabled(bool en) { enabled_ = en; }
+    bool enabled() const     { return enabled_; }
+
+    /** Alimenta o estimador de taxa (chamar a cada nova leitura).
+     *  @param pv        temperatura medida (°C)
+     *  @param dutyFrac  duty aplicado no intervalo (0..1)
+     *  @param dt        intervalo desde a última chamada (s)          */
+    void updateRate(float pv, float dutyFrac, float dt);
+
+    /** Taxa de aquecimento estimada a plena potência (°C/s). */
+    float heatRate() const { return rate_; }
+
+    /** °C acima do set-point no fim do patamar (0 se desligado). */
+    float lift() const { return enabled_ ? p_.band - p_.bandMargin : 0.0f; }
+
+    /** Tempo previsto (s) para subir de `from` até `to` a plena potência. */
+    float rampTime(float from, float to) const;
+
+    /** Set-point a ser entregue ao controlador.
+     *  @param sp       set-point da etapa atual (°C)
+     *  @param spNext   set-point da próxima etapa (°C) ou <= sp se não houver
+     *  @param pv       temperatura atual (°C)
+     *  @param secLeft  segundos restantes do patamar atual
+     *  @param holding  true enquanto o cronômetro do patamar está correndo */
+    float controlSetPoint(float sp, float spNext, float pv,
+                          int32_t secLeft, bool holding) const;
+
+private:
+    Params p_{};
+    float  rate_    = Params{}.rateInit;
+    float  lastPv_  = 0.0f;
+    bool   hasLast_ = false;
+    bool   enabled_ = false;
+};
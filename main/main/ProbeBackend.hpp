@@ -0,0 +1,43 @@
+/*  ProbeBackend.hpp
+ *  -------------------------------------------------------------
+ *  De onde vêm as leituras das sondas do I2CTask. Duas
+ *  implementações:
+ *
+ *   I2cProbeBackend  barramento real (I2cAcquisition): leituras
+ *                    enfileiradas de uma vez, conclusão por
+ *                    interrupção;
+ *   SimProbeBackend  planta térmica simulada dentro do firmware
+ *                    (ThermalModel com tempo morto, inércia da sonda,
+ *                    estratificação e ruído), alimentada pelo duty do
+ *                    aquecedor — malha fechada numa placa só, sem o
+ *                    escravo de teste, ou no host.
+ *
+ *  O resto da aquisição (ProbeDriver, calibração, ProbeGuard, corte,
+ *  filtro) não muda: cada leitura chega como os 2 bytes Q8.8 da
+ *  sonda, ou sem dados se falhou.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ProbeDriver.hpp"
+
+class ProbeBackend {
+public:
+    /** Conclusão de uma leitura: `data` com os bytes da sonda, ou
+     *  nullptr se falhou; atUs = instante da conclusão. */
+    using Done = void (*)(int dev, const uint8_t* data, uint8_t len, uint32_t atUs, void* arg);
+
+    virtual ~ProbeBackend() {}
+
+    /** Como ler a sonda `dev` (ponteiro, disparo da conversão). Só
+     *  entre ciclos. */
+    virtual void configure(int dev, const ProbeDriver& d) { (void)dev; (void)d; }
+    /** Um ciclo: lê as sondas de `mask` (bit = índice do
+     *  SensorRegistry) e chama `done` para cada uma antes de voltar. */
+    virtual void read(uint32_t mask, Done done, void* arg) = 0;
+    /** Duty aplicado ao aquecedor (0..1); só o simulado usa. */
+    virtual void heater(float duty) { (void)duty; }
+    virtual const char* name() const = 0;
+};
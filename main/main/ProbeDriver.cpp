@@ -0,0 +1,60 @@
+#include "ProbeDriver.hpp"
+
+static constexpr uint32_t TMP75_CONV_US[] = { 37500, 75000, 150000, 300000 };   // 9..12 bits
+static constexpr uint32_t LM75_CONV_US    = 100000;
+static constexpr uint8_t  Q8_8_BITS       = 16;     // escravo de teste: 1/256 °C
+
+uint32_t ProbeDriver::convTimeUs(SensorType type, uint8_t bits)
+{
+    switch (type) {
+    case SENSOR_TMP75:
+        if (bits < MIN_BITS) bits = MIN_BITS;
+        if (bits > MAX_BITS) bits = MAX_BITS;
+        return TMP75_CONV_US[bits - MIN_BITS];
+    case SENSOR_LM75:
+        return LM75_CONV_US;
+    default:
+        return 0;
+    }
+}
+
+void ProbeDriver::configure(SensorType type, uint8_t bitsReq, uint32_t periodUs)
+{
+    if (type != type_) restart();
+    type_ = type;
+    if (type == SENSOR_TMP75) {
+        if (bitsReq == 0) {
+            // a maior resolução que converte dentro de um período
+            bits_ = MIN_BITS;
+            while (bits_ < MAX_BITS && convTimeUs(type, bits_ + 1) <= periodUs) ++bits_;
+        } else {
+            bits_ = bitsReq < MIN_BITS ? MIN_BITS : bitsReq > MAX_BITS ? MAX_BITS : bitsReq;
+        }
+    } else {
+        bits_ = (type == SENSOR_LM75) ? MIN_BITS : Q8_8_BITS;
+    }
+    convUs_ = convTimeUs(type, bits_);
+    const uint32_t n = periodUs ? (convUs_ + periodUs - 1) / periodUs : 1;
+    every_  = static_cast<uint8_t>(n < 1 ? 1 : n > 255 ? 255 : n);
+    if (phase_ >= every_) phase_ = every_ - 1;
+}
+
+ProbeDriver::Step ProbeDriver::step()
+{
+    if (phase_ > 0) {
+        --phase_;
+        return STEP_IDLE;
+    }
+    phase_ = every_ - 1;
+    if (oneShot() && !primed_) {
+        primed_ = true;
+        return STEP_PRIME;
+    }
+    return STEP_READ;
+}
+
+uint8_t ProbeDriver::trigger() const
+{
+    // OS = 1 (dispara), R1:R0 = resolução, SD = 1 (desliga ao fim)
+    return static_cast<uint8_t>(0x81 | ((bits_ - MIN_BITS) << 5));
+}
@@ -0,0 +1,73 @@
+/*  ProbeDriver.hpp
+ *  -------------------------------------------------------------
+ *  Como ler cada tipo de sonda sem esperar a conversão: o I2CTask
+ *  nunca bloqueia pelo tempo de conversão do sensor, só pelo tempo
+ *  de barramento.
+ *
+ *   TMP75/TMP175 (e o TMP1075, que aceita o mesmo byte alto de
+ *   configuração): modo one-shot com o sensor desligado entre
+ *   conversões. Cada leitura devolve a conversão disparada na leitura
+ *   anterior e logo em seguida dispara a próxima (byte de configuração
+ *   com OS = 1, SD = 1). Resolução de 9 a 12 bits, trocando passo por
+ *   tempo de conversão (máx. do datasheet):
+ *       9 bits 0,5 °C 37,5 ms | 10 bits 0,25 °C 75 ms
+ *      11 bits 0,125 °C 150 ms | 12 bits 0,0625 °C 300 ms
+ *   LM75: conversão contínua de 9 bits (~100 ms), sem one-shot; ler
+ *   mais rápido só repete o valor, então lê uma vez por conversão.
+ *   Escravo de teste: responde na hora, lido a cada ciclo.
+ *
+ *  Com conversão mais longa que o período da aquisição, a sonda é
+ *  lida (e a conversão disparada) a cada `every()` ciclos; nos outros
+ *  fica parada (STEP_IDLE) e o filtro decimador repete a última.
+ *  Resolução pedida 0 = a maior cuja conversão cabe num período.
+ *
+ *  A primeira leitura de um sensor one-shot (STEP_PRIME) só dispara:
+ *  o registrador pode ter a conversão de antes de um reset do ESP32.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "SensorRegistry.hpp"
+
+class ProbeDriver {
+public:
+    static constexpr uint8_t REG_TEMP   = 0x00;
+    static constexpr uint8_t REG_CONFIG = 0x01;
+    static constexpr uint8_t MIN_BITS   = 9;
+    static constexpr uint8_t MAX_BITS   = 12;
+
+    enum Step : uint8_t { STEP_IDLE, STEP_PRIME, STEP_READ };
+
+    /** Tipo do sensor, resolução pedida (0 = automática) e período da
+     *  aquisição. Mantém a fase: trocar a resolução não perde leitura. */
+    void configure(SensorType type, uint8_t bitsReq, uint32_t periodUs);
+    /** Volta a descartar a primeira leitura (sensor religado). */
+    void restart() { primed_ = false; phase_ = 0; }
+
+    /** O que fazer neste ciclo (avança a fase). */
+    Step step();
+
+    bool     oneShot()    const { return type_ == SENSOR_TMP75; }
+    /** Escrever o ponteiro REG_TEMP antes de ler (o disparo o move). */
+    bool     setPointer() const { return oneShot(); }
+    /** Byte de configuração que dispara a próxima conversão. */
+    uint8_t  trigger()    const;
+    uint8_t  bits()       const { return bits_; }
+    uint32_t convUs()     const { return convUs_; }
+    uint8_t  every()      const { return every_; }
+    /** Passo da leitura em °C. */
+    float    lsbC()       const { return 0.5f / static_cast<float>(1u << (bits_ - MIN_BITS)); }
+
+    /** Tempo máximo de conversão do tipo na resolução dada. */
+    static uint32_t convTimeUs(SensorType type, uint8_t bits);
+
+private:
+    SensorType type_   = SENSOR_SLAVE_SIM;
+    uint8_t    bits_   = MIN_BITS;
+    uint32_t   convUs_ = 0;
+    uint8_t    every_  = 1;
+    uint8_t    phase_  = 0;        // ciclos desde a última leitura
+    bool       primed_ = false;    // one-shot já disparado uma vez
+};
@@ -0,0 +1,97 @@
+#include "ProbeGuard.hpp"
+
+static int32_t toCenti(float c) { return static_cast<int32_t>(c * TEMP_SCALE + (c < 0 ? -0.5f : 0.5f)); }
+static int32_t absDiff(int32_t a, int32_t b) { return a > b ? a - b : b - a; }
+
+void ProbeGuard::configure(const Params& p)
+{
+    p_ = p;
+    if (p_.decay < 1)  p_.decay = 1;
+    if (p_.decay > 12) p_.decay = 12;
+    minX_   = toCenti(p_.minC);
+    maxX_   = toCenti(p_.maxC);
+    margin_ = toCenti(p_.margin);
+    setMaxSlope(p_.maxSlope);
+    reset();
+}
+
+void ProbeGuard::setMaxSlope(float cPerS)
+{
+    if (cPerS < 0) cPerS = 0;
+    p_.maxSlope = cPerS;
+    slopeStep_  = toCenti(cPerS * p_.dt);
+    tolSpike_   = margin_ + slopeStep_ * (WINDOW / 2);
+}
+
+void ProbeGuard::reset()
+{
+    head_    = 0;
+    n_       = 0;
+    ref_     = TEMP_INVALID;
+    gap_     = 0;
+    confirm_ = 0;
+}
+
+void ProbeGuard::resetCounters()
+{
+    for (uint32_t& c : count_) c = 0;
+}
+
+/* ordenação por inserção de no máx. WINDOW valores */
+centi_t ProbeGuard::median() const
+{
+    centi_t v[WINDOW];
+    for (uint8_t i = 0; i < n_; ++i) {
+        centi_t x = win_[i];
+        uint8_t j = i;
+        for (; j > 0 && v[j - 1] > x; --j) v[j] = v[j - 1];
+        v[j] = x;
+    }
+    return v[n_ / 2];
+}
+
+void ProbeGuard::score(bool good)
+{
+    if (good) score_ += ((100u << 8) - score_) >> p_.decay;
+    else      score_ -= score_ >> p_.decay;
+    const uint8_t h = health();
+    if (healthy_ && h < p_.unhealthyAt) healthy_ = false;
+    if (!healthy_ && h >= p_.healthyAt) healthy_ = true;
+}
+
+centi_t ProbeGuard::sample(centi_t x)
+{
+    if (gap_ < UINT32_MAX) ++gap_;
+
+    Verdict v   = ACCEPTED;
+    centi_t med = x;
+    if (x == TEMP_INVALID) {
+        v = MISSED;
+    } else if (x < minX_ || x > maxX_) {
+        v = REJ_RANGE;
+    } else {
+        win_[head_] = x;
+        head_ = static_cast<uint8_t>((head_ + 1) % WINDOW);
+        if (n_ < WINDOW) ++n_;
+
+        // mediana só com janela suficiente para ter maioria
+        if (n_ > WINDOW / 2) med = median();
+        if (absDiff(x, med) > tolSpike_) {
+            v = REJ_SPIKE;
+            confirm_ = 0;
+        } else if (ref_ != TEMP_INVALID &&
+                   absDiff(x, ref_) > margin_ + static_cast<int64_t>(slopeStep_) * gap_) {
+            // salto sem mediana contra: só um patamar confirmado passa
+            if (++confirm_ < WINDOW) v = REJ_SLOPE;
+        }
+    }
+
+    last_ = v;
+    ++count_[v];
+    score(v == ACCEPTED);
+    if (v != ACCEPTED) return TEMP_INVALID;
+    ref_     = med;
+    gap_     = 0;
+    confirm_ = 0;
+    return x;
+}
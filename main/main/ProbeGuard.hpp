@@ -0,0 +1,95 @@
+/*  ProbeGuard.hpp
+ *  -------------------------------------------------------------
+ *  Rejeição robusta de leituras espúrias de uma sonda (ruído no
+ *  barramento, byte trocado/parcial), antes do filtro decimador e do
+ *  controle (o corte de segurança vê a leitura crua enquanto a sonda
+ *  tem saúde). Uma leitura é recusada quando:
+ *
+ *   • está fora da faixa física (minC…maxC);
+ *   • se afasta da mediana das últimas WINDOW leituras na faixa
+ *     (incluída ela) mais que margin + maxSlope·dt·WINDOW/2: pico
+ *     isolado (até WINDOW/2 leituras seguidas);
+ *   • se afasta do nível da sonda na última aceita (mediana da janela
+ *     naquele instante, menos ruidosa que uma leitura) mais que
+ *     margin + maxSlope·(tempo desde ela): salto implausível para a
+ *     planta. maxSlope vem do modelo (setMaxSlope). Um patamar novo
+ *     confirmado por WINDOW leituras seguidas que passam pela mediana
+ *     é aceito (sonda recolocada, retorno após muito tempo sem leitura).
+ *
+ *  Saúde: média exponencial (peso 2^−decay por leitura) de leituras
+ *  aceitas x recusadas ou perdidas, em %. healthy() tem histerese
+ *  (cai abaixo de unhealthyAt, volta acima de healthyAt); é o que o
+ *  I2CTask usa para tirar a sonda do controle e passar para a outra.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "Temperature.hpp"
+
+class ProbeGuard {
+public:
+    static constexpr uint8_t WINDOW = 5;          // leituras na mediana (ímpar)
+
+    enum Verdict : uint8_t { ACCEPTED, MISSED, REJ_RANGE, REJ_SPIKE, REJ_SLOPE };
+
+    struct Params {
+        float   dt          = 0.05f;    // s entre leituras
+        float   minC        = -20.0f;   // °C, faixa física aceita
+        float   maxC        = 125.0f;
+        float   maxSlope    = 7.5f;     // °C/s plausível (2·G do modelo padrão)
+        float   margin      = 1.5f;     // °C de ruído em torno do previsto
+        uint8_t decay       = 5;        // saúde: peso 2^−decay por leitura
+        uint8_t healthyAt   = 80;       // %, volta a ser usada
+        uint8_t unhealthyAt = 40;       // %, sai do controle
+    };
+
+    ProbeGuard() { configure(Params{}); }
+    explicit ProbeGuard(const Params& p) { configure(p); }
+
+    /** Troca os parâmetros e esquece o histórico (saúde e contadores ficam). */
+    void configure(const Params& p);
+    /** Inclinação máxima plausível (°C/s), p.ex. 2·heatGain do modelo. */
+    void setMaxSlope(float cPerS);
+    /** Esquece o histórico de leituras. */
+    void reset();
+
+    /** Leitura crua (TEMP_INVALID = perdida). @return a própria leitura
+     *  se aceita, senão TEMP_INVALID. */
+    centi_t sample(centi_t x);
+
+    Verdict  lastVerdict() const { return last_; }
+    uint8_t  health()      const { return static_cast<uint8_t>((score_ + 128) >> 8); }
+    bool     healthy()     const { return healthy_; }
+
+    uint32_t accepted()     const { return count_[ACCEPTED]; }
+    uint32_t missed()       const { return count_[MISSED]; }
+    uint32_t rejRange()     const { return count_[REJ_RANGE]; }
+    uint32_t rejSpike()     const { return count_[REJ_SPIKE]; }
+    uint32_t rejSlope()     const { return count_[REJ_SLOPE]; }
+    uint32_t rejected()     const { return rejRange() + rejSpike() + rejSlope(); }
+    void     resetCounters();
+
+private:
+    centi_t median() const;
+    void    score(bool good);
+
+    Params   p_{};
+    int32_t  minX_ = 0, maxX_ = 0;     // faixa em centésimos
+    int32_t  tolSpike_ = 0;            // centésimos
+    int32_t  margin_   = 0;            // centésimos
+    int32_t  slopeStep_ = 0;           // centésimos por leitura (maxSlope·dt)
+
+    centi_t  win_[WINDOW] = {};
+    uint8_t  head_  = 0;
+    uint8_t  n_     = 0;
+    centi_t  ref_    = TEMP_INVALID;   // mediana na última aceita
+    uint32_t gap_    = 0;              // leituras desde a última aceita
+    uint8_t  confirm_ = 0;             // seguidas que passam pela mediana e não pela inclinação
+
+    uint16_t score_   = 100u << 8;     // saúde em % com 8 bits de fração
+    bool     healthy_ = true;
+    Verdict  last_    = ACCEPTED;
+    uint32_t count_[REJ_SLOPE + 1] = {};
+};
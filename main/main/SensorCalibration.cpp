@@ -0,0 +1,113 @@
+#include "SensorCalibration.hpp"
+#include <math.h>
+
+static constexpr int32_t GRID_MAX = SensorCalibration::GRID_MIN +
+    ((SensorCalibration::GRID_N - 1) << SensorCalibration::GRID_SHIFT);
+
+bool SensorCalibration::addPoint(centi_t raw, centi_t ref)
+{
+    if (raw < GRID_MIN || raw > GRID_MAX || ref == TEMP_INVALID) return false;
+    // os a menos de MERGE saem (no máx. um ponto por célula da grade)
+    int m = 0;
+    for (int i = 0; i < n_; ++i) {
+        const int d = p_[i].raw > raw ? p_[i].raw - raw : raw - p_[i].raw;
+        if (d >= MERGE) p_[m++] = p_[i];
+    }
+    n_ = static_cast<uint8_t>(m);
+    int k = -1, best = 0;
+    for (int i = 0; i < n_; ++i) {
+        const int d = p_[i].raw > raw ? p_[i].raw - raw : raw - p_[i].raw;
+        if (k < 0 || d < best) { k = i; best = d; }
+    }
+    if (n_ < MAX_POINTS) k = n_++;
+    p_[k] = { raw, ref };
+    // mantém ordenado por raw (inserção)
+    for (int i = 1; i < n_; ++i)
+        for (int j = i; j > 0 && p_[j].raw < p_[j - 1].raw; --j) {
+            const CalPoint t = p_[j]; p_[j] = p_[j - 1]; p_[j - 1] = t;
+        }
+    build();
+    return true;
+}
+
+void SensorCalibration::load(const CalPoint* p, int n)
+{
+    n_ = 0;
+    for (int i = 0; i < n && i < MAX_POINTS; ++i) addPoint(p[i].raw, p[i].ref);
+    build();
+}
+
+void SensorCalibration::build()
+{
+    for (int i = 0, k = 0; i < GRID_N; ++i) {
+        const int32_t x = GRID_MIN + (i << GRID_SHIFT);
+        while (k < n_ && p_[k].raw < x) ++k;
+        seg_[i] = static_cast<uint8_t>(k);
+    }
+    for (int k = 0; k <= n_; ++k) {
+        off_[k] = slope_[k] = 0;
+        x0_[k]  = 0;
+        if (n_ == 0) continue;
+        const int a = k > 0 ? k - 1 : 0;               // origem do trecho
+        const int32_t o0 = p_[a].ref - p_[a].raw;
+        off_[k] = o0;
+        x0_[k]  = p_[a].raw;
+        if (k == 0 || k == n_) continue;               // fora dos extremos: constante
+        const int64_t num = static_cast<int64_t>(p_[k].ref - p_[k].raw - o0) * 65536;
+        const int64_t dx  = p_[k].raw - p_[a].raw;
+        slope_[k] = static_cast<int32_t>(num >= 0 ? (2 * num + dx) / (2 * dx) : -((-2 * num + dx) / (2 * dx)));
+    }
+}
+
+void CalibrationCapture::begin(uint32_t samples)
+{
+    *this = CalibrationCapture();
+    target_ = samples ? samples : 1;
+}
+
+void CalibrationCapture::add(centi_t raw)
+{
+    if (!active()) return;
+    if (raw == TEMP_INVALID) { miss(); return; }
+    if (n_ + missed_ >= target_) return;
+    sum_   += raw;
+    sumSq_ += static_cast<int64_t>(raw) * raw;
+    if (n_ + missed_ < target_ / 2) { sumHalf_ += raw; ++nHalf_; }
+    ++n_;
+}
+
+void CalibrationCapture::miss()
+{
+    if (active() && n_ + missed_ < target_) ++missed_;
+}
+
+CalibrationCapture::Result CalibrationCapture::result() const
+{
+    if (n_ + missed_ < target_) return CAP_RUNNING;
+    if (n_ < target_ / 2 || nHalf_ == 0 || nHalf_ == n_) return CAP_NO_DATA;
+    if (sd() > MAX_SD || fabsf(drift()) > MAX_DRIFT) return CAP_UNSTABLE;
+    return CAP_DONE;
+}
+
+centi_t CalibrationCapture::mean() const
+{
+    if (!n_) return TEMP_INVALID;
+    const int64_t s = sum_ >= 0 ? sum_ + n_ / 2 : sum_ - n_ / 2;
+    return static_cast<centi_t>(s / static_cast<int64_t>(n_));
+}
+
+float CalibrationCapture::sd() const
+{
+    if (n_ < 2) return 0.0f;
+    const double m   = static_cast<double>(sum_) / n_;
+    const double var = static_cast<double>(sumSq_) / n_ - m * m;
+    return var > 0 ? static_cast<float>(sqrt(var)) / TEMP_SCALE : 0.0f;
+}
+
+float CalibrationCapture::drift() const
+{
+    if (nHalf_ == 0 || nHalf_ == n_) return 0.0f;
+    const double a = static_cast<double>(sumHalf_) / nHalf_;
+    const double b = static_cast<double>(sum_ - sumHalf_) / (n_ - nHalf_);
+    return static_cast<float>(b - a) / TEMP_SCALE;
+}
@@ -0,0 +1,118 @@
+/*  SensorCalibration.hpp
+ *  -------------------------------------------------------------
+ *  Calibração por sonda: até MAX_POINTS pares (leitura crua, valor
+ *  de referência), e entre eles a correção é linear por partes. Fora
+ *  dos pontos extremos vale a correção do ponto mais próximo (um
+ *  ponto só = deslocamento constante; nenhum = sem correção).
+ *
+ *  Os pontos não são percorridos na leitura: ao mudar (carga da NVS,
+ *  ponto novo, limpeza) build() guarda, para cada célula de uma grade
+ *  fixa de GRID_N nós (de GRID_MIN em passos de 2^GRID_SHIFT
+ *  centésimos: 2,56 °C, de −10,24 a 122,88 °C), o trecho em que ela
+ *  começa, e para cada trecho a correção na origem e a inclinação em
+ *  Q16. Pontos a menos de um passo se substituem (MERGE), então uma
+ *  célula tem no máx. um ponto: por leitura, apply() faz um
+ *  deslocamento para achar a célula, uma comparação para o trecho e
+ *  uma multiplicação — custo fixo, sem busca nem divisão. Nos pontos
+ *  a correção é exata; entre eles fica a ≤ 0,01 °C da reta (só
+ *  arredondamento).
+ *
+ *  CalibrationCapture ajusta um ponto contra uma leitura de
+ *  referência (banho termostático, termômetro padrão): média das
+ *  leituras cruas de uma janela, recusada se a sonda não estava
+ *  estável (desvio-padrão alto ou deriva entre as metades).
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "Temperature.hpp"
+
+struct CalPoint {
+    centi_t raw;         // leitura da sonda
+    centi_t ref;         // valor de referência
+};
+
+class SensorCalibration {
+public:
+    static constexpr int     MAX_POINTS = 6;
+    static constexpr centi_t GRID_MIN   = -1024;       // −10,24 °C
+    static constexpr int     GRID_SHIFT = 8;           // passo de 256 centésimos
+    static constexpr int     GRID_N     = 53;          // até 122,88 °C
+    static constexpr centi_t MERGE      = 1 << GRID_SHIFT;   // ponto a menos de 2,56 °C substitui
+
+    /** Leitura crua → corrigida (célula + trecho + uma multiplicação). */
+    centi_t apply(centi_t raw) const
+    {
+        if (n_ == 0 || raw == TEMP_INVALID) return raw;
+        int32_t x = static_cast<int32_t>(raw) - GRID_MIN;
+        if (x < 0) x = 0;
+        int i = x >> GRID_SHIFT;
+        if (i > GRID_N - 1) i = GRID_N - 1;
+        int k = seg_[i];
+        if (k < n_ && raw >= p_[k].raw) ++k;             // o ponto desta célula
+        const int64_t d = static_cast<int64_t>(slope_[k]) * (raw - x0_[k]);
+        const int32_t y = raw + off_[k] + static_cast<int32_t>(d >= 0 ? (d + 0x8000) >> 16
+                                                                      : -((-d + 0x8000) >> 16));
+        return static_cast<centi_t>(y > 32767 ? 32767 : y < -32767 ? -32767 : y);
+    }
+
+    /** Acrescenta um ponto; os a menos de MERGE saem.
+     *  @return false fora da grade. Cheia: substitui o mais próximo. */
+    bool addPoint(centi_t raw, centi_t ref);
+    /** Pontos gravados (ordem qualquer); inválidos são ignorados. */
+    void load(const CalPoint* p, int n);
+    void clear() { n_ = 0; build(); }
+
+    int             points() const     { return n_; }
+    const CalPoint& point(int i) const { return p_[i]; }
+    /** Correção no valor cru (°C), para relatório. */
+    float           offsetAt(centi_t raw) const { return tempToC(static_cast<centi_t>(apply(raw) - raw)); }
+
+private:
+    void build();
+
+    CalPoint p_[MAX_POINTS] = {};      // ordenados por raw, a ≥ MERGE um do outro
+    uint8_t  n_ = 0;
+    uint8_t  seg_[GRID_N]   = {};      // pontos abaixo do início de cada célula
+    // trecho k (entre os pontos k−1 e k; o primeiro e o último constantes):
+    // correção = off_ + slope_·(raw − x0_)
+    int32_t  off_[MAX_POINTS + 1]   = {};   // centésimos em x0_
+    int32_t  slope_[MAX_POINTS + 1] = {};   // Q16
+    centi_t  x0_[MAX_POINTS + 1]    = {};
+};
+
+/* entrada gravada na NVS (chave "calib" de brew_cfg), por endereço */
+struct SensorCalEntry {
+    uint8_t  addr;
+    uint8_t  n;
+    CalPoint p[SensorCalibration::MAX_POINTS];
+};
+
+class CalibrationCapture {
+public:
+    static constexpr float MAX_SD    = 0.2f;   // °C
+    static constexpr float MAX_DRIFT = 0.1f;   // °C entre as metades da janela
+
+    enum Result : uint8_t { CAP_RUNNING, CAP_DONE, CAP_UNSTABLE, CAP_NO_DATA };
+
+    /** Nova janela de `samples` leituras. */
+    void   begin(uint32_t samples);
+    /** Leitura crua (TEMP_INVALID é ignorada). */
+    void   add(centi_t raw);
+    /** Conta um ciclo sem leitura: janela sem dados acaba em CAP_NO_DATA. */
+    void   miss();
+    Result result() const;
+
+    void    stop()         { target_ = 0; }
+    bool    active() const { return target_ != 0; }
+    centi_t mean()   const;
+    float   sd()     const;
+    float   drift()  const;
+
+private:
+    uint32_t target_ = 0, n_ = 0, missed_ = 0;
+    int64_t  sum_ = 0, sumSq_ = 0, sumHalf_ = 0;
+    uint32_t nHalf_ = 0;
+};
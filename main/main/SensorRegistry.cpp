@@ -0,0 +1,138 @@
+#include "SensorRegistry.hpp"
+
+/* faixas varridas e o tipo provável em cada uma */
+struct ScanRange { uint8_t first, last; SensorType type; };
+static const ScanRange RANGES[] = {
+    { 0x08, 0x0F, SENSOR_SLAVE_SIM },
+    { 0x48, 0x4F, SENSOR_LM75 },
+};
+
+static constexpr uint8_t LM75_REG_CONFIG = 0x01;
+static constexpr uint8_t LM75_REG_TOS    = 0x03;
+static constexpr uint8_t TMP75_RES_MASK  = 0x60;    // R1:R0 (reservados no LM75)
+
+/* TMP75 e afins: os bits de resolução aceitam escrita; a configuração
+ * original volta no fim */
+static bool hasResolution(uint8_t addr, SensorRegistry::ReadReg readReg,
+                          SensorRegistry::WriteReg writeReg, void* arg)
+{
+    uint8_t cfg, back;
+    if (!writeReg || !readReg(addr, LM75_REG_CONFIG, &cfg, 1, arg)) return false;
+    const uint8_t test = cfg | TMP75_RES_MASK;
+    const bool ok = writeReg(addr, LM75_REG_CONFIG, &test, 1, arg) &&
+                    readReg(addr, LM75_REG_CONFIG, &back, 1, arg) &&
+                    (back & TMP75_RES_MASK) == TMP75_RES_MASK;
+    writeReg(addr, LM75_REG_CONFIG, &cfg, 1, arg);
+    return ok;
+}
+
+int SensorRegistry::scan(Probe probe, ReadReg readReg, WriteReg writeReg, void* arg)
+{
+    count_ = 0;
+    for (const ScanRange& r : RANGES) {
+        for (int a = r.first; a <= r.last && count_ < MAX_SENSORS; ++a) {
+            const uint8_t addr = static_cast<uint8_t>(a);
+            if (!probe(addr, arg)) continue;
+            SensorType type = r.type;
+            if (type == SENSOR_LM75) {
+                // Tos é de 9 bits: os 7 bits baixos do 2º byte são zero
+                uint8_t tos[2];
+                if (!readReg || !readReg(addr, LM75_REG_TOS, tos, 2, arg) || (tos[1] & 0x7F)) continue;
+                if (hasResolution(addr, readReg, writeReg, arg)) type = SENSOR_TMP75;
+            }
+            s_[count_].addr = addr;
+            s_[count_].type = type;
+            ++count_;
+        }
+    }
+    defaultRoles();
+    return count_;
+}
+
+int SensorRegistry::add(uint8_t addr, SensorType type)
+{
+    if (count_ >= MAX_SENSORS || find(addr) >= 0) return -1;
+    s_[count_].addr = addr;
+    s_[count_].type = type;
+    ++count_;
+    defaultRoles();
+    return count_ - 1;
+}
+
+void SensorRegistry::defaultRoles()
+{
+    for (int i = 0; i < count_; ++i)
+        s_[i].role = (i == 1) ? ROLE_STRAT : ROLE_CONTROL;
+}
+
+int SensorRegistry::applyRoles(const SensorRoleEntry* e, int n)
+{
+    int applied = 0;
+    for (int k = 0; k < n; ++k)
+        if (e[k].role <= ROLE_AMBIENT && setRole(e[k].addr, static_cast<SensorRole>(e[k].role)))
+            ++applied;
+    return applied;
+}
+
+int SensorRegistry::roles(SensorRoleEntry* e, int max) const
+{
+    int n = 0;
+    for (int i = 0; i < count_ && n < max; ++i, ++n) {
+        e[n].addr = s_[i].addr;
+        e[n].role = s_[i].role;
+    }
+    return n;
+}
+
+bool SensorRegistry::setRole(uint8_t addr, SensorRole role)
+{
+    const int i = find(addr);
+    if (i < 0) return false;
+    s_[i].role = role;
+    return true;
+}
+
+int SensorRegistry::find(uint8_t addr) const
+{
+    for (int i = 0; i < count_; ++i)
+        if (s_[i].addr == addr) return i;
+    return -1;
+}
+
+int SensorRegistry::first(SensorRole role, int from) const
+{
+    for (int i = from; i < count_; ++i)
+        if (s_[i].role == role) return i;
+    return -1;
+}
+
+const char* SensorRegistry::typeName(SensorType t)
+{
+    switch (t) {
+    case SENSOR_SLAVE_SIM: return "escravo";
+    case SENSOR_LM75:      return "lm75";
+    case SENSOR_TMP75:     return "tmp75";
+    default:               return "-";
+    }
+}
+
+const char* SensorRegistry::roleName(SensorRole r)
+{
+    switch (r) {
+    case ROLE_CONTROL: return "controle";
+    case ROLE_STRAT:   return "estratificacao";
+    case ROLE_AMBIENT: return "ambiente";
+    default:           return "nenhum";
+    }
+}
+
+bool SensorRegistry::roleFromLetter(char c, SensorRole& r)
+{
+    switch (c) {
+    case 'C': case 'c': r = ROLE_CONTROL; return true;
+    case 'E': case 'e': r = ROLE_STRAT;   return true;
+    case 'A': case 'a': r = ROLE_AMBIENT; return true;
+    case 'N': case 'n': r = ROLE_NONE;    return true;
+    default:            return false;
+    }
+}
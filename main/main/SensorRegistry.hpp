@@ -0,0 +1,92 @@
+/*  SensorRegistry.hpp
+ *  -------------------------------------------------------------
+ *  Cadastro das sondas de temperatura da tina, montado na partida
+ *  por uma varredura do barramento I²C em vez de endereços fixos:
+ *
+ *   scan()     pergunta cada endereço das faixas suportadas (ACK) e
+ *              identifica o tipo; só tipos conhecidos entram;
+ *   papéis     cada sonda tem um papel: controle (PV do aquecedor),
+ *              estratificação (gradiente do misturador, também entra
+ *              na fusão), ambiente (perda do modelo térmico) ou
+ *              nenhum (só monitorada). Sem configuração gravada, a
+ *              primeira sonda achada é de controle, a segunda de
+ *              estratificação e as demais de controle;
+ *   roles()    papéis por endereço, gravados na NVS (ConfigManager)
+ *              e reaplicados com applyRoles() na partida seguinte —
+ *              uma sonda trocada de endereço volta ao padrão.
+ *
+ *  Tipos suportados (2 bytes big-endian em Q8.8 no registrador de
+ *  temperatura; como ler cada um fica com o ProbeDriver):
+ *   • escravo de teste (slave_full_tester.ino), 0x08–0x0F;
+ *   • LM75 e compatíveis, 0x48–0x4F: o registrador Tos (0x03) tem os
+ *     7 bits baixos em zero;
+ *   • TMP75/TMP175/TMP1075: LM75 cujos bits de resolução (R1:R0) da
+ *     configuração (0x01) aceitam escrita — resolução de 9 a 12 bits
+ *     e conversão one-shot.
+ *
+ *  Código C++ puro (sem Arduino.h): o acesso ao barramento entra por
+ *  callbacks (I2cAcquisition no firmware).
+ */
+#pragma once
+#include <stdint.h>
+
+enum SensorType : uint8_t { SENSOR_NONE = 0, SENSOR_SLAVE_SIM = 1, SENSOR_LM75 = 2, SENSOR_TMP75 = 3 };
+enum SensorRole : uint8_t { ROLE_NONE = 0, ROLE_CONTROL = 1, ROLE_STRAT = 2, ROLE_AMBIENT = 3 };
+
+/* entrada gravada na NVS (chave "sensors" de brew_cfg) */
+struct SensorRoleEntry {
+    uint8_t addr;
+    uint8_t role;        // SensorRole
+};
+
+class SensorRegistry {
+public:
+    static constexpr int MAX_SENSORS = 16;
+
+    struct Sensor {
+        uint8_t    addr = 0;
+        SensorType type = SENSOR_NONE;
+        SensorRole role = ROLE_NONE;
+    };
+
+    /** ACK no endereço? */
+    using Probe   = bool (*)(uint8_t addr, void* arg);
+    /** Lê `len` bytes do registrador `reg` (ponteiro volta a 0). */
+    using ReadReg  = bool (*)(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len, void* arg);
+    /** Escreve `len` bytes no registrador `reg` (ponteiro volta a 0). */
+    using WriteReg = bool (*)(uint8_t addr, uint8_t reg, const uint8_t* buf, uint8_t len, void* arg);
+
+    /** Varre as faixas suportadas e cadastra o que identificar, com os
+     *  papéis padrão. @return sondas cadastradas. */
+    int scan(Probe probe, ReadReg readReg, WriteReg writeReg, void* arg);
+
+    /** Cadastra à mão (sem varredura). @return índice ou −1. */
+    int add(uint8_t addr, SensorType type);
+
+    /** Aplica papéis gravados (endereços ausentes são ignorados).
+     *  @return papéis aplicados. */
+    int applyRoles(const SensorRoleEntry* e, int n);
+    /** Papéis atuais para gravar. @return entradas escritas. */
+    int roles(SensorRoleEntry* e, int max) const;
+    /** @return false se o endereço não está cadastrado. */
+    bool setRole(uint8_t addr, SensorRole role);
+
+    int           count() const      { return count_; }
+    const Sensor& at(int i) const    { return s_[i]; }
+    SensorRole    role(int i) const  { return s_[i].role; }
+    /** Índice do endereço ou −1. */
+    int           find(uint8_t addr) const;
+    /** Primeira sonda com o papel, a partir de `from`, ou −1. */
+    int           first(SensorRole role, int from = 0) const;
+
+    static const char* typeName(SensorType t);
+    static const char* roleName(SensorRole r);
+    /** Letra do comando ROLE (C, E, A, N) → papel; false se inválida. */
+    static bool        roleFromLetter(char c, SensorRole& r);
+
+private:
+    void defaultRoles();
+
+    Sensor s_[MAX_SENSORS];
+    int    count_ = 0;
+};
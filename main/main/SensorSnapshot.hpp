@@ -0,0 +1,80 @@
+/*  SensorSnapshot.hpp
+ *  -------------------------------------------------------------
+ *  Amostra das sondas publicada pelo I2CTask a cada segundo e lida
+ *  pelas outras tasks sem trava, sempre inteira e consistente (as
+ *  duas sondas, o estimador e as máscaras do mesmo segundo), no lugar
+ *  das variáveis globais voláteis lidas uma a uma.
+ *
+ *  SeqSnapshot<T> é um seqlock de buffer duplo com um só escritor:
+ *
+ *   publish()  escreve no buffer livre e só então avança `seq_`
+ *              (par/ímpar escolhe o buffer publicado);
+ *   tryRead()  copia o buffer publicado e confere que `seq_` não
+ *              andou durante a cópia; read() repete até conseguir.
+ *
+ *  O leitor nunca espera o escritor: uma task que interrompe o
+ *  I2CTask no meio de publish() (PidTask, mesmo núcleo e prioridade
+ *  maior) copia o buffer anterior, que está inteiro. Só repete se
+ *  uma publicação inteira terminou durante a sua cópia.
+ *
+ *  Código C++ puro (sem Arduino.h), só com <atomic>.
+ */
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "Temperature.hpp"
+#include "SensorRegistry.hpp"
+
+struct SensorSample {
+    static constexpr int MAX_PROBES = SensorRegistry::MAX_SENSORS;
+
+    uint32_t seq      = 0;          // nº da publicação (0 = valores iniciais)
+    uint32_t atUs     = 0;          // instante da publicação (µs)
+    uint8_t  count    = 0;          // sondas no registro
+    int8_t   ch[2]    = { -1, -1 }; // índices dos canais s1/s2 (−1 = sem)
+    centi_t  s1       = TEMP_INVALID;   // canal de controle
+    centi_t  s2       = TEMP_INVALID;   // canal de estratificação (s1 se não há)
+    uint16_t valid    = 0;          // bit p: leitura aceita no último segundo
+    uint16_t healthy  = 0;          // bit p: ProbeGuard saudável
+    uint16_t inUse    = 0;          // bit p: na fusão
+    float    est      = 0.0f;       // TempEstimator, °C
+    float    rate     = 0.0f;       // °C/s
+    centi_t  temp[MAX_PROBES]   = {};   // decimada (a última boa se não leu)
+    uint32_t readAtUs[MAX_PROBES] = {}; // última leitura aceita (µs)
+};
+
+template<typename T>
+class SeqSnapshot {
+public:
+    /** Só um escritor. */
+    void publish(const T& v)
+    {
+        const uint32_t s = seq_.load(std::memory_order_relaxed);
+        // ordena a publicação anterior antes de reescrever o outro buffer
+        std::atomic_thread_fence(std::memory_order_release);
+        buf_[(s + 1) & 1] = v;
+        seq_.store(s + 1, std::memory_order_release);
+    }
+
+    /** @return false se uma publicação terminou durante a cópia. */
+    bool tryRead(T& v) const
+    {
+        const uint32_t s = seq_.load(std::memory_order_acquire);
+        v = buf_[s & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) == s;
+    }
+
+    T read() const
+    {
+        T v;
+        while (!tryRead(v)) {}
+        return v;
+    }
+
+    uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    T                     buf_[2]{};
+    std::atomic<uint32_t> seq_{0};
+};
@@ -0,0 +1,84 @@
+#include "SimProbeBackend.hpp"
+#include "Temperature.hpp"
+
+SimProbeBackend::SimProbeBackend(const SensorRegistry& reg, Clock clock, const Params& p)
+    : reg_(reg), clock_(clock), p_(p)
+{
+    const float steps = p_.plant.deadTime * 1e6f / (STEP_US * DELAY_DIV) + 0.5f;
+    delayN_ = steps < 0 ? 0 : steps >= DELAY_STEPS ? DELAY_STEPS - 1 : static_cast<int>(steps);
+    reset();
+}
+
+void SimProbeBackend::reset()
+{
+    bulk_  = p_.startC;
+    strat_ = 0;
+    for (double& t : probe_) t = p_.startC;
+    for (float& u : delay_) u = 0;
+    head_    = 0;
+    sub_     = 0;
+    pend_    = 0;
+    started_ = false;
+}
+
+double SimProbeBackend::target(int dev) const
+{
+    if (dev >= reg_.count()) return bulk_;
+    switch (reg_.role(dev)) {
+    case ROLE_AMBIENT: return p_.plant.ambient;
+    case ROLE_STRAT:   return bulk_ + strat_;
+    default:           return bulk_;
+    }
+}
+
+void SimProbeBackend::step(double dt)
+{
+    // duty atrasado pelo tempo morto (fila de DELAY_DIV passos por entrada)
+    float u = duty_;
+    if (delayN_ > 0) {
+        if (sub_ == 0) {
+            delay_[head_] = duty_;
+            head_ = (head_ + 1) % DELAY_STEPS;
+        }
+        sub_ = (sub_ + 1) % DELAY_DIV;
+        u = delay_[(head_ + DELAY_STEPS - 1 - delayN_) % DELAY_STEPS];
+    }
+    const ThermalModel& m = p_.plant;
+    bulk_  += (m.heatGain * u - m.lossCoef * (bulk_ - m.ambient)) * dt;
+    strat_ += (p_.stratGain * u - strat_) * (p_.stratTau > dt ? dt / p_.stratTau : 1.0);
+    const double k = p_.probeTau > dt ? dt / p_.probeTau : 1.0;
+    for (int i = 0; i < MAX_PROBES; ++i) probe_[i] += (target(i) - probe_[i]) * k;
+}
+
+float SimProbeBackend::noise()
+{
+    if (p_.noiseC <= 0) return 0;
+    float s = 0;
+    for (int i = 0; i < 4; ++i) {
+        rnd_ = rnd_ * 1664525u + 1013904223u;
+        s += static_cast<float>(rnd_ >> 8) / 16777216.0f;
+    }
+    return (s - 2.0f) * 1.7320508f * p_.noiseC;     // var(soma de 4 U) = 1/3
+}
+
+void SimProbeBackend::read(uint32_t mask, Done done, void* arg)
+{
+    const uint32_t now = clock_();
+    if (!started_) {
+        started_ = true;
+        last_    = now;
+    }
+    pend_ += now - last_;
+    last_  = now;
+    while (pend_ >= STEP_US) {
+        step(STEP_US * 1e-6);
+        pend_ -= STEP_US;
+    }
+    const int n = reg_.count() < MAX_PROBES ? reg_.count() : MAX_PROBES;
+    for (int dev = 0; dev < n; ++dev) {
+        if (!(mask & (1u << dev))) continue;
+        const int16_t q = tempToQ8_8(static_cast<float>(probe_[dev]) + noise());
+        const uint8_t b[2] = { static_cast<uint8_t>(q >> 8), static_cast<uint8_t>(q & 0xFF) };
+        if (done) done(dev, b, 2, now, arg);
+    }
+}
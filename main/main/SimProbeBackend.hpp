@@ -0,0 +1,83 @@
+/*  SimProbeBackend.hpp
+ *  -------------------------------------------------------------
+ *  ProbeBackend simulado: a tina é o mesmo ThermalModel do controle
+ *  (ambiente, perda, ganho do aquecedor, tempo morto), integrado no
+ *  próprio firmware a partir do duty aplicado — o que o escravo de
+ *  teste (slave_full_tester.ino) faz numa segunda placa.
+ *
+ *  A cada ciclo a planta avança até o relógio em passos de STEP_US
+ *  (o resto fica para o ciclo seguinte) e cada sonda pedida responde
+ *  na hora, em Q8.8, conforme o papel no SensorRegistry:
+ *   controle        massa vista pela sonda (1ª ordem, probeTau);
+ *   estratificação  massa + gradiente que cresce com o aquecimento
+ *                   (stratGain a plena potência, 1ª ordem stratTau),
+ *                   o bastante para o misturador agir;
+ *   ambiente        temperatura ambiente do modelo.
+ *  Ruído aproximadamente normal (soma de 4 uniformes) de noiseC.
+ *
+ *  O misturador não realimenta a planta, e o aquecedor real continua
+ *  sendo comandado: com este backend a saída não deve estar ligada a
+ *  uma resistência.
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+#include "ProbeBackend.hpp"
+#include "SensorRegistry.hpp"
+#include "ThermalModel.hpp"
+
+class SimProbeBackend : public ProbeBackend {
+public:
+    static constexpr int      MAX_PROBES  = 16;
+    static constexpr uint32_t STEP_US     = 10000;     // passo de integração
+    static constexpr int      DELAY_DIV   = 10;        // fila do tempo morto a cada 100 ms
+    static constexpr int      DELAY_STEPS = 256;       // tempo morto até 25,6 s
+
+    struct Params {
+        ThermalModel plant;            // planta "verdadeira" (padrão: a do escravo de teste)
+        float probeTau  = 0.0f;        // s, inércia das sondas (0 = ideal)
+        float stratGain = 1.5f;        // °C de gradiente a plena potência
+        float stratTau  = 60.0f;       // s
+        float noiseC    = 0.05f;       // desvio-padrão do ruído
+        float startC    = 25.0f;       // massa na partida
+    };
+
+    using Clock = uint32_t (*)();
+
+    SimProbeBackend(const SensorRegistry& reg, Clock clock) : SimProbeBackend(reg, clock, Params()) {}
+    SimProbeBackend(const SensorRegistry& reg, Clock clock, const Params& p);
+
+    void read(uint32_t mask, Done done, void* arg) override;
+    void heater(float duty) override { duty_ = duty < 0 ? 0 : duty > 1 ? 1 : duty; }
+    const char* name() const override { return "sim"; }
+
+    /** Recomeça da temperatura inicial (duty e tempo morto zerados). */
+    void reset();
+
+    const Params& params() const { return p_; }
+    float bulk()  const { return static_cast<float>(bulk_); }
+    float strat() const { return static_cast<float>(strat_); }
+    /** Temperatura (sem ruído) que a sonda `dev` vê. */
+    float probe(int dev) const { return static_cast<float>(dev >= 0 && dev < MAX_PROBES ? probe_[dev] : bulk_); }
+
+private:
+    void   step(double dt);
+    double target(int dev) const;
+    float noise();
+
+    const SensorRegistry& reg_;
+    Clock    clock_;
+    Params   p_;
+    float    duty_  = 0;
+    // estado em double: a 10 ms o passo da tina (~2e-4 °C) some no float
+    double   bulk_  = 0;
+    double   strat_ = 0;
+    double   probe_[MAX_PROBES];
+    float    delay_[DELAY_STEPS];
+    int      delayN_ = 0, head_ = 0, sub_ = 0;
+    uint32_t last_ = 0, pend_ = 0;
+    bool     started_ = false;
+    uint32_t rnd_ = 12345;
+};
@@ -0,0 +1,35 @@
+#include "SmithPredictor.hpp"
+
+void SmithPredictor::reset(float pv)
+{
+    ym_ = pv;
+    for (size_t i = 0; i < BUF_SAMPLES; ++i) buf_[i] = pv;
+    head_   = 0;
+    acc_    = 0.0f;
+    corr_   = 0.0f;
+    primed_ = true;
+}
+
+float SmithPredictor::update(float pv, float duty, float dt, const ThermalModel& m)
+{
+    if (!active(m)) { primed_ = false; corr_ = 0.0f; return pv; }
+    if (!primed_) reset(pv);
+
+    // modelo sem atraso
+    ym_ += m.slope(ym_, duty) * dt;
+
+    // linha de atraso amostrada a cada BUF_PERIOD
+    acc_ += dt;
+    while (acc_ >= BUF_PERIOD) {
+        acc_ -= BUF_PERIOD;
+        head_ = (head_ + 1) % BUF_SAMPLES;
+        buf_[head_] = ym_;
+    }
+
+    size_t lag = static_cast<size_t>(m.deadTime / BUF_PERIOD + 0.5f);
+    if (lag >= BUF_SAMPLES) lag = BUF_SAMPLES - 1;
+    float ymDelayed = buf_[(head_ + BUF_SAMPLES - lag) % BUF_SAMPLES];
+
+    corr_ = ym_ - ymDelayed;
+    return pv + corr_;
+}
@@ -0,0 +1,55 @@
+/*  SmithPredictor.hpp
+ *  -------------------------------------------------------------
+ *  Compensação de tempo morto (preditor de Smith) para o laço
+ *  térmico aquecedor → sonda.
+ *
+ *  Um modelo FOPDT (ThermalModel) é integrado em paralelo com a
+ *  planta; o controlador passa a enxergar
+ *
+ *      pv' = pv + ym(t) − ym(t − θ)
+ *
+ *  isto é, a medição acrescida do efeito já comandado mas ainda não
+ *  visto pela sonda. Com o atraso removido da malha os ganhos podem
+ *  ser bem mais agressivos sem oscilar. Erros de modelo continuam
+ *  sendo corrigidos pela realimentação de pv.
+ *
+ *  Com deadTime ≤ 0 no modelo não há atraso a tirar da malha: o
+ *  preditor fica inativo (pv sem correção) e quem troca os ganhos
+ *  deve consultar active(), não enabled().
+ */
+#pragma once
+#include <stddef.h>
+#include "ThermalModel.hpp"
+
+class SmithPredictor {
+public:
+    static constexpr float  BUF_PERIOD  = 0.1f;   // s entre amostras da linha de atraso
+    static constexpr size_t BUF_SAMPLES = 600;    // ⇒ tempo morto máximo de 60 s
+
+    void setEnabled(bool en) { enabled_ = en; }
+    bool enabled() const     { return enabled_; }
+    /** Habilitado e com tempo morto no modelo para compensar. */
+    bool active(const ThermalModel& m) const { return enabled_ && m.deadTime > 0.0f; }
+
+    /** Reinicia o modelo interno em regime na temperatura `pv`. */
+    void reset(float pv);
+
+    /** Avança o modelo e devolve a variável de processo compensada.
+     *  @param pv    temperatura medida (°C)
+     *  @param duty  duty aplicado no ciclo anterior (0..1)
+     *  @param dt    período do laço (s)
+     *  @param m     modelo da planta (tempo morto em m.deadTime)   */
+    float update(float pv, float duty, float dt, const ThermalModel& m);
+
+    /** Última predição ym(t) − ym(t − θ) (°C), para diagnóstico. */
+    float correction() const { return corr_; }
+
+private:
+    float  buf_[BUF_SAMPLES] = {};
+    size_t head_    = 0;
+    float  ym_      = 0.0f;
+    float  acc_     = 0.0f;   // tempo acumulado até a próxima amostra
+    float  corr_    = 0.0f;
+    bool   primed_  = false;
+    bool   enabled_ = false;
+};
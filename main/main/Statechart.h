@@ -122,7 +122,10 @@ class Statechart : public sc::EventDrivenInterface
 			temp_wrong,
 			temp_right,
 			mixer_on,
-			mixer_off
+			mixer_off,
+			heater_fault,
+			sensor_stuck,
+			sensor_diverge
 		};
 		
 		class EventInstance
@@ -162,6 +165,12 @@ class Statechart : public sc::EventDrivenInterface
 		void raiseMixer_on();
 		/*! Raises the in event 'mixer_off' of default interface scope. */
 		void raiseMixer_off();
+		/*! Raises the in event 'heater_fault' of default interface scope. */
+		void raiseHeater_fault();
+		/*! Raises the in event 'sensor_stuck' of default interface scope. */
+		void raiseSensor_stuck();
+		/*! Raises the in event 'sensor_diverge' of default interface scope. */
+		void raiseSensor_diverge();
 		
 		
 		/*! Gets the value of the variable 'current_temp' that is defined in the default interface scope. */
@@ -194,10 +203,14 @@ class Statechart : public sc::EventDrivenInterface
 				
 				virtual void writeUartInt(sc::integer value) = 0;
 				
+				virtual void writeUartTemp(sc::integer value) = 0;
+				
 				virtual void writeMixer(sc::integer value) = 0;
 				
 				virtual sc::integer op_getUartInt() = 0;
 				
+				virtual sc::integer op_getUartTemp() = 0;
+				
 				virtual void op_InitConfig() = 0;
 				
 				virtual void op_LoadConfigFromFlash() = 0;
@@ -234,6 +247,12 @@ class Statechart : public sc::EventDrivenInterface
 				
 				virtual sc::integer op_SetTemperature(sc::integer idx) = 0;
 				
+				virtual void op_EnergyReset() = 0;
+				
+				virtual void op_EnergyReport() = 0;
+				
+				virtual void op_ReportFault(sc::integer code) = 0;
+				
 				
 		};
 		
@@ -494,6 +513,15 @@ class Statechart : public sc::EventDrivenInterface
 		/*! Indicates event 'mixer_off' of default interface scope is active. */
 		bool mixer_off_raised {false};
 		
+		/*! Indicates event 'heater_fault' of default interface scope is active. */
+		bool heater_fault_raised {false};
+		
+		/*! Indicates event 'sensor_stuck' of default interface scope is active. */
+		bool sensor_stuck_raised {false};
+		
+		/*! Indicates event 'sensor_diverge' of default interface scope is active. */
+		bool sensor_diverge_raised {false};
+		
 		
 		
 };
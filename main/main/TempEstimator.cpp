@@ -0,0 +1,80 @@
+#include "TempEstimator.hpp"
+#include <math.h>
+
+void TempEstimator::reset(float t)
+{
+    x_[0] = t;
+    x_[1] = 0.0f;
+    rate_ = 0.0f;
+    P_[0][0] = p_.rProbe; P_[0][1] = 0.0f;
+    P_[1][0] = 0.0f;      P_[1][1] = 1e-4f;
+    streak_ = 0;
+    init_   = true;
+}
+
+void TempEstimator::setProbeNoise(float lsbC, float sigmaC)
+{
+    float r = lsbC * lsbC / 12.0f + sigmaC * sigmaC;
+    p_.rProbe = r > p_.rMin ? r : p_.rMin;
+}
+
+/* ---------- atualização escalar z = T + v ---------- */
+bool TempEstimator::correct(int i, float z)
+{
+    float innov = z - x_[0];
+    res_[i] = innov;
+    if (fabsf(innov) > p_.gate) { ++rejected_[i]; return false; }
+
+    float s  = P_[0][0] + p_.rProbe;
+    float k0 = P_[0][0] / s;
+    float k1 = P_[1][0] / s;
+
+    x_[0] += k0 * innov;
+    x_[1] += k1 * innov;
+
+    // P = (I − K·H)·P, com H = [1 0]
+    float p00 = P_[0][0], p01 = P_[0][1];
+    P_[0][0] -= k0 * p00;  P_[0][1] -= k0 * p01;
+    P_[1][0] -= k1 * p00;  P_[1][1] -= k1 * p01;
+    return true;
+}
+
+void TempEstimator::update(const float z[NUM_PROBES], const bool valid[NUM_PROBES],
+                           float duty, float dt, const ThermalModel& m)
+{
+    if (!init_) {
+        for (int i = 0; i < NUM_PROBES; ++i)
+            if (valid[i]) { reset(z[i]); break; }
+        if (!init_) return;
+    }
+
+    /* --- predição --- */
+    float slope = m.slope(x_[0], duty);
+    float f00   = 1.0f - m.lossCoef * dt;       // ∂T⁺/∂T
+    x_[0] += (slope + x_[1]) * dt;
+
+    // P = F·P·Fᵀ + Q,  F = [[f00, dt], [0, 1]]
+    float p00 = P_[0][0], p01 = P_[0][1], p11 = P_[1][1];
+    float a01 = f00 * p01 + dt * p11;           // (F·P)[0][1]
+    P_[0][0] = f00 * (f00 * p00 + dt * p01) + dt * a01 + p_.qTemp * dt;
+    P_[0][1] = a01;
+    P_[1][0] = a01;
+    P_[1][1] = p11 + p_.qBias * dt;
+
+    /* --- correção com cada sonda válida --- */
+    bool ok0 = false;
+    for (int i = 0; i < NUM_PROBES; ++i) {
+        if (!valid[i]) continue;
+        bool ok = correct(i, z[i]);
+        if (i == 0) ok0 = ok;
+    }
+
+    // sonda de controle rejeitada várias vezes seguidas: o estado é
+    // que está errado (ex.: degrau injetado via TEMPONE) → reinicia
+    if (valid[0] && !ok0) {
+        if (++streak_ >= p_.maxRejects) reset(z[0]);
+    } else {
+        streak_ = 0;
+    }
+    rate_ = m.slope(x_[0], duty) + x_[1];
+}
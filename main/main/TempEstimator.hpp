@@ -0,0 +1,74 @@
+/*  TempEstimator.hpp
+ *  -------------------------------------------------------------
+ *  Estimador (filtro de Kalman) da temperatura do mosto a partir
+ *  das sondas da tina (controle primeiro) e do duty do aquecedor.
+ *
+ *  Estado x = [T, b]  (temperatura °C, desvio do modelo °C/s)
+ *      T⁺ = T + (slope(T, u) + b)·dt
+ *      b⁺ = b                              (passeio aleatório)
+ *  onde slope() é o ThermalModel e u o duty médio do intervalo; b
+ *  absorve o erro do modelo (tampa aberta, volume diferente...).
+ *  A taxa publicada é slope(T, u) + b.
+ *  Cada sonda é uma medição escalar z = T + v (atualização
+ *  sequencial, sem inversão de matriz). Inovações acima de `gate`
+ *  são rejeitadas, o que protege contra uma sonda travada.
+ */
+#pragma once
+#include <stdint.h>
+#include "ThermalModel.hpp"
+
+class TempEstimator {
+public:
+    static constexpr int NUM_PROBES = 16;   // SensorRegistry::MAX_SENSORS
+
+    struct Params {
+        float qTemp   = 1e-3f;   // °C²/s   ruído de processo em T
+        float qBias   = 5e-4f;   // (°C/s)²/s ruído de processo em b (segue perda 2× errada numa rampa)
+        float rProbe  = 0.1f;    // °C²     ruído de medição (até o 1º setProbeNoise)
+        float rMin    = 1e-4f;   // °C²     piso de rProbe (setProbeNoise)
+        float gate    = 5.0f;    // °C      inovação máxima aceita
+        uint8_t maxRejects = 3;  // rejeições seguidas da sonda 0 → reinicia nela
+    };
+
+    TempEstimator() = default;
+    explicit TempEstimator(const Params& p) : p_(p) {}
+
+    /** Ruído de medição das sondas: quantização do LSB (LSB²/12) mais
+     *  o ruído estimado das leituras (σ²), com piso rMin. O I2CTask
+     *  chama a cada segundo com o LSB da aquisição e o ruído visto
+     *  pelo FaultDetector.                                            */
+    void setProbeNoise(float lsbC, float sigmaC);
+    float probeNoise() const          { return p_.rProbe; }
+
+    /** Reinicia o estado em `t` com taxa nula. */
+    void reset(float t);
+
+    /** Um passo do filtro.
+     *  @param z      leituras das sondas (°C)
+     *  @param valid  quais leituras usar neste passo
+     *  @param duty   duty aplicado desde o passo anterior (0..1)
+     *  @param dt     intervalo desde o passo anterior (s)
+     *  @param m      modelo da planta                                */
+    void update(const float z[NUM_PROBES], const bool valid[NUM_PROBES],
+                float duty, float dt, const ThermalModel& m);
+
+    float temperature() const         { return x_[0]; }
+    float rate() const                { return rate_; }
+    float bias() const                { return x_[1]; }
+    float variance() const            { return P_[0][0]; }
+    float residual(int i) const       { return res_[i]; }
+    uint32_t rejected(int i) const    { return rejected_[i]; }
+    bool  initialized() const         { return init_; }
+
+private:
+    bool  correct(int i, float z);
+
+    Params   p_{};
+    float    x_[2]    = {0.0f, 0.0f};
+    float    P_[2][2] = {{1.0f, 0.0f}, {0.0f, 1e-4f}};
+    float    rate_    = 0.0f;
+    float    res_[NUM_PROBES]      = {};
+    uint32_t rejected_[NUM_PROBES] = {};
+    uint8_t  streak_  = 0;
+    bool     init_    = false;
+};
@@ -0,0 +1,61 @@
+/*  Temperature.hpp
+ *  -------------------------------------------------------------
+ *  Temperatura em ponto fixo: centésimos de °C em int16_t
+ *  (−327,67 … 327,67 °C, passo de 0,01 °C).
+ *
+ *  É o tipo que atravessa o firmware — leitura das sondas, sensores
+ *  globais, set-points, receitas na NVS, statechart e telemetria —
+ *  no lugar dos graus inteiros de antes (RF-01 pede ±0,5 °C). Os
+ *  estimadores e controladores seguem em float °C internamente e
+ *  convertem na entrada com tempToC().
+ *
+ *  As sondas entregam 2 bytes big-endian em Q8.8 (formato do LM75 /
+ *  TMP75: byte alto = °C inteiros com sinal, byte baixo = fração).
+ *
+ *  Código C++ puro (sem Arduino.h) para rodar também na simulação
+ *  de host em testes_de_recursos/simulacao_host.
+ */
+#pragma once
+#include <stdint.h>
+
+using centi_t = int16_t;
+
+static constexpr centi_t TEMP_INVALID = INT16_MIN;   // sem leitura / sem etapa
+static constexpr int     TEMP_SCALE   = 100;         // centésimos por °C
+
+/** Graus inteiros → centésimos. */
+static constexpr centi_t tempFromC(int c) { return static_cast<centi_t>(c * TEMP_SCALE); }
+
+/** Centésimos → °C (TEMP_INVALID vira −327,68, abaixo de qualquer leitura). */
+static constexpr float tempToC(centi_t t) { return static_cast<float>(t) / TEMP_SCALE; }
+
+/** °C → centésimos, arredondado e saturado na faixa válida. */
+static inline centi_t tempFromFloat(float c)
+{
+    float x = c * TEMP_SCALE;
+    if (x >=  32767.0f) return  32767;
+    if (x <= -32767.0f) return -32767;
+    return static_cast<centi_t>(x < 0 ? x - 0.5f : x + 0.5f);
+}
+
+/** Q8.8 (1/256 °C) → centésimos, arredondado. */
+static inline centi_t tempFromQ8_8(int16_t raw)
+{
+    int32_t x = static_cast<int32_t>(raw) * TEMP_SCALE;
+    return static_cast<centi_t>(x >= 0 ? (x + 128) >> 8 : -((-x + 128) >> 8));
+}
+
+/** Dois bytes da sonda (big-endian) → centésimos. */
+static inline centi_t tempFromBytes(const uint8_t* b)
+{
+    return tempFromQ8_8(static_cast<int16_t>((static_cast<uint16_t>(b[0]) << 8) | b[1]));
+}
+
+/** °C → Q8.8, como a sonda transmite (escravo de teste / simulação). */
+static inline int16_t tempToQ8_8(float c)
+{
+    float x = c * 256.0f;
+    if (x >=  32767.0f) return  32767;
+    if (x <= -32768.0f) return -32768;
+    return static_cast<int16_t>(x < 0 ? x - 0.5f : x + 0.5f);
+}
@@ -0,0 +1,21 @@
+#include "ThermalModel.hpp"
+#include <cmath>
+
+float ThermalModel::steadyDuty(float sp) const
+{
+    if (heatGain <= 0.0f) return 1.0f;
+    float u = lossCoef * (sp - ambient) / heatGain;
+    return (u < 0.0f) ? 0.0f : (u > 1.0f ? 1.0f : u);
+}
+
+float ThermalModel::rampTime(float from, float to) const
+{
+    if (to <= from) return 0.0f;
+    if (lossCoef <= 0.0f)
+        return (heatGain > 0.0f) ? deadTime + (to - from) / heatGain : -1.0f;
+
+    // solução exata de dT/dt = G − k(T − Ta) com u = 1
+    float tInf = ambient + heatGain / lossCoef;
+    if (to >= tInf) return -1.0f;
+    return deadTime + std::log((tInf - from) / (tInf - to)) / lossCoef;
+}
@@ -0,0 +1,28 @@
+/*  ThermalModel.hpp
+ *  -------------------------------------------------------------
+ *  Modelo térmico de primeira ordem com tempo morto (FOPDT) da
+ *  tina:  dT/dt = heatGain·u(t-θ) − lossCoef·(T − ambient)
+ *
+ *  Os valores padrão são os do simulador slave_full_tester.ino.
+ *  Código C++ puro (usado também na simulação de host).
+ */
+#pragma once
+
+struct ThermalModel {
+    float heatGain = 3.75f;   // °C/s com aquecedor a 100 %
+    float lossCoef = 0.05f;   // 1/s (perda para o ambiente)
+    float ambient  = 25.0f;   // °C
+    float deadTime = 0.0f;    // s (aquecedor → sonda)
+
+    /** Derivada da temperatura (°C/s) para duty 0..1. */
+    float slope(float t, float duty) const {
+        return heatGain * duty - lossCoef * (t - ambient);
+    }
+
+    /** Duty (0..1) que mantém `sp` em regime. */
+    float steadyDuty(float sp) const;
+
+    /** Tempo (s) para ir de `from` a `to` a plena potência
+     *  (inclui o tempo morto; <0 se inatingível). */
+    float rampTime(float from, float to) const;
+};
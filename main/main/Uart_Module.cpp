@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "Uart_Module.hpp"
+#include "Temperature.hpp"
 
 void UartModule::configUART(uint32_t baud)
 {
@@ -16,3 +17,8 @@ void UartModule::writeUartInt(int32_t value)
 {
     Serial.println(value);               // println já põe \r\n
 }
+
+void UartModule::writeUartTemp(int32_t centi)
+{
+    Serial.println(tempToC(static_cast<centi_t>(centi)), 2);
+}
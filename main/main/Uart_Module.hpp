@@ -7,4 +7,5 @@ public:
     static void configUART(uint32_t baud = 9600);   // ⬅ default
     static void writeUart(const std::string& msg);
     static void writeUartInt(int32_t value);
+    static void writeUartTemp(int32_t centi);      // centésimos de °C, 2 casas
 };
@@ -1,9 +1,36 @@
 #include <Arduino.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "Statechart.h"
 #include "CallbackModule.hpp"
+#include "PreheatLookahead.hpp"
+#include "ThermalModel.hpp"
+#include "ApproachController.hpp"
+#include "SmithPredictor.hpp"
+#include "TempEstimator.hpp"
+#include "LossFeedForward.hpp"
+#include "HeaterOutput.hpp"
+#include "MixerController.hpp"
+#include "LoopStats.hpp"
+#include "FopdtIdentifier.hpp"
+#include "FaultDetector.hpp"
+#include "EtaEstimator.hpp"
+#include "MpcController.hpp"
+#include "OverTempGuard.hpp"
+#include "I2cAcquisition.hpp"
+#include "I2cProbeBackend.hpp"
+#include "SimProbeBackend.hpp"
+#include "Temperature.hpp"
+#include "DecimationFilter.hpp"
+#include "ProbeGuard.hpp"
+#include "SensorRegistry.hpp"
+#include "SensorSnapshot.hpp"
+#include "ProbeDriver.hpp"
+#include "SensorCalibration.hpp"
+#include "esp_timer.h"
+#include "esp_cpu.h"
 #include <cmath>
 #include <stdint.h>
 // <<< PID – inclui biblioteca -----------------------------
@@ -11,36 +38,38 @@
 // <<< END PID --------------------------------------------
 
 
-// Testando aplicação de I2C
-#include <Wire.h>          // importante
+/* Sondas: varridas na partida (SensorRegistry: escravos de teste em
+ * 0x08–0x0F, LM75 e compatíveis em 0x48–0x4F), com os papéis gravados
+ * na NVS ("sensors", "ROLExxY"). Sem nenhuma resposta, ficam os dois
+ * escravos de teste (leituras com NACK; TEMPONE/TEMPTWO para testar) */
+constexpr uint8_t I2C_ADDR_FALLBACK[] = { 0x08, 0x09 };
+constexpr int     MAX_PROBES = SensorRegistry::MAX_SENSORS;
+static SensorRegistry sensors;
 
-/* Endereços I²C - ajuste conforme seus sensores */
-constexpr uint8_t I2C_ADDR_SENSOR1 = 0x08; //teste
-constexpr uint8_t I2C_ADDR_SENSOR2 = 0x09;
-//constexpr uint8_t I2C_ADDR_SENSOR1 = 0x48;
-//constexpr uint8_t I2C_ADDR_SENSOR2 = 0x49;
+// barramento das sondas: leituras enfileiradas de uma vez, concluídas
+// por interrupção (I2cAcquisition); pinos padrão do Wire
+constexpr int      PIN_I2C_SDA    = 21;
+constexpr int      PIN_I2C_SCL    = 22;
+constexpr uint32_t I2C_HZ         = 100000;
+constexpr uint32_t I2C_TIMEOUT_US = 10000;   // por transação (escravo pode esticar o SCL)
+static I2cAcquisition i2c;
+// "i2cstats": tentativas, falhas e latência por dispositivo (I2cStats),
+// zeradas no I2CTask a pedido; o TempTask acusa a sonda cuja taxa de
+// falhas no último minuto passa de I2C_FAIL_ALERT
+static volatile bool      i2cStatsResetReq = false;   // "i2cstats_reset"
+static constexpr float    I2C_FAIL_ALERT   = 0.05f;
+static constexpr uint32_t I2C_ALERT_S      = 60;
 
-
-////
-// Testando aplicação de I2C
-static int16_t readTemp8(uint8_t addr)
-{
-    //Wire.beginTransmission(addr);
-    //Wire.write(0x00);                // registrador/ponteiro a ler (exemplo)
-    //Wire.endTransmission(false);     // *false* mantém o bus ativo (repeated-start)
-
-    Wire.requestFrom(addr, (uint8_t)1);
-    if (Wire.available() < 1) return INT8_MIN;   // erro
-
-    uint8_t msb = Wire.read();
-    //uint8_t lsb = Wire.read();
-    //return (int16_t)((msb << 8) | lsb);           // formato big-endian, 16 bits
-    return msb;
-}
-////
-
-volatile int8_t g_sensor1 = 20;   // temperatura inicial fictícia
-volatile int8_t g_sensor2 = 20;
+// sondas em centésimos de °C (Temperature.hpp), decimadas a 1 Hz, com
+// os canais s1/s2 (controle e estratificação), as máscaras de saúde e
+// o estimador do mesmo segundo: publicadas só pelo I2CTask e lidas
+// inteiras pelas outras tasks, sem trava (SensorSnapshot.hpp)
+static SeqSnapshot<SensorSample> g_sample;
+// TEMPONE/TEMPTWO (UartTask) → I2CTask, que aplica no segundo seguinte
+static volatile centi_t injectReq[2] = { TEMP_INVALID, TEMP_INVALID };
+volatile uint16_t g_heaterDuty = 0;   // último duty aplicado pelo PidTask
+volatile uint32_t g_dutySum     = 0;   // soma dos duties desde a última leitura I²C
+volatile uint32_t g_dutyCount   = 0;
 
 static Statechart     machine;
 static CallbackModule cb;
@@ -72,6 +101,7 @@ constexpr uint8_t  PWM_PIN       = 2;      // pino de saída PWM
 constexpr int PWM_FREQUENCY = 1000;   // 19,5 kHz
 constexpr int  PWM_RES_BITS  = 10;      // 0‑1023
 constexpr uint16_t PWM_MAX_DUTY  = (1u << PWM_RES_BITS) - 1;
+constexpr int8_t   PIN_ZERO_CROSS = -1;    // detector de passagem por zero (-1 = sem)
 
 
 
@@ -80,17 +110,273 @@ constexpr double Kp = 5.0;
 constexpr double Ki = 1.5;
 constexpr double Kd = 16.0;
 
+// ganhos com o preditor de Smith ativo (tempo morto fora da malha):
+// menos sobressinal no slave e receita mais curta na tina que os
+// ganhos acima (cenário smith da simulação de host)
+constexpr double Kp_SMITH = 100.0;
+constexpr double Ki_SMITH = 3.0;
+constexpr double Kd_SMITH = 0.0;
+
+// ganhos com feed-forward de perdas: o integrador só corrige o resíduo
+constexpr double Kp_FF = 200.0;
+constexpr double Ki_FF = 0.5;
+constexpr double Kd_FF = 16.0;
+
 // variáveis do PID
 double pidInput  = 0.0;
 double pidOutput = 0.0;
 double pidSetPt  = 0.0;
 PID    pid(&pidInput, &pidOutput, &pidSetPt, Kp, Ki, Kd, DIRECT);
 
+// pré-aquecimento da próxima etapa (desligado por padrão, "preheat_on")
+static PreheatLookahead preheat;
+
+// modelo térmico da planta: só o I2CTask escreve (ambiente medido,
+// feed-forward, identificação aplicada e os AMBIENT/DEADTIME pedidos
+// pela UartTask) e publica a cada segundo em g_model; as outras tasks
+// leem a cópia inteira, sem trava, como g_sample
+static ThermalModel              plantModel;                  // do I2CTask
+static SeqSnapshot<ThermalModel> g_model;
+static volatile float            ambientReq  = NAN;           // AMBIENTxx (°C)
+static volatile float            deadTimeReq = NAN;           // DEADTIMExx (s)
+
+// aproximação a plena potência (CTRL_APPROACH)
+static ApproachController approach;
+
+// anti-windup do PID puro (CTRL_PID): a cada etapa nova ainda fora da
+// banda de RNF-04, plena potência até a borda e integrador pré-carregado
+// com o duty de regime pela perda medida na rampa (não pela lossCoef do
+// modelo, que pode estar 2× errada); sem isso o integrador acumula a rampa inteira e
+// o sobressinal chega perto do corte de Max + 2 °C (RF-07)
+constexpr float PID_WINDUP_BAND = 1.0f;            // °C
+static ApproachController pidWindup({ PID_WINDUP_BAND, PID_WINDUP_BAND, false });
+
+// controle preditivo sobre o perfil da receita (CTRL_MPC, "ctrl_mpc");
+// uma decisão por segundo no PidTask, duty mantido entre decisões
+static MpcController      mpc;
+
+// compensação de tempo morto ("smith_on"); θ em deadTime do modelo
+static SmithPredictor     smith;
+
+// fusão das duas sondas + duty → PV de controle (atualizado no I2CTask)
+static TempEstimator      estimator;
+
+// antecipação das perdas térmicas ("ff_on"); aprende lossCoef/ambient
+static LossFeedForward    feedForward;
+
+// identificação online G/τ/θ (I2CTask, 1 Hz); estimativa válida vai para
+// a NVS e é carregada em plantModel na próxima partida ("ident"). Os
+// modelos passam entre as tasks só por filas de um item (xQueueOverwrite:
+// vale o mais recente), cópia inteira, sem variável compartilhada
+static FopdtIdentifier    ident;
+static ThermalModel       identSaved;              // última gravada/carregada (UartTask)
+// ident é só do I2CTask; o "ident" da UartTask imprime este resumo,
+// publicado a cada segundo como g_sample
+struct IdentSummary {
+    bool     valid    = false;
+    uint32_t samples  = 0;
+    float    heatGain = 0.0f, timeConstant = 0.0f, ambient = 0.0f, deadTime = 0.0f, staticGain = 0.0f;
+};
+static SeqSnapshot<IdentSummary> g_identSum;
+static QueueHandle_t      identSaveQ    = nullptr; // I2CTask → UartTask: gravar na NVS
+static QueueHandle_t      identLoadQ    = nullptr; // UartTask → I2CTask: carregado da NVS
+static volatile bool      identUseReq   = false;   // "ident_apply" (I2CTask aplica)
+static volatile bool      identResetReq = false;
+static volatile bool      identLoaded   = false;   // NVS já consultada
+static constexpr uint32_t IDENT_SAVE_MIN_S = 600;  // no máx. uma gravação a cada 10 min
+
+// detecção de falhas (RF-07) pela taxa de variação (I2CTask, 1 Hz);
+// FAULT_HEATER zera a saída no PidTask e a TempTask avisa o statechart
+static FaultDetector      faultDet;
+volatile uint8_t          g_faults      = 0;       // FaultDetector::faults()
+static volatile bool      faultClearReq = false;   // "fault_clear"
+
+// corte de segurança (RNF-09): leitura acima da etapa mais quente + 2 °C
+// ou nenhuma leitura por 3 s desliga o aquecedor direto no HeaterOutput,
+// sem statechart nem PidTask. Leituras no I2CTask; timeout num esp_timer
+static uint32_t usNow()     { return static_cast<uint32_t>(esp_timer_get_time()); }
+static void     heaterCut() { HeaterOutput::inhibit(true); }
+static OverTempGuard      safety(heaterCut, usNow);
+static esp_timer_handle_t safetyTimer    = nullptr;
+static constexpr uint64_t SAFETY_POLL_US = 5000;   // timeout cortado em ≤ 5 ms
+static volatile bool      safetyClearReq = false;  // "safety_clear"
+
+static void safetyPoll(void*) { safety.poll(usNow()); }
+
+/* Origem das leituras (ProbeBackend): o barramento I²C ou, com
+ * SENSOR_BACKEND_SIM = 1, a planta simulada dentro do firmware
+ * (SimProbeBackend, mesmo ThermalModel do escravo de teste, movida
+ * pelo duty do aquecedor) — malha fechada numa placa só, sem varredura
+ * e com as sondas nos endereços do escravo. Nunca com a resistência
+ * ligada: a saída continua sendo comandada.                          */
+#ifndef SENSOR_BACKEND_SIM
+#define SENSOR_BACKEND_SIM 0
+#endif
+static I2cProbeBackend i2cProbes(i2c);
+#if SENSOR_BACKEND_SIM
+static SimProbeBackend simProbes(sensors, usNow);
+static ProbeBackend* const probes = &simProbes;
+#else
+static ProbeBackend* const probes = &i2cProbes;
+#endif
+
+// conclusão de cada leitura (dentro de probes->read(), no I2CTask):
+// 2 bytes Q8.8 da sonda em centésimos, ou TEMP_INVALID com erro, e o
+// instante da conclusão (latência do corte de segurança)
+static constexpr uint8_t PROBE_READ_LEN = 2;
+static centi_t  probeRead[MAX_PROBES];
+static uint32_t probeAt[MAX_PROBES];
+
+static void onProbe(int dev, const uint8_t* data, uint8_t len, uint32_t atUs, void*)
+{
+    const bool ok  = data && len == PROBE_READ_LEN;
+    probeRead[dev] = ok ? tempFromBytes(data) : TEMP_INVALID;
+    probeAt[dev]   = atUs;
+}
+
+// leituras espúrias (faixa, pico contra a mediana, salto acima da
+// inclinação plausível do modelo) são recusadas antes do corte e do
+// filtro; sonda com saúde baixa sai do controle, que passa para as
+// outras ("probes"). Bit p das máscaras = sonda p do SensorRegistry
+static ProbeGuard         probeGuard[MAX_PROBES];
+static volatile bool      probeResetReq  = false;   // "probes_reset"
+static constexpr float    PROBE_SLOPE_K  = 2.0f;    // inclinação plausível = K·heatGain
+
+// conversão sem espera (ProbeDriver): cada ciclo lê a conversão
+// disparada no anterior; sonda mais lenta que o período é lida a cada
+// `every` ciclos. "BITSxx" troca a resolução dos TMP75 (0 = a maior
+// que cabe no período)
+static ProbeDriver        probeDriver[MAX_PROBES];
+static volatile uint8_t   probeBitsReq = 0;         // aplicado na virada do segundo
+static uint8_t            probeBits    = 0;
+
+// calibração por sonda (SensorCalibration): a leitura crua passa pela
+// tabela antes do ProbeGuard; pontos por endereço gravados na NVS
+// ("calib"). "CALxx=TT.TT" ajusta um ponto da sonda xx (ou * = todas)
+// contra a referência: média crua de CAL_CAPTURE_S s, recusada se a
+// sonda não estava estável. A flash é escrita só pela UartTask
+static SensorCalibration  probeCal[MAX_PROBES];
+static CalibrationCapture calCapture[MAX_PROBES];
+static constexpr uint32_t CAL_CAPTURE_S = 10;
+static volatile uint16_t  calStartReq = 0;          // sondas a capturar (UartTask → I2CTask)
+static volatile uint16_t  calClearReq = 0;          // sondas a limpar
+static volatile centi_t   calRefReq   = TEMP_INVALID;
+static SensorCalEntry     calPending[MAX_PROBES];   // NVS ↔ I2CTask
+static volatile int       calPendingN = 0;
+static volatile bool      calSaveReq  = false;      // UartTask grava calPending
+static volatile bool      calApplyReq = false;      // I2CTask carrega calPending
+
+/* sondas de controle e de estratificação (entram na fusão) */
+static uint16_t fusionMask()
+{
+    uint16_t m = 0;
+    for (int p = 0; p < sensors.count(); ++p)
+        if (sensors.role(p) == ROLE_CONTROL || sensors.role(p) == ROLE_STRAT) m |= 1u << p;
+    return m;
+}
+
+/* sondas da fusão em uso: as saudáveis, ou todas se nenhuma está */
+static uint16_t probesInUse(uint16_t healthy, uint16_t fusion)
+{
+    return (healthy & fusion) ? (healthy & fusion) : fusion;
+}
+
+static void printProbes()
+{
+    const uint16_t inUse = g_sample.read().inUse;
+    printf("log-SONDAS");
+    for (int p = 0; p < sensors.count(); ++p) {
+        const ProbeGuard& g = probeGuard[p];
+        printf(" | 0x%02X=%s%s saude=%u%% aceitas=%lu perdidas=%lu fora_faixa=%lu pico=%lu salto=%lu",
+               sensors.at(p).addr, g.healthy() ? "ok" : "degradada",
+               (inUse & (1u << p)) ? ",controle" : "", g.health(),
+               (unsigned long)g.accepted(), (unsigned long)g.missed(),
+               (unsigned long)g.rejRange(), (unsigned long)g.rejSpike(), (unsigned long)g.rejSlope());
+    }
+    printf("\n");
+}
+
+static void printSensors()
+{
+    const SensorSample smp = g_sample.read();
+    printf("log-SENSORES n=%d seq=%lu origem=%s", sensors.count(), (unsigned long)smp.seq,
+           probes->name());
+    for (int p = 0; p < sensors.count(); ++p) {
+        const SensorRegistry::Sensor& s = sensors.at(p);
+        const ProbeDriver& d = probeDriver[p];
+        printf(" | 0x%02X %s %s %.2f C%s %ub conv=%lums cada=%u", s.addr,
+               SensorRegistry::typeName(s.type), SensorRegistry::roleName(s.role),
+               tempToC(smp.temp[p]), p == smp.ch[0] ? " (s1)" : p == smp.ch[1] ? " (s2)" : "",
+               d.bits(), (unsigned long)(d.convUs() / 1000), d.every());
+    }
+    printf("\n");
+}
+
+/* varredura da partida sobre o I²C */
+#if !SENSOR_BACKEND_SIM
+static bool probeBus(uint8_t addr, void*) { return i2c.probe(addr); }
+static bool readBusReg(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len, void*)
+{
+    return i2c.readRegister(addr, reg, buf, len);
+}
+static bool writeBusReg(uint8_t addr, uint8_t reg, const uint8_t* buf, uint8_t len, void*)
+{
+    return i2c.writeRegister(addr, reg, buf, len);
+}
+#endif
+
+// aquisição sobreamostrada: acqHz leituras por sonda a cada segundo,
+// decimadas para 1 Hz (média móvel) antes do estimador, das falhas e
+// do misturador. "ACQxx" troca a taxa (divisores de 1000 entre 10 e 50)
+constexpr uint16_t ACQ_HZ_DEFAULT = 20;
+constexpr uint16_t ACQ_HZ_MIN     = 10;
+constexpr uint16_t ACQ_HZ_MAX     = 50;
+constexpr uint8_t  ACQ_ORDER      = 1;      // 1 = média móvel, 2 = CIC (mais atraso)
+constexpr uint8_t  ACQ_IIR_SHIFT  = 0;      // IIR extra na saída (0 = sem)
+static DecimationFilter  probeFilter[MAX_PROBES];
+static volatile uint16_t acqHzReq = ACQ_HZ_DEFAULT;   // aplicado na virada do segundo
+static uint16_t          acqHz    = 0;
+static volatile uint32_t acqFilterCycles  = 0;        // custo do filtro (ciclos de CPU)
+static volatile uint32_t acqFilterSamples = 0;
+static volatile uint32_t acqFilterMax     = 0;
+
+static void printAcq()
+{
+    const uint32_t n = acqFilterSamples;
+    printf("log-ACQ %u Hz ordem=%u iir=%u filtro med=%.0f ciclos max=%lu ciclos/leitura (n=%lu)\n",
+           acqHz, ACQ_ORDER, ACQ_IIR_SHIFT, n ? (double)acqFilterCycles / n : 0.0,
+           (unsigned long)acqFilterMax, (unsigned long)n);
+}
+
+static void printSafety()
+{
+    static const char* const REASON[] = { "nenhum", "sobretemperatura", "sem_leitura" };
+    printf("log-CORTE %s motivo=%s limite=%.0f C leitura=%.2f C ultima=%.2f C"
+           " latencia=%luus cortes=%lu\n",
+           safety.tripped() ? "ATIVO" : "armado", REASON[safety.reason()],
+           safety.limit(), safety.tripTemp(), safety.lastTemp(),
+           (unsigned long)safety.latencyUs(), (unsigned long)safety.trips());
+}
+
+static bool modelDiffers(const ThermalModel& a, const ThermalModel& b)
+{
+    auto rel = [](float x, float y) { return std::fabs(x - y) > 0.05f * std::fabs(y); };
+    return rel(a.heatGain, b.heatGain) || rel(a.lossCoef, b.lossCoef) ||
+           std::fabs(a.ambient - b.ambient) > 1.0f || std::fabs(a.deadTime - b.deadTime) > 2.0f;
+}
+
+// instrumentação do laço ("pidstats"): o PidTask é o único a escrever
+// em pidStats; a UartTask pede uma cópia via pidStatsWant
+static LoopStats         pidStats(10000);          // período nominal 10 ms
+static LoopStats         pidStatsSnap(10000);
+static volatile bool     pidStatsWant  = false;
+static volatile bool     pidStatsReset = false;
+
 // Task propriamente dita
 static void PidTask(void*)
 {   
       // Configura PWM (checando erro)
-    if (!ledcAttach(PWM_PIN, PWM_FREQUENCY, PWM_RES_BITS))
+    if (!HeaterOutput::begin(PWM_PIN, PWM_FREQUENCY, PWM_RES_BITS, PIN_ZERO_CROSS))
         Serial.println("Falha no LEDC!");
     
     // ------- PID: inicialização única -------
@@ -98,30 +384,117 @@ static void PidTask(void*)
     pid.SetSampleTime(10);                // 10 ms = 100 Hz
     pid.SetMode(AUTOMATIC);               // liga o controlador
 
+    // contabilidade (RF-10): um tick por iteração deste laço
+    cb.energy.configure(0.010f, PWM_MAX_DUTY);
+    cb.energy.setHeaterWatts(HEATER_WATTS);
+
 
     const TickType_t period = pdMS_TO_TICKS(10);   // 100 Hz
     TickType_t lastWake    = xTaskGetTickCount();
+    uint8_t tunedAs        = 0;                    // 0 = base, 1 = feed-forward, 2 = Smith
+    double ffApplied       = 0.0;                  // feed-forward já refletido nos limites
+    double ffSetPt         = 0.0;                  // set-point em que ffApplied foi calculado
+    constexpr uint8_t MPC_TICKS = 100;             // 1 decisão do MPC por segundo
+    uint8_t mpcTick        = 0;
+    float   mpcDuty        = 0.0f;
 
     for (;;)
     {
-        // --- lê variáveis compartilhadas (área crítica curta) ------------
-        int16_t pid_sp, pid_pv;
-        //taskENTER_CRITICAL();
-        pid_sp = cb.setPoint;
-        pid_pv = g_sensor1;
-        //taskEXIT_CRITICAL();
-
-        // atualiza entradas do PID
-        pidSetPt = static_cast<double>(pid_sp);
-        pidInput = static_cast<double>(pid_pv);
-        pid.Compute();
-
-        // escreve PWM (já limitado por SetOutputLimits)
-        uint16_t duty = constrain(static_cast<int>(pidOutput), 0, PWM_MAX_DUTY);
+        if (pidStatsReset) { pidStats.reset(); pidStatsReset = false; }
+        pidStats.begin(esp_timer_get_time());
+
+        // --- lê variáveis compartilhadas (amostra inteira, sem trava) ----
+        float pid_sp, pid_next, pid_pv;
+        pid_sp   = tempToC(cb.setPoint);       // centésimos → °C dos controladores
+        pid_next = tempToC(cb.nextSetPoint);   // TEMP_INVALID → −327,68: sem próxima
+        pid_pv   = g_sample.read().est;
+        const ThermalModel model = g_model.read();
+
+        // atualiza entradas do PID (set-point pode ser antecipado)
+        pidSetPt = preheat.controlSetPoint(pid_sp, pid_next, pid_pv,
+                                           cb.secLeft, cb.timerRunning);
+
+        // troca os ganhos junto com a habilitação (Smith tem prioridade,
+        // só com tempo morto no modelo para compensar)
+        uint8_t tuning = smith.active(model) ? 2 : (feedForward.enabled() ? 1 : 0);
+        if (tuning != tunedAs) {
+            if      (tuning == 2) pid.SetTunings(Kp_SMITH, Ki_SMITH, Kd_SMITH);
+            else if (tuning == 1) pid.SetTunings(Kp_FF, Ki_FF, Kd_FF);
+            else                  pid.SetTunings(Kp, Ki, Kd);
+            tunedAs = tuning;
+        }
+        pidInput = smith.update(pid_pv, static_cast<float>(g_heaterDuty) / PWM_MAX_DUTY,
+                                0.010f, model);
+
+        // feed-forward das perdas: o PID trabalha em torno de ff, então
+        // os limites da saída dele são deslocados para [-ff, MAX - ff]
+        double ff = std::round(feedForward.duty(pidSetPt, model) * PWM_MAX_DUTY);
+        if (ff != ffApplied) {
+            // modelo reaprendido no mesmo set-point: o integrador (a saída
+            // sem o termo P; o D é ~0 no patamar) devolve a parte da
+            // diferença que já compensava, em vez de somá-la de novo
+            const double d = ff - ffApplied;
+            const double i = pidOutput - pid.GetKp() * (pidSetPt - pidInput);
+            if (pidSetPt == ffSetPt && pid.GetMode() == AUTOMATIC && i * d > 0) {
+                pidOutput = std::fabs(d) >= std::fabs(i) ? 0.0 : i - d;
+                pid.SetMode(MANUAL);
+                pid.SetOutputLimits(-ff, PWM_MAX_DUTY - ff);
+                pid.SetMode(AUTOMATIC);           // Initialize(): integrador = pidOutput
+            }
+            pid.SetOutputLimits(-ff, PWM_MAX_DUTY - ff);
+            ffApplied = ff;
+        }
+        ffSetPt = pidSetPt;
+
+        // estratégia da receita: plena potência até o ponto de comutação
+        bool wantApproach = (ConfigManager::getCtrlMode() == CTRL_APPROACH);
+        if (wantApproach != approach.enabled()) approach.setEnabled(wantApproach);
+        bool wantWindup = (ConfigManager::getCtrlMode() == CTRL_PID);
+        if (wantWindup != pidWindup.enabled()) pidWindup.setEnabled(wantWindup);
+
+        bool wantMpc = (ConfigManager::getCtrlMode() == CTRL_MPC);
+        if (wantMpc != mpc.enabled()) { mpc.setEnabled(wantMpc); mpcTick = 0; }
+
+        if (mpc.enabled()) {
+            if (mpcTick == 0)
+                mpcDuty = mpc.update(pid_sp, pid_next, pid_pv, cb.secLeft,
+                                     cb.timerRunning, model);
+            if (++mpcTick >= MPC_TICKS) mpcTick = 0;
+            // ao sair, Initialize() parte do último duty do MPC (sem salto)
+            pid.SetMode(MANUAL);
+            pidOutput = mpcDuty * PWM_MAX_DUTY - ff;
+        } else if (approach.update(pid_sp, pid_pv, model) ||
+                   pidWindup.update(pid_sp, pid_pv, model)) {
+            pid.SetMode(MANUAL);
+            pidOutput = PWM_MAX_DUTY - ff;
+        } else {
+            // na passagem para o PID, Initialize() usa pidOutput como
+            // integrador: pré-carrega com o duty de regime do set-point,
+            // pela perda medida na rampa que acabou
+            float uss = -1.0f;
+            if (approach.takeHandover())  uss = approach.steadyDuty(pidSetPt, model);
+            if (pidWindup.takeHandover()) uss = pidWindup.steadyDuty(pidSetPt, model);
+            if (uss >= 0.0f) pidOutput = uss * PWM_MAX_DUTY - ff;
+            pid.SetMode(AUTOMATIC);           // sem efeito se já automático
+            pid.Compute();
+        }
+
+        // escreve PWM (já limitado por SetOutputLimits); com falha do
+        // aquecedor a saída fica desligada até "fault_clear"
+        uint16_t duty = constrain(static_cast<int>(pidOutput + ff), 0, PWM_MAX_DUTY);
+        if (g_faults & FaultDetector::FAULT_HEATER) duty = 0;
+        if (HeaterOutput::inhibited()) duty = 0;   // corte de segurança (OverTempGuard)
         //uint16_t duty = 500;
 
         //Serial.printf("duty=%u\n", duty);
-        ledcWrite(PWM_PIN, duty);
+        HeaterOutput::write(duty);
+        g_heaterDuty = duty;
+        g_dutySum   += duty;
+        g_dutyCount += 1;
+        cb.energy.tick(machine.getCurrentCurve(), duty, cb.mixerRunning());
+
+        pidStats.end(esp_timer_get_time());
+        if (pidStatsWant) { pidStatsSnap = pidStats; pidStatsWant = false; }
 
         // espera próximo ciclo
         vTaskDelayUntil(&lastWake, period);
@@ -132,18 +505,261 @@ static void PidTask(void*)
 
 
 
+/* Calibração no I2CTask (1 Hz): carga da NVS, limpeza, início e fim
+ * das capturas; tabela alterada vai para calPending e a UartTask grava */
+static void serviceCal(int nProbes)
+{
+    static bool dirty = false;
+    if (calApplyReq) {
+        for (int p = 0; p < nProbes; ++p)
+            for (int i = 0; i < calPendingN; ++i)
+                if (calPending[i].addr == sensors.at(p).addr)
+                    probeCal[p].load(calPending[i].p, calPending[i].n);
+        calApplyReq = false;
+    }
+    const uint16_t clr = calClearReq;
+    if (clr) {
+        for (int p = 0; p < nProbes; ++p)
+            if (clr & (1u << p)) { probeCal[p].clear(); calCapture[p].stop(); }
+        calClearReq = 0;
+        dirty = true;
+    }
+    const uint16_t start = calStartReq;
+    if (start) {
+        for (int p = 0; p < nProbes; ++p)
+            if (start & (1u << p)) calCapture[p].begin(CAL_CAPTURE_S * acqHz / probeDriver[p].every());
+        calStartReq = 0;
+    }
+    for (int p = 0; p < nProbes; ++p) {
+        CalibrationCapture& c = calCapture[p];
+        if (!c.active() || c.result() == CalibrationCapture::CAP_RUNNING) continue;
+        static const char* const RES[] = { "", "ok", "instavel", "sem leituras" };
+        const CalibrationCapture::Result r = c.result();
+        const bool added = r == CalibrationCapture::CAP_DONE && probeCal[p].addPoint(c.mean(), calRefReq);
+        /* Log • Ex.: log-CAL 0x48 ok: 66.21 -> 65.50 C (dp=0.04 deriva=0.01, 3 pontos) */
+        printf("log-CAL 0x%02X %s: %.2f -> %.2f C (dp=%.2f deriva=%.2f, %d pontos)\n",
+               sensors.at(p).addr, r == CalibrationCapture::CAP_DONE && !added ? "fora da faixa" : RES[r],
+               tempToC(c.mean()), tempToC(calRefReq), c.sd(), c.drift(), probeCal[p].points());
+        dirty |= added;
+        c.stop();
+    }
+    if (dirty && !calSaveReq && !calApplyReq) {
+        int n = 0;
+        for (int p = 0; p < nProbes; ++p) {
+            if (!probeCal[p].points()) continue;
+            SensorCalEntry& e = calPending[n++];
+            e.addr = sensors.at(p).addr;
+            e.n    = static_cast<uint8_t>(probeCal[p].points());
+            for (int i = 0; i < e.n; ++i) e.p[i] = probeCal[p].point(i);
+        }
+        calPendingN = n;
+        calSaveReq  = true;
+        dirty       = false;
+    }
+}
+
 //I2C task
 static void I2CTask(void*)
 {
+    uint32_t sinceSave = IDENT_SAVE_MIN_S;          // 1ª estimativa válida grava logo
+    ThermalModel saved = plantModel;               // gravado/carregado (sem NVS: o padrão)
+    TickType_t lastWake = xTaskGetTickCount();
+    const int nProbes = sensors.count();           // fixo depois da varredura
+    SensorSample smp  = g_sample.read();           // montada aqui, publicada a cada segundo
+    centi_t held[MAX_PROBES];                      // última leitura válida de cada sonda
+    bool    seen[MAX_PROBES]  = {};                // sonda já respondeu alguma vez
+    bool    fresh[MAX_PROBES] = {};                // leitura válida no segundo atual
+    for (int p = 0; p < nProbes; ++p) held[p] = smp.temp[p];
+
+    auto configureAcq = [nProbes] {
+        acqHz     = acqHzReq;
+        probeBits = probeBitsReq;
+        for (DecimationFilter& f : probeFilter) f.configure({ ACQ_ORDER, acqHz, ACQ_IIR_SHIFT });
+        float lsb = 0.0f;                           // a sonda mais grossa
+        for (int p = 0; p < nProbes; ++p) {
+            ProbeDriver& d = probeDriver[p];
+            d.configure(sensors.at(p).type, probeBits, 1000000u / acqHz);
+            probes->configure(p, d);
+            // o ProbeGuard só vê as leituras de fato feitas
+            ProbeGuard::Params gp;
+            gp.dt       = static_cast<float>(d.every()) / acqHz;
+            gp.maxSlope = PROBE_SLOPE_K * plantModel.heatGain;
+            probeGuard[p].configure(gp);
+            lsb = std::max(lsb, d.lsbC());
+        }
+        faultDet.setResolution(lsb);                // janela e limiares do RF-07
+    };
+    configureAcq();
+    g_model.publish(plantModel);
+
     for (;;)
     {
-        vTaskDelay(pdMS_TO_TICKS(1000));          // 1 s (mesmo período da TempTask)
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(1000 / acqHz));
+
+        // as leituras das sondas do ciclo (com o disparo da próxima
+        // conversão) saem juntas
+        ProbeDriver::Step step[MAX_PROBES];
+        uint32_t mask = 0;
+        for (int p = 0; p < nProbes; ++p)
+            if ((step[p] = probeDriver[p].step()) != ProbeDriver::STEP_IDLE) mask |= 1u << p;
+        if (i2cStatsResetReq) { i2c.resetStats(); i2cStatsResetReq = false; }
+        probes->heater(static_cast<float>(g_heaterDuty) / PWM_MAX_DUTY);
+        probes->read(mask, onProbe, nullptr);
+
+        // toda leitura lida passa pelo corte de segurança ainda crua
+        // (só sondas da tina: ambiente e monitoradas não contam); sonda
+        // já tirada do controle pela saúde só passa o que o ProbeGuard
+        // aceita. Para o filtro, perdida, recusada ou sem conversão nova
+        // repete a anterior (mantém os blocos alinhados); a primeira de
+        // uma sonda descarta o histórico fictício
+        bool out = false;
+        for (int p = 0; p < nProbes; ++p) {
+            centi_t x = TEMP_INVALID;
+            if (step[p] == ProbeDriver::STEP_READ) {
+                if (calCapture[p].active()) calCapture[p].add(probeRead[p]);   // crua
+                const centi_t c = probeCal[p].apply(probeRead[p]);
+                x = probeGuard[p].sample(c);
+                const centi_t g = probeGuard[p].healthy() ? c : x;
+                const SensorRole r = sensors.role(p);
+                if (g != TEMP_INVALID && (r == ROLE_CONTROL || r == ROLE_STRAT))
+                    safety.sample(p, tempToC(g), probeAt[p]);
+            }
+            if (x != TEMP_INVALID) {
+                if (!seen[p]) probeFilter[p].reset();
+                held[p]  = x;
+                seen[p]  = fresh[p] = true;
+                smp.readAtUs[p] = probeAt[p];
+            }
+            const uint32_t c0 = esp_cpu_get_cycle_count();
+            out |= probeFilter[p].push(held[p]);
+            const uint32_t dc = esp_cpu_get_cycle_count() - c0;
+            acqFilterCycles += dc;
+            if (dc > acqFilterMax) acqFilterMax = dc;
+        }
+        acqFilterSamples += nProbes;
+        if (!out) continue;                         // resto do laço a 1 Hz
 
-        int8_t t1 = readTemp8(I2C_ADDR_SENSOR1);
-        int8_t t2 = readTemp8(I2C_ADDR_SENSOR2);
+        bool ok[MAX_PROBES];                        // leitura aceita no último segundo
+        smp.valid = 0;
+        for (int p = 0; p < nProbes; ++p) {
+            ok[p] = fresh[p];
+            if (fresh[p]) {                         // atualiza só se leitura OK
+                smp.temp[p]  = probeFilter[p].output();
+                smp.valid   |= 1u << p;
+            }
+            fresh[p] = false;
+        }
+        if (safetyClearReq) {
+            // religa só se rearmou e nenhum corte entrou no meio
+            if (safety.clear(usNow())) HeaterOutput::inhibit(false);
+            if (safety.tripped())      HeaterOutput::inhibit(true);
+            safetyClearReq = false;
+        }
+
+        /* --- canais: s1 = 1ª de controle, s2 = 1ª de estratificação (ou 2ª de controle) --- */
+        int c1 = sensors.first(ROLE_CONTROL);
+        int c2 = sensors.first(ROLE_STRAT);
+        if (c2 < 0 && c1 >= 0) c2 = sensors.first(ROLE_CONTROL, c1 + 1);
+        smp.ch[0] = static_cast<int8_t>(c1);
+        smp.ch[1] = static_cast<int8_t>(c2);
+        // TEMPONE/TEMPTWO: valor injetado na sonda do canal, retido até a próxima leitura
+        for (int c = 0; c < 2; ++c) {
+            const centi_t t = injectReq[c];
+            if (t == TEMP_INVALID) continue;
+            if (smp.ch[c] >= 0) smp.temp[smp.ch[c]] = t;
+            else if (c == 0)    smp.s1 = t;
+            injectReq[c] = TEMP_INVALID;
+        }
+        if (c1 >= 0) smp.s1 = smp.temp[c1];
+        smp.s2 = (c2 >= 0) ? smp.temp[c2] : smp.s1;     // uma sonda só: s2 = s1
 
-        if (t1 != INT8_MIN) g_sensor1 = t1;      // atualiza só se leitura OK
-        if (t2 != INT8_MIN) g_sensor2 = t2;
+        /* --- saúde das sondas: failover do controle para as saudáveis --- */
+        if (probeResetReq) {
+            for (ProbeGuard& g : probeGuard) g.resetCounters();
+            probeResetReq = false;
+        }
+        serviceCal(nProbes);
+        uint16_t healthy = 0;
+        for (int p = 0; p < nProbes; ++p) {
+            probeGuard[p].setMaxSlope(PROBE_SLOPE_K * plantModel.heatGain);
+            if (probeGuard[p].healthy()) healthy |= 1u << p;
+        }
+        safety.setMaxSlope(PROBE_SLOPE_K * plantModel.heatGain);
+        const uint16_t fusion = fusionMask();
+        const uint16_t use    = probesInUse(healthy, fusion);
+        smp.healthy = healthy;
+        smp.inUse   = use;
+
+        /* --- ambiente (medido ou AMBIENTxx) e tempo morto (DEADTIMExx) no modelo --- */
+        const float ta = ambientReq, th = deadTimeReq;
+        if (!std::isnan(ta)) { plantModel.ambient  = ta; ambientReq  = NAN; }
+        if (!std::isnan(th)) { plantModel.deadTime = th; deadTimeReq = NAN; }
+        const int amb = sensors.first(ROLE_AMBIENT);
+        if (amb >= 0 && ok[amb] && (healthy & (1u << amb))) plantModel.ambient = tempToC(smp.temp[amb]);
+
+        /* --- estimador: duty médio do último segundo + as sondas da fusão --- */
+        uint32_t n   = g_dutyCount;
+        float    u   = n ? static_cast<float>(g_dutySum) / n / PWM_MAX_DUTY : 0.0f;
+        g_dutySum    = 0;
+        g_dutyCount  = 0;
+
+        /* --- falhas nos dois canais: antes do estimador, que deixa de usar sonda travada --- */
+        if (faultClearReq) { faultDet.clear(); faultClearReq = false; }
+        const float zc[FaultDetector::NUM_PROBES]  = { tempToC(smp.s1), tempToC(smp.s2) };
+        const bool  okc[FaultDetector::NUM_PROBES] = { c1 >= 0 && ok[c1], c2 >= 0 && ok[c2] };
+        faultDet.update(zc, okc, u, plantModel);
+        g_faults = faultDet.faults();
+        estimator.setProbeNoise(faultDet.resolution(), faultDet.noise());
+
+        // canal de controle primeiro (TempEstimator reinicia nele); valores
+        // retidos também entram (TEMPONE/TEMPTWO sem sensor); uma sonda
+        // travada longe das demais é barrada pelo gate
+        float z[TempEstimator::NUM_PROBES];
+        bool  valid[TempEstimator::NUM_PROBES];
+        int   k = 0;
+        for (int i = -1; i < nProbes && k < TempEstimator::NUM_PROBES; ++i) {
+            const int p = (i < 0) ? c1 : i;
+            if (p < 0 || (i >= 0 && p == c1) || !(fusion & (1u << p))) continue;
+            const bool stuck = (p == c1 && faultDet.stuck(0)) || (p == c2 && faultDet.stuck(1));
+            z[k]     = tempToC(smp.temp[p]);
+            valid[k] = (use & (1u << p)) && !stuck;
+            ++k;
+        }
+        for (; k < TempEstimator::NUM_PROBES; ++k) { z[k] = 0.0f; valid[k] = false; }
+        estimator.update(z, valid, u, 1.0f, plantModel);
+        smp.est   = estimator.temperature();
+        smp.rate  = estimator.rate();
+        smp.atUs  = usNow();
+        ++smp.seq;
+        g_sample.publish(smp);
+        feedForward.learn(estimator.temperature(), u, 1.0f, plantModel);
+
+        /* --- identificação: canal de controle (outra em uso se ele saiu) + duty médio --- */
+        int idp = c1;
+        if (idp < 0 || !(use & (1u << idp)))
+            for (idp = 0; idp < nProbes && !(use & (1u << idp)); ++idp) {}
+        if (identResetReq) { ident = FopdtIdentifier(); identResetReq = false; }
+        if (idp < nProbes) ident.update(tempToC(smp.temp[idp]), u);
+        g_identSum.publish({ ident.valid(), ident.samples(), ident.heatGain(), ident.timeConstant(),
+                             ident.ambient(), ident.deadTime(), ident.staticGain() });
+        ThermalModel loaded;
+        if (xQueueReceive(identLoadQ, &loaded, 0) == pdTRUE) plantModel = saved = loaded;
+        if (identUseReq) {
+            if (ident.valid()) plantModel = ident.model();
+            identUseReq = false;
+        }
+        g_model.publish(plantModel);
+        if (sinceSave < IDENT_SAVE_MIN_S) ++sinceSave;
+        if (ident.valid() && sinceSave >= IDENT_SAVE_MIN_S && identLoaded &&
+            modelDiffers(ident.model(), saved)) {
+            // gravação na flash fica com a UartTask (IO_CORE, prioridade baixa)
+            saved = ident.model();
+            xQueueOverwrite(identSaveQ, &saved);
+            sinceSave = 0;
+        }
+        // telemetria (EST-) sai pela TempTask, fora do núcleo de controle
+
+        if (acqHzReq != acqHz || probeBitsReq != probeBits) configureAcq();   // só na virada do segundo
     }
 }
 ////
@@ -153,38 +769,335 @@ static void I2CTask(void*)
 /* ---------- TemperatureTask ---------- */
 static void TempTask(void *) {
 
-    bool mixerOn = false;
+    MixerController mixer;      // velocidade pelo gradiente entre sensores (RF-09)
+    uint8_t faultsSeen = 0;     // falhas já avisadas ao statechart
+    uint32_t cutsSeen  = 0;     // cortes de segurança já avisados
+    EtaEstimator eta;           // tempo restante da receita
+    uint16_t healthySeen = 0xFFFF; // sondas saudáveis já avisadas
+    uint32_t i2cTick = 0;          // segundos desde a última checagem do barramento
+    uint32_t i2cTry[I2cStats::MAX_DEVICES]  = {};   // contadores na última checagem
+    uint32_t i2cFail[I2cStats::MAX_DEVICES] = {};
 
     for (;;) {
         vTaskDelay(pdMS_TO_TICKS(1000));
 
-        int8_t t1 = g_sensor1;
-        int8_t t2 = g_sensor2;
-        int8_t sp = cb.setPoint;
-        /* --- Timer_counter: baseado no sensor1 --- */
-        bool temp_wrong = (sp-t1)>1;
+        const SensorSample smp = g_sample.read();   // canais, saúde e estimador do mesmo segundo
+        centi_t t1 = smp.s1;
+        centi_t t2 = smp.s2;
+        centi_t sp = cb.setPoint;
+        const uint16_t healthy = smp.healthy;
+        const uint16_t inUse   = smp.inUse;
+        float   pv = smp.est;
+        /* --- Timer_counter: baseado na temperatura estimada --- */
+        bool temp_wrong = (tempToC(sp) - pv) > 1.0f;
 
+        int     curve;
+        bool    brewing, holding;
+        int32_t secLeft;
         withSM([&]{
             if (temp_wrong)     machine.raiseTemp_wrong();
             else                machine.raiseTemp_right();
+            curve   = machine.getCurrentCurve();
+            brewing = machine.isStateActive(Statechart::State::Brewer_Brew_process_r1_RUNNING);
+            holding = cb.timerRunning;
+            secLeft = cb.secLeft;
+            cb.nextSetPoint = ConfigManager::getTemperature(curve + 1);
         });
 
-        /* --- Mixer: diferença entre sensores --- */
-        bool diff = (std::abs(t1 - t2) > 1);
+        /* --- Pré-aquecimento: taxa observada a plena potência --- */
+        preheat.updateRate(pv, static_cast<float>(g_heaterDuty) / PWM_MAX_DUTY, 1.0f);
 
-        if (diff && !mixerOn) {
-            mixerOn = true;
-            withSM([&]{ machine.raiseMixer_on(); });
+        /* --- Tempo restante: rampas previstas + patamares da receita --- */
+        centi_t  temps[MAX_STEPS];
+        uint32_t durs[MAX_STEPS];
+        int n = static_cast<int>(ConfigManager::getStepCount());
+        for (int i = 0; i < n; ++i) {
+            temps[i] = ConfigManager::getTemperature(i);
+            durs[i]  = ConfigManager::getDuration(i);
         }
-        if (!diff && mixerOn) {
-            mixerOn = false;
-            withSM([&]{ machine.raiseMixer_off(); });
+        const ThermalModel model = g_model.read();
+        eta.learn(pv, static_cast<float>(g_heaterDuty) / PWM_MAX_DUTY, 1.0f, model);
+        eta.setHoldLift(preheat.lift());
+        eta.update(temps, durs, brewing ? n : 0, curve, secLeft, holding, pv, 1.0f, model);
+        safety.setCurve(temps, n);
+
+        /* --- Mixer: gradiente filtrado entre sensores, com histerese --- */
+        // maior diferença entre as sondas da fusão em uso; com menos de
+        // duas não há gradiente: mistura contínua
+        float hi = -1e9f, lo = 1e9f;
+        int   nUse = 0;
+        for (int p = 0; p < sensors.count(); ++p) {
+            if (!(inUse & (1u << p))) continue;
+            const float t = tempToC(smp.temp[p]);
+            if (t > hi) hi = t;
+            if (t < lo) lo = t;
+            ++nUse;
         }
+        bool changed = nUse >= 2 ? mixer.update(hi, lo, 1.0f)
+                                 : mixer.updateBlind(1.0f);
+        bool diff    = mixer.running();
 
-        /* Log • Ex.: DATA-setP-s1-s2-diffFlag */
-        printf("DATA-%d-%d-%d-%d\n",
-               sp, t1, t2, diff ? 1 : 0);
+        // velocidade antes do evento, para Start_Mix já ligar nela
+        withSM([&]{
+            if (diff) cb.setMixerSpeed(mixer.speed());
+            if (changed && diff)  machine.raiseMixer_on();
+            if (changed && !diff) machine.raiseMixer_off();
+        });
+
+        /* --- Falhas (RF-07): um evento por falha nova --- */
+        uint8_t faults = g_faults;
+        uint8_t fresh  = faults & ~faultsSeen;
+        faultsSeen     = faults;
+        if (fresh) {
+            withSM([&]{
+                if (fresh & FaultDetector::FAULT_HEATER)  machine.raiseHeater_fault();
+                if (fresh & (FaultDetector::FAULT_STUCK1 | FaultDetector::FAULT_STUCK2))
+                                                          machine.raiseSensor_stuck();
+                if (fresh & FaultDetector::FAULT_DIVERGE) machine.raiseSensor_diverge();
+            });
+        }
+
+        /* --- Saúde das sondas: aviso a cada failover --- */
+        if (healthy != healthySeen) {
+            healthySeen = healthy;
+            printProbes();
+        }
+
+        /* --- Barramento: sonda com muitas falhas no último minuto --- */
+        if (++i2cTick >= I2C_ALERT_S) {
+            i2cTick = 0;
+            for (int i = 0; i < i2c.deviceCount(); ++i) {
+                const I2cStats::Device& d = i2c.stats().device(i);
+                const uint32_t n = d.attempts, f = d.failures();
+                if (n < i2cTry[i]) i2cTry[i] = i2cFail[i] = 0;      // "i2cstats_reset"
+                const uint32_t dn = n - i2cTry[i], df = f - i2cFail[i];
+                if (dn && df > I2C_FAIL_ALERT * dn)
+                    printf("log-I2C 0x%02X falhas=%lu/%lu no ultimo minuto\n", i2c.address(i),
+                           (unsigned long)df, (unsigned long)dn);
+                i2cTry[i]  = n;
+                i2cFail[i] = f;
+            }
+        }
+
+        /* --- Corte de segurança: aviso ao operador (o corte já foi feito) --- */
+        if (safety.trips() != cutsSeen) {
+            cutsSeen = safety.trips();
+            printSafety();
+        }
+
+        /* --- Relatório do RF-10 pedido pelo END_PROCESS, fora do statechart --- */
+        if (cb.energyReportReq && cb.energy.stopped()) {
+            cb.energyReportReq = false;
+            cb.printEnergyReport();
+        }
+
+        /* Log • Ex.: ETA-rest=5400 etapa=1320 rampa=610 (s; -1 = rampa inatingível) */
+        if (brewing)
+            printf("ETA-rest=%.0f etapa=%.0f rampa=%.0f\n",
+                   eta.remaining(), eta.stepRemaining(), eta.rampRemaining());
+
+        /* Log • Ex.: EST-t=67.12 r=0.0040 e1=-0.12 e2=0.30 (antes do DATA) */
+        printf("EST-t=%.2f r=%.4f e1=%.2f e2=%.2f\n",
+               estimator.temperature(), estimator.rate(),
+               estimator.residual(0), estimator.residual(1));
+
+        /* Log • Ex.: DATA-setP-s1-s2-mixerFlag (°C com 2 casas: DATA-67.00-66.81-66.94-0) */
+        printf("DATA-%.2f-%.2f-%.2f-%d\n",
+               tempToC(sp), tempToC(t1), tempToC(t2), diff ? 1 : 0);
+    }
+}
+
+/* ---------- relatório de temporização ("pidstats") ---------- */
+static void printHist(const char* name, const uint32_t* h)
+{
+    printf("log-%s:", name);
+    for (int i = 0; i < LoopStats::BINS; ++i)
+        if (h[i]) printf(" %s%lu:%lu", i == LoopStats::BINS - 1 ? ">=" : "<",
+                         (unsigned long)(i == LoopStats::BINS - 1 ? LoopStats::binFloor(i)
+                                                                  : LoopStats::binFloor(i + 1)),
+                         (unsigned long)h[i]);
+    printf("\n");
+}
+
+static void printLoopStats(const char* name, const LoopStats& s)
+{
+    printf("log-%s %luus: n=%lu perdas=%lu periodo=[%lu,%lu]us calculo med=%.0fus max=%luus latencia max=%luus\n",
+           name, (unsigned long)s.periodUs(), (unsigned long)s.count(), (unsigned long)s.misses(),
+           (unsigned long)(s.count() ? s.periodMin() : 0), (unsigned long)s.periodMax(),
+           s.computeMean(), (unsigned long)s.computeMax(), (unsigned long)s.latencyMax());
+    printHist("jitter", s.jitterHist());
+    printHist("calculo", s.computeHist());
+}
+
+static void printI2c()
+{
+    static const char* const ST[] = { "-", "pendente", "ok", "nack", "timeout", "erro", "curta" };
+    printf("log-I2C ciclo=%luus max=%luus", (unsigned long)i2c.cycleUs(),
+           (unsigned long)i2c.cycleMaxUs());
+    for (int i = 0; i < i2c.deviceCount(); ++i)
+        printf(" 0x%02X=%s", i2c.address(i), ST[i2c.status(i)]);
+    printf("\n");
+}
+
+/* Log • Ex.: log-I2CSTATS 0x48 n=3600 ok=3598 nack=2 timeout=0 curta=0 erro=0
+ *          seq=1 lat=[212,231,498]us */
+static void printI2cStats()
+{
+    const I2cStats& st = i2c.stats();
+    for (int i = 0; i < i2c.deviceCount(); ++i) {
+        const I2cStats::Device& d = st.device(i);
+        printf("log-I2CSTATS 0x%02X n=%lu ok=%lu nack=%lu timeout=%lu curta=%lu erro=%lu seq=%lu"
+               " lat=[%lu,%.0f,%lu]us\n",
+               i2c.address(i), (unsigned long)d.attempts, (unsigned long)d.ok(),
+               (unsigned long)d.outcome[I2cStats::OUT_NACK],
+               (unsigned long)d.outcome[I2cStats::OUT_TIMEOUT],
+               (unsigned long)d.outcome[I2cStats::OUT_SHORT],
+               (unsigned long)d.outcome[I2cStats::OUT_ERROR], (unsigned long)d.failRunMax,
+               (unsigned long)(d.attempts ? d.latMin : 0), d.latMean(), (unsigned long)d.latMax);
+        printf("log-I2CLAT 0x%02X:", i2c.address(i));
+        for (int b = 0; b < I2cStats::BINS; ++b)
+            if (d.hist[b]) printf(" %s%lu:%lu", b == I2cStats::BINS - 1 ? ">=" : "<",
+                                  (unsigned long)(b == I2cStats::BINS - 1 ? I2cStats::binFloor(b)
+                                                                          : I2cStats::binFloor(b + 1)),
+                                  (unsigned long)d.hist[b]);
+        printf("\n");
+    }
+}
+
+#if SENSOR_BACKEND_SIM
+/* Log • Ex.: log-SIM massa=66.93 C estrat=0.21 C G=3.7500 k=0.050000 Ta=25.0 theta=0 */
+static void printSim()
+{
+    const ThermalModel& m = simProbes.params().plant;
+    printf("log-SIM massa=%.2f C estrat=%.2f C G=%.4f k=%.6f Ta=%.1f theta=%.0f\n",
+           simProbes.bulk(), simProbes.strat(), m.heatGain, m.lossCoef, m.ambient, m.deadTime);
+}
+#endif
+
+static void printIdent()
+{
+    const IdentSummary id = g_identSum.read();
+    printf("log-IDENT %s n=%lu G=%.4f C/s tau=%.0f s Ta=%.1f C theta=%.0f s K=%.1f C\n",
+           id.valid ? "valido" : "invalido", (unsigned long)id.samples,
+           id.heatGain, id.timeConstant, id.ambient, id.deadTime, id.staticGain);
+    printf("log-IDENT salvo G=%.4f k=%.6f Ta=%.1f theta=%.0f\n",
+           identSaved.heatGain, identSaved.lossCoef, identSaved.ambient, identSaved.deadTime);
+}
+
+/* Persistência do modelo identificado: a flash é escrita só aqui,
+ * fora do núcleo de controle. Carga única assim que a NVS estiver
+ * iniciada (op_InitConfig, chamado pelo statechart). */
+static void serviceIdentNvs()
+{
+    if (!identLoaded) {
+        ThermalModel m;
+        esp_err_t err = ConfigManager::loadModel(m);
+        if (err == ESP_ERR_INVALID_STATE) return;          // NVS ainda não iniciada
+        if (err == ESP_OK) {
+            identSaved = m;
+            xQueueOverwrite(identLoadQ, &m);
+            printf("log-modelo carregado da NVS: G=%.4f k=%.6f Ta=%.1f theta=%.0f\n",
+                   m.heatGain, m.lossCoef, m.ambient, m.deadTime);
+        } else {
+            identSaved = g_model.read();                    // padrão do firmware
+        }
+        identLoaded = true;
+    }
+    ThermalModel m;
+    if (xQueueReceive(identSaveQ, &m, 0) == pdTRUE && ConfigManager::saveModel(m) == ESP_OK)
+        identSaved = m;
+}
+
+/* Papéis das sondas gravados na NVS: carga única, como o modelo */
+static void serviceSensorNvs()
+{
+    static bool loaded = false;
+    if (loaded) return;
+    SensorRoleEntry e[SensorRegistry::MAX_SENSORS];
+    size_t n = SensorRegistry::MAX_SENSORS;
+    esp_err_t err = ConfigManager::loadSensorRoles(e, n);
+    if (err == ESP_ERR_INVALID_STATE) return;              // NVS ainda não iniciada
+    if (err == ESP_OK && sensors.applyRoles(e, static_cast<int>(n)) > 0) printSensors();
+    loaded = true;
+}
+
+/* Calibração: carga única como os papéis; gravação a pedido do I2CTask */
+static void serviceCalNvs()
+{
+    static bool loaded = false;
+    if (!loaded && !calSaveReq) {
+        size_t n = MAX_PROBES;
+        esp_err_t err = ConfigManager::loadSensorCal(calPending, n);
+        if (err == ESP_ERR_INVALID_STATE) return;          // NVS ainda não iniciada
+        if (err == ESP_OK) {
+            calPendingN = static_cast<int>(n);
+            calApplyReq = true;
+            printf("log-CAL %u sondas calibradas na NVS\n", (unsigned)n);
+        }
+        loaded = true;
+    }
+    if (calSaveReq) {
+        if (ConfigManager::saveSensorCal(calPending, static_cast<size_t>(calPendingN)) != ESP_OK)
+            printf("log-CAL falha ao gravar calibracao\n");
+        calSaveReq = false;
+    }
+}
+
+/* CAL<addr hex|*>=<°C> → captura um ponto contra a referência;
+ * CALCLR<addr hex|*> → apaga a calibração */
+static uint16_t calMask(const char* arg, const char** end)
+{
+    if (*arg == '*') {
+        *end = arg + 1;
+        return static_cast<uint16_t>((1u << sensors.count()) - 1);
+    }
+    char* e;
+    const long addr = strtol(arg, &e, 16);
+    *end = e;
+    const int p = (e != arg && addr >= 0 && addr <= 0x7F) ? sensors.find(static_cast<uint8_t>(addr)) : -1;
+    return p >= 0 ? static_cast<uint16_t>(1u << p) : 0;
+}
+
+static void calibrate(const char* arg)
+{
+    const char* end;
+    const uint16_t m = calMask(arg, &end);
+    if (!m || *end != '=' || !end[1]) {
+        printf("log-CAL comando invalido: CAL%s\n", arg);
+        return;
+    }
+    calRefReq   = tempFromFloat(atof(end + 1));
+    calStartReq = m;
+    printf("log-CAL capturando %u s contra %.2f C\n", (unsigned)CAL_CAPTURE_S, tempToC(calRefReq));
+}
+
+static void printCal()
+{
+    for (int p = 0; p < sensors.count(); ++p) {
+        const SensorCalibration& c = probeCal[p];
+        printf("log-CAL 0x%02X %d pontos", sensors.at(p).addr, c.points());
+        for (int i = 0; i < c.points(); ++i)
+            printf(" %.2f->%.2f", tempToC(c.point(i).raw), tempToC(c.point(i).ref));
+        printf("\n");
+    }
+}
+
+/* ROLE<addr hex><C|E|A|N> → papel da sonda, gravado na NVS */
+static void setSensorRole(const char* arg)
+{
+    char* end;
+    const long addr = strtol(arg, &end, 16);
+    SensorRole r;
+    if (end == arg || addr < 0 || addr > 0x7F || !SensorRegistry::roleFromLetter(*end, r) ||
+        !sensors.setRole(static_cast<uint8_t>(addr), r)) {
+        printf("log-SENSORES papel invalido: %s\n", arg);
+        return;
     }
+    SensorRoleEntry e[SensorRegistry::MAX_SENSORS];
+    const int n = sensors.roles(e, SensorRegistry::MAX_SENSORS);
+    if (ConfigManager::saveSensorRoles(e, static_cast<size_t>(n)) != ESP_OK)
+        printf("log-SENSORES falha ao gravar papeis\n");
+    printSensors();
 }
 
 static void UartTask(void*) {
@@ -193,6 +1106,10 @@ static void UartTask(void*) {
     size_t idx = 0;
 
     for (;;) {
+        serviceIdentNvs();
+        serviceSensorNvs();
+        serviceCalNvs();
+
         // lê tudo que chegou
         while (Serial.available()) {
             char c = Serial.read();
@@ -200,16 +1117,20 @@ static void UartTask(void*) {
                 buf[idx] = 0;  // fecha string
 
                 // --- tratar linha inteira em buf ---
-                // 1) é um inteiro puro?
+                // 1) é um número puro? (inteiro, ou com um ponto: "67.5")
                 bool isInt = true;
+                int  dots  = 0;
                 for (size_t i = 0; i < idx; ++i) {
+                    if (buf[i] == '.' && ++dots == 1) continue;
                     if (!(buf[i] >= '0' && buf[i] <= '9') && !(i == 0 && buf[i]=='-')) {
                         isInt = false;
                         break;
                     }
                 }
                 if (isInt && idx > 0) {
-                    cb.lastUartInt = atoi(buf);
+                    // durações usam o inteiro; temperaturas, as casas decimais
+                    cb.lastUartInt  = atoi(buf);
+                    cb.lastUartTemp = tempFromFloat(atof(buf));
                     withSM([&]{ machine.raiseInt_received(); });
                 }
                 else if (strcmp(buf, "start") == 0) {
@@ -239,13 +1160,156 @@ static void UartTask(void*) {
                 else if (strcmp(buf, "ready") == 0) {
                     withSM([&]{ machine.raiseReady(); });
                 }
-                // 2) TEMPONExxx → g_sensor1
+                else if (strcmp(buf, "preheat_on") == 0) {
+                    preheat.setEnabled(true);
+                }
+                else if (strcmp(buf, "preheat_off") == 0) {
+                    preheat.setEnabled(false);
+                }
+                else if (strcmp(buf, "ctrl_pid") == 0) {
+                    ConfigManager::setCtrlMode(CTRL_PID);
+                }
+                else if (strcmp(buf, "ctrl_approach") == 0) {
+                    ConfigManager::setCtrlMode(CTRL_APPROACH);
+                }
+                else if (strcmp(buf, "ctrl_mpc") == 0) {
+                    ConfigManager::setCtrlMode(CTRL_MPC);
+                }
+                else if (strcmp(buf, "smith_on") == 0) {
+                    if (g_model.read().deadTime > 0.0f) smith.setEnabled(true);
+                    else printf("log-SMITH recusado: modelo sem tempo morto (DEADTIMExx)\n");
+                }
+                else if (strcmp(buf, "smith_off") == 0) {
+                    smith.setEnabled(false);
+                }
+                else if (strcmp(buf, "ff_on") == 0) {
+                    feedForward.setEnabled(true);
+                }
+                else if (strcmp(buf, "ff_off") == 0) {
+                    feedForward.setEnabled(false);
+                }
+                else if (strcmp(buf, "pidstats") == 0) {
+                    // cópia feita pelo próprio PidTask (no máx. 1 período)
+                    pidStatsWant = true;
+                    for (int i = 0; i < 5 && pidStatsWant; ++i) vTaskDelay(pdMS_TO_TICKS(10));
+                    if (!pidStatsWant) printLoopStats("PID", pidStatsSnap);
+                }
+                else if (strcmp(buf, "pidstats_reset") == 0) {
+                    pidStatsReset = true;
+                }
+                else if (strcmp(buf, "ident") == 0) {
+                    printIdent();
+                }
+                else if (strcmp(buf, "ident_apply") == 0) {
+                    identUseReq = true;            // estimativa válida vira o modelo
+                }
+                else if (strcmp(buf, "ident_reset") == 0) {
+                    identResetReq = true;
+                }
+                else if (strcmp(buf, "faults") == 0) {
+                    uint8_t f = g_faults;
+                    printf("log-FALHAS 0x%02X aquecedor=%d s1=%s s2=%s divergencia=%d"
+                           " obs=%.3f/%.3f esp=%.3f/%.3f C/s\n", f,
+                           (f & FaultDetector::FAULT_HEATER) ? 1 : 0,
+                           faultDet.stuck(0) ? "travada" : "ok", faultDet.stuck(1) ? "travada" : "ok",
+                           (f & FaultDetector::FAULT_DIVERGE) ? 1 : 0,
+                           faultDet.observedSlope(0), faultDet.observedSlope(1),
+                           faultDet.expectedSlope(0), faultDet.expectedSlope(1));
+                }
+                else if (strcmp(buf, "fault_clear") == 0) {
+                    faultClearReq = true;
+                }
+                else if (strcmp(buf, "i2c") == 0) {
+                    printI2c();
+                }
+                else if (strcmp(buf, "i2cstats") == 0) {
+                    printI2cStats();
+                }
+                else if (strcmp(buf, "i2cstats_reset") == 0) {
+                    i2cStatsResetReq = true;
+                }
+                else if (strcmp(buf, "cal") == 0) {
+                    printCal();
+                }
+#if SENSOR_BACKEND_SIM
+                else if (strcmp(buf, "sim") == 0) {
+                    printSim();
+                }
+#endif
+                else if (strcmp(buf, "acq") == 0) {
+                    printAcq();
+                }
+                else if (strcmp(buf, "probes") == 0) {
+                    printProbes();
+                }
+                else if (strcmp(buf, "probes_reset") == 0) {
+                    probeResetReq = true;
+                }
+                else if (strcmp(buf, "sensors") == 0) {
+                    printSensors();
+                }
+                // ROLExxY → papel da sonda no endereço xx (hex): C controle,
+                // E estratificação, A ambiente, N nenhum (vale no próximo segundo)
+                else if (strncmp(buf, "ROLE", 4) == 0) {
+                    setSensorRole(buf + 4);
+                }
+                else if (strcmp(buf, "safety") == 0) {
+                    printSafety();
+                }
+                else if (strcmp(buf, "safety_clear") == 0) {
+                    safetyClearReq = true;
+                }
+                else if (strcmp(buf, "heater_ledc") == 0) {
+                    HeaterOutput::setBackend(HeaterOutput::HEATER_LEDC);
+                }
+                else if (strcmp(buf, "heater_burst") == 0) {
+                    HeaterOutput::setBackend(HeaterOutput::HEATER_BURST);
+                }
+                // AMBIENTxx → temperatura ambiente do modelo (°C)
+                else if (strncmp(buf, "AMBIENT", 7) == 0) {
+                    ambientReq = atof(buf + 7);            // aplicado pelo I2CTask
+                }
+                // WATTSxxxx → potência do aquecedor para o relatório (W)
+                else if (strncmp(buf, "WATTS", 5) == 0) {
+                    cb.energy.setHeaterWatts(atof(buf + 5));
+                }
+                // ACQxx → leituras por sonda por segundo (10..50, divisor de 1000)
+                else if (strncmp(buf, "ACQ", 3) == 0) {
+                    int hz = atoi(buf + 3);
+                    if (hz >= ACQ_HZ_MIN && hz <= ACQ_HZ_MAX && 1000 % hz == 0)
+                        acqHzReq = static_cast<uint16_t>(hz);
+                }
+                // BITSxx → resolução dos TMP75 (9..12; 0 = a maior que converte num período)
+                else if (strncmp(buf, "BITS", 4) == 0) {
+                    int bits = atoi(buf + 4);
+                    if (bits == 0 || (bits >= ProbeDriver::MIN_BITS && bits <= ProbeDriver::MAX_BITS))
+                        probeBitsReq = static_cast<uint8_t>(bits);
+                }
+                // CALCLRxx → apaga a calibração da sonda xx (hex; * = todas)
+                else if (strncmp(buf, "CALCLR", 6) == 0) {
+                    const char* end;
+                    const uint16_t m = calMask(buf + 6, &end);
+                    if (m) calClearReq = m;
+                }
+                // CALxx=TT.TT → ponto de calibração da sonda xx (hex; * = todas) contra TT.TT °C
+                else if (strncmp(buf, "CAL", 3) == 0) {
+                    calibrate(buf + 3);
+                }
+                // DEADTIMExx → tempo morto do modelo (s)
+                else if (strncmp(buf, "DEADTIME", 8) == 0) {
+                    deadTimeReq = atof(buf + 8);
+                }
+                // 2) TEMPONExx.xx → sonda do canal s1 (°C, aceita casas decimais),
+                //    aplicada pelo I2CTask no segundo seguinte; não passa pelo
+                //    corte de segurança, que só vê leituras reais de sonda
                 else if (strncmp(buf, "TEMPONE", 7) == 0) {
-                    g_sensor1 = atoi(buf + 7);
+                    const centi_t t = tempFromFloat(atof(buf + 7));
+                    injectReq[0] = t;
                 }
-                // 3) TEMPTWOxxx → g_sensor2
+                // 3) TEMPTWOxx.xx → sonda do canal s2
                 else if (strncmp(buf, "TEMPTWO", 7) == 0) {
-                    g_sensor2 = atoi(buf + 7);
+                    const centi_t t = tempFromFloat(atof(buf + 7));
+                    injectReq[1] = t;
                 }
                 // se quiser, pode logar o comando não reconhecido:
                 // else Serial.printf("CMD unknown: %s\n", buf);
@@ -263,26 +1327,100 @@ static void UartTask(void*) {
     }
 }
 
+/* ---------- distribuição das tasks (núcleo / prioridade) ----------
+ * TASK_LAYOUT_PINNED = 1: caminho de controle (aquisição I²C, PID e
+ * saída do aquecedor) fixo em CONTROL_CORE com as maiores prioridades;
+ * statechart, timer, telemetria e serial em IO_CORE. Nenhuma task do
+ * caminho de controle toma smMtx, então não há espera entre núcleos.
+ * O ISR do I²C e o da passagem por zero ficam no núcleo que chamou
+ * I2cAcquisition::begin() (loopTask, núcleo 1) e HeaterOutput::begin()
+ * (PidTask).
+ * TASK_LAYOUT_PINNED = 0: distribuição original, sem afinidade.        */
+#ifndef TASK_LAYOUT_PINNED
+#define TASK_LAYOUT_PINNED 1
+#endif
+
+#if CONFIG_FREERTOS_UNICORE
+static constexpr BaseType_t CONTROL_CORE = 0;
+static constexpr BaseType_t IO_CORE      = 0;
+#else
+static constexpr BaseType_t CONTROL_CORE = 1;   // APP_CPU (PRO_CPU roda esp_timer/IPC)
+static constexpr BaseType_t IO_CORE      = 0;
+#endif
+
+struct TaskSpec {
+    TaskFunction_t fn;
+    const char*    name;
+    uint32_t       stack;
+    UBaseType_t    prio;
+    BaseType_t     core;
+};
+
+static const TaskSpec TASK_LAYOUT[] = {
+#if TASK_LAYOUT_PINNED
+    { PidTask  , "pid"  , 4096, 7, CONTROL_CORE },   // 100 Hz, maior prioridade
+    { I2CTask  , "i2c"  , 4096, 6, CONTROL_CORE },
+    { TimerTask, "timer", 2048, 5, IO_CORE      },
+    { TempTask , "temp" , 4096, 4, IO_CORE      },
+    { UartTask , "uart" , 2048, 3, IO_CORE      },
+#else
+    { I2CTask  , "i2c"  , 4096, 4, tskNO_AFFINITY },
+    { TimerTask, "timer", 2048, 5, tskNO_AFFINITY },
+    { TempTask , "temp" , 4096, 4, tskNO_AFFINITY },
+    { PidTask  , "pid"  , 4096, 4, tskNO_AFFINITY },
+    { UartTask , "uart" , 2048, 3, tskNO_AFFINITY },
+#endif
+};
+
 // antes era extern "C" void app_main()
 void app_tasks_init()          // novo nome
 {
     //Serial.begin(9600);
     smMtx = xSemaphoreCreateMutex();
+    identSaveQ = xQueueCreate(1, sizeof(ThermalModel));
+    identLoadQ = xQueueCreate(1, sizeof(ThermalModel));
 
     cb.configGPIO();           // se usar pinMode/digitalWrite
     cb.configUART();           // se ainda quiser
 
     machine.setOperationCallback(&cb);
     machine.enter();
-    /// I2C
-    Wire.begin();                     // inicia I²C com pinos padrão (SDA21/SCL22)
-
-    xTaskCreate(I2CTask, "i2c", 4096, NULL, 4, NULL);
-    ///
-    xTaskCreate(TimerTask     , "timer", 2048, NULL, 5, NULL);
-    xTaskCreate(TempTask      , "temp" , 4096, NULL, 4, NULL);
+    /// I2C: varredura das sondas; o índice no I2cAcquisition é o do registro
+#if SENSOR_BACKEND_SIM
+    bool i2cOk = true;                          // planta simulada: sem barramento
+    for (uint8_t a : I2C_ADDR_FALLBACK) sensors.add(a, SENSOR_SLAVE_SIM);
+#else
+    bool i2cOk = i2c.begin(PIN_I2C_SDA, PIN_I2C_SCL, I2C_HZ);
+    if (!i2cOk || sensors.scan(probeBus, readBusReg, writeBusReg, nullptr) == 0)
+        for (uint8_t a : I2C_ADDR_FALLBACK) sensors.add(a, SENSOR_SLAVE_SIM);
+#endif
+    SensorSample first;                         // 20 °C fictícios até a 1ª leitura
+    first.count = static_cast<uint8_t>(sensors.count());
+    first.s1    = first.s2 = tempFromC(20);
+    first.est   = 20.0f;
+    for (int p = 0; p < sensors.count(); ++p) {
+        first.temp[p] = tempFromC(20);
+        probeRead[p]  = TEMP_INVALID;
+        if (!SENSOR_BACKEND_SIM && i2cOk &&
+            i2cProbes.addProbe(sensors.at(p).addr, PROBE_READ_LEN, I2C_TIMEOUT_US) != p)
+            i2cOk = false;
+    }
+    if (!i2cOk) Serial.println("Falha no I2C!");
+    first.healthy = first.inUse = fusionMask();
+    g_sample.publish(first);
+    printSensors();
 
-    xTaskCreate(PidTask       , "pid"  , 4096, NULL, 4, NULL);   // <<< PID task
+    // corte de segurança: timeout conta desde já; callback na task do
+    // esp_timer (prioridade acima de todas as tasks da aplicação)
+    const esp_timer_create_args_t safetyArgs = {
+        .callback = safetyPoll, .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK, .name = "safety",
+        .skip_unhandled_events = true,
+    };
+    safety.arm(usNow());
+    esp_timer_create(&safetyArgs, &safetyTimer);
+    esp_timer_start_periodic(safetyTimer, SAFETY_POLL_US);
 
-    xTaskCreate(UartTask      , "uart" , 2048, NULL, 3, NULL);
+    for (const TaskSpec& t : TASK_LAYOUT)
+        xTaskCreatePinnedToCore(t.fn, t.name, t.stack, NULL, t.prio, NULL, t.core);
 }
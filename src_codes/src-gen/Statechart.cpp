@@ -126,6 +126,21 @@ bool Statechart::dispatchEvent(Statechart::EventInstance* event) noexcept
 			mixer_off_raised = true;
 			break;
 		}
+		case Statechart::Event::heater_fault:
+		{
+			heater_fault_raised = true;
+			break;
+		}
+		case Statechart::Event::sensor_stuck:
+		{
+			sensor_stuck_raised = true;
+			break;
+		}
+		case Statechart::Event::sensor_diverge:
+		{
+			sensor_diverge_raised = true;
+			break;
+		}
 		
 		
 		default:
@@ -259,6 +274,30 @@ void Statechart::raiseMixer_off() {
 }
 
 
+/*! Raises the in event 'heater_fault' of default interface scope. */
+void Statechart::raiseHeater_fault() {
+	incomingEventQueue.push_back(new Statechart::EventInstance(Statechart::Event::heater_fault))
+	;
+	runCycle();
+}
+
+
+/*! Raises the in event 'sensor_stuck' of default interface scope. */
+void Statechart::raiseSensor_stuck() {
+	incomingEventQueue.push_back(new Statechart::EventInstance(Statechart::Event::sensor_stuck))
+	;
+	runCycle();
+}
+
+
+/*! Raises the in event 'sensor_diverge' of default interface scope. */
+void Statechart::raiseSensor_diverge() {
+	incomingEventQueue.push_back(new Statechart::EventInstance(Statechart::Event::sensor_diverge))
+	;
+	runCycle();
+}
+
+
 
 bool Statechart::isActive() const noexcept
 {
@@ -523,7 +562,7 @@ void Statechart::enact_Brewer_Brew_process_r1_CONFIG_Config_WaitTemp()
 void Statechart::enact_Brewer_Brew_process_r1_CONFIG_Config_set_Temp()
 {
 	/* Entry action for state 'set_Temp'. */
-	setCurrent_temp(ifaceOperationCallback->op_getUartInt());
+	setCurrent_temp(ifaceOperationCallback->op_getUartTemp());
 	completed = true;
 }
 
@@ -600,7 +639,7 @@ void Statechart::enact_Brewer_Brew_process_r1_RUNNING_Curves_current_curve()
 {
 	/* Entry action for state 'current_curve'. */
 	ifaceOperationCallback->writeUartString("log\n-Temperatura: ");
-	ifaceOperationCallback->writeUartInt(current_temp);
+	ifaceOperationCallback->writeUartTemp(current_temp);
 	ifaceOperationCallback->writeUartString("log-Dura\u00E7\u00E3o: ");
 	ifaceOperationCallback->writeUartInt(current_duration);
 	completed = true;
@@ -633,6 +672,7 @@ void Statechart::enact_Brewer_Brew_process_r1_READY()
 	/* Entry action for state 'READY'. */
 	setCurrentCurve(0);
 	setStep_count(ifaceOperationCallback->op_GetStepCount());
+	ifaceOperationCallback->op_EnergyReset();
 	completed = true;
 }
 
@@ -642,6 +682,7 @@ void Statechart::enact_Brewer_Brew_process_r1_END_PROCESS()
 	ifaceOperationCallback->writeUartString("log-\nPROCESSO FINALIZADO\n");
 	ifaceOperationCallback->writeMixer(0);
 	ifaceOperationCallback->op_SetTemperature(0);
+	ifaceOperationCallback->op_EnergyReport();
 	completed = true;
 }
 
@@ -1903,6 +1944,18 @@ sc::integer Statechart::Brewer_Brew_process_r1_RUNNING_react(const sc::integer t
 		if ((transitioned_after) == (transitioned_before))
 		{ 
 			/* then execute local reactions. */
+			if (heater_fault_raised)
+			{ 
+				ifaceOperationCallback->op_ReportFault(1);
+			} 
+			if (sensor_stuck_raised)
+			{ 
+				ifaceOperationCallback->op_ReportFault(2);
+			} 
+			if (sensor_diverge_raised)
+			{ 
+				ifaceOperationCallback->op_ReportFault(3);
+			} 
 			transitioned_after = Brewer_Brew_process_react(transitioned_before);
 		} 
 	} 
@@ -2392,6 +2445,9 @@ void Statechart::clearInEvents() noexcept {
 	temp_right_raised = false;
 	mixer_on_raised = false;
 	mixer_off_raised = false;
+	heater_fault_raised = false;
+	sensor_stuck_raised = false;
+	sensor_diverge_raised = false;
 }
 
 void Statechart::microStep() {
@@ -32,14 +32,17 @@ const float GANHO_AQUECIMENTO  = (MAX_TEMP_SIMULATED - TEMPERATURA_AMBIENTE) * T
 
 // Callback: master requisitou dados
 void onRequest() {
-  // Converte a temperatura simulada para int8 (1 byte)
-  int8_t temp_int = (int8_t)roundf(simulatedTemperature);
   // Limita entre 25 e 100 para evitar valores fora do intervalo
-  if (temp_int < MIN_TEMP_SIMULATED) temp_int = (int8_t)MIN_TEMP_SIMULATED;
-  if (temp_int > MAX_TEMP_SIMULATED) temp_int = (int8_t)MAX_TEMP_SIMULATED;
+  float t = simulatedTemperature;
+  if (t < MIN_TEMP_SIMULATED) t = MIN_TEMP_SIMULATED;
+  if (t > MAX_TEMP_SIMULATED) t = MAX_TEMP_SIMULATED;
 
-  Serial.printf("RequestEvent: Mestre requisitou dados. Enviando temperatura: %d C\n", temp_int);
-  Wire.write((uint8_t*)&temp_int, 1);  // Envia apenas 1 byte
+  // 2 bytes em Q8.8, big-endian (formato do LM75/TMP75 lido pelo mestre)
+  int16_t raw = (int16_t)lroundf(t * 256.0f);
+  uint8_t buf[2] = { (uint8_t)(raw >> 8), (uint8_t)(raw & 0xFF) };
+
+  Serial.printf("RequestEvent: Mestre requisitou dados. Enviando temperatura: %.2f C\n", raw / 256.0f);
+  Wire.write(buf, 2);
 }
 
 // Callback: master enviou dados (debug)
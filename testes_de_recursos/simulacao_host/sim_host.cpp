@@ -0,0 +1,2296 @@
+/*  sim_host.cpp
+ *  -------------------------------------------------------------
+ *  Simulação em host (PC) do laço de controle do brew_master.
+ *
+ *  Reproduz o comportamento das tasks do firmware (PidTask a 100 Hz,
+ *  I2CTask/TempTask/TimerTask a 1 Hz e a lógica de etapas da
+ *  Statechart) sobre um modelo térmico de tina de mostura, usando
+ *  os mesmos módulos de controle de main/main.
+ *
+ *  Compilação (a partir desta pasta):
+ *    g++ -std=c++17 -O2 -I../../main/main sim_host.cpp \
+ *        ../../main/main/PreheatLookahead.cpp ../../main/main/ThermalModel.cpp \
+ *        ../../main/main/ApproachController.cpp \
+ *        ../../main/main/SmithPredictor.cpp \
+ *        ../../main/main/TempEstimator.cpp \
+ *        ../../main/main/LossFeedForward.cpp \
+ *        ../../main/main/MixerController.cpp \
+ *        ../../main/main/LoopStats.cpp ../../main/main/EnergyMeter.cpp \
+ *        ../../main/main/FopdtIdentifier.cpp \
+ *        ../../main/main/FaultDetector.cpp ../../main/main/EtaEstimator.cpp \
+ *        ../../main/main/MpcController.cpp ../../main/main/OverTempGuard.cpp \
+ *        ../../main/main/DecimationFilter.cpp ../../main/main/ProbeGuard.cpp \
+ *        ../../main/main/ProbeDriver.cpp ../../main/main/I2cStats.cpp \
+ *        ../../main/main/SensorCalibration.cpp ../../main/main/SensorRegistry.cpp \
+ *        ../../main/main/SimProbeBackend.cpp -o sim_host
+ *
+ *  Uso:
+ *    ./sim_host preheat    curva padrão com/sem pré-aquecimento
+ *    ./sim_host approach   PID sem e com anti-windup x aproximação a plena potência
+ *    ./sim_host smith      PID x preditor de Smith com os ganhos dele
+ *    ./sim_host fusao      PV = sonda 1 x estimador das duas sondas, com ruído
+ *    ./sim_host ff         PID x PID + feed-forward de perdas (modelo certo/errado)
+ *    ./sim_host ssr        linearidade/comutações: PWM LEDC x burst-fire num SSR
+ *    ./sim_host mixer      misturador liga/desliga x velocidade pelo gradiente
+ *    ./sim_host jitter     período/cálculo/perdas do PidTask no escalonador simulado
+ *    ./sim_host energia    relatório de aquecimento/mistura por etapa (RF-10)
+ *    ./sim_host ident      identificação FOPDT online x parâmetros reais da planta
+ *    ./sim_host falhas     aquecedor/sonda com defeito injetado: tempo de detecção
+ *    ./sim_host eta        tempo restante previsto x real ao longo da receita
+ *    ./sim_host mpc        PID / aproximação / MPC: banda, energia e custo por decisão
+ *    ./sim_host corte      corte de segurança: sobretemperatura e sonda muda, latência
+ *    ./sim_host resolucao  sondas de 1 byte (°C inteiros) x 2 bytes Q8.8 em centésimos
+ *    ./sim_host aquisicao  leitura a 1 Hz x sobreamostrada e decimada; custo do filtro
+ *    ./sim_host sondas     leituras espúrias e sonda degradada: rejeição e failover
+ *    ./sim_host conversao  LM75/TMP75: resolução x tempo de conversão, sem esperar a conversão
+ *    ./sim_host i2c        tempo de barramento por ciclo (100/400 kHz, 2–16 sondas) e contadores
+ *    ./sim_host calibracao sondas com desvio de fábrica: sem calibração x 1, 2 e 3 pontos
+ *    ./sim_host backend    planta simulada do firmware (SimProbeBackend) x planta do host
+ *
+ *  Cada cenário confere o que a mudança correspondente promete (linhas
+ *  "[ok]" / "[FALHOU]" depois da tabela); com alguma falha o processo
+ *  sai com 1, para rodar os cenários num script.
+ */
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include "PreheatLookahead.hpp"
+#include "ThermalModel.hpp"
+#include "ApproachController.hpp"
+#include "SmithPredictor.hpp"
+#include "TempEstimator.hpp"
+#include "LossFeedForward.hpp"
+#include "BurstFireModulator.hpp"
+#include "MixerController.hpp"
+#include "LoopStats.hpp"
+#include "EnergyMeter.hpp"
+#include "FopdtIdentifier.hpp"
+#include "FaultDetector.hpp"
+#include "EtaEstimator.hpp"
+#include "MpcController.hpp"
+#include "OverTempGuard.hpp"
+#include "Temperature.hpp"
+#include "DecimationFilter.hpp"
+#include "ProbeGuard.hpp"
+#include "ProbeDriver.hpp"
+#include "I2cStats.hpp"
+#include "SensorCalibration.hpp"
+#include "SimProbeBackend.hpp"
+
+/* ---------- parâmetros espelhados do firmware ---------- */
+constexpr double   Kp = 5.0;                 // app_tasks.cpp
+constexpr double   Ki = 1.5;
+constexpr double   Kd = 16.0;
+constexpr double   Kp_SMITH = 100.0;         // ganhos com preditor de Smith
+constexpr double   Ki_SMITH = 3.0;
+constexpr double   Kd_SMITH = 0.0;
+constexpr double   Kp_FF = 200.0;            // ganhos com feed-forward de perdas
+constexpr double   Ki_FF = 0.5;
+constexpr double   Kd_FF = 16.0;
+constexpr float    PID_WINDUP_BAND = 1.0f;   // °C, anti-windup do PID puro
+constexpr uint16_t PWM_MAX_DUTY = 1023;
+constexpr double   PWM_FREQUENCY = 1000.0;   // Hz do LEDC
+constexpr double   SEMICICLO = 1.0 / 120.0;  // s, rede de 60 Hz (HeaterOutput::MAINS_HZ)
+constexpr double   PID_DT = 0.010;           // 10 ms = 100 Hz
+constexpr int      TICKS_PER_S = 100;
+constexpr uint32_t I2C_HZ = 100000;          // barramento das sondas
+constexpr uint32_t I2C_TIMEOUT_US = 10000;   // prazo por transação
+
+/* mesma curva de ConfigManager::FACTORY_DEFAULT (aqui em °C inteiros;
+ * simular() converte para centésimos, como a NVS guarda) */
+struct Receita {
+    std::vector<int>      temps;
+    std::vector<uint32_t> durs;
+};
+static const Receita RECEITA_PADRAO = { {67, 78, 85}, {120, 180, 50} };
+
+static std::vector<centi_t> centesimos(const Receita& rc)
+{
+    std::vector<centi_t> t;
+    for (int c : rc.temps) t.push_back(tempFromC(c));
+    return t;
+}
+
+/* ---------- planta térmica de primeira ordem com tempo morto ---------- */
+struct PlantaParams {
+    const char* nome;
+    double ambiente;    // °C
+    double ganho;       // °C/s com aquecedor a 100 %
+    double perda;       // 1/s (perda para o ambiente)
+    double atraso;      // s de tempo morto aquecedor → sonda
+    double tauSonda;    // s de constante de tempo da sonda (0 = ideal)
+    double tInicial;    // °C
+};
+
+/* mesmo modelo de slave_full_tester.ino (I2C/i2c_full_test) */
+static const PlantaParams PLANTA_SLAVE = { "slave", 25.0, 3.75, 0.05, 0.0, 0.0, 25.0 };
+/* tina de mostura 25 L com resistência de 2,5 kW */
+static const PlantaParams PLANTA_TINA  = { "tina",  25.0, 0.0239, 5e-5, 20.0, 5.0, 25.0 };
+static const PlantaParams* const PLANTAS[] = { &PLANTA_SLAVE, &PLANTA_TINA };
+
+class PlantaTermica {
+public:
+    explicit PlantaTermica(const PlantaParams& p)
+        : p_(p), bulk_(p.tInicial), sonda_(p.tInicial), sonda2_(p.tInicial),
+          fila_(static_cast<size_t>(p.atraso / PID_DT) + 1, 0.0) {}
+
+    void passo(double duty, double dt) {
+        fila_[pos_] = duty;
+        pos_ = (pos_ + 1) % fila_.size();
+        double uAtrasado = fila_[pos_];
+        bulk_  += (uAtrasado * p_.ganho - (bulk_ - p_.ambiente) * p_.perda) * dt;
+        sonda_  = (p_.tauSonda > dt) ? sonda_ + (bulk_ - sonda_) * dt / p_.tauSonda : bulk_;
+        // segunda sonda: mesma posição radial, o dobro da inércia térmica
+        double tau2 = 2.0 * p_.tauSonda;
+        sonda2_ = (tau2 > dt) ? sonda2_ + (bulk_ - sonda2_) * dt / tau2 : bulk_;
+    }
+    void   perda(double k) { p_.perda = k; }
+    double bulk()   const { return bulk_; }
+    double sonda()  const { return sonda_; }
+    double sonda2() const { return sonda2_; }
+
+private:
+    PlantaParams        p_;
+    double              bulk_, sonda_, sonda2_;
+    std::vector<double> fila_;
+    size_t              pos_ = 0;
+};
+
+/* ---------- saída do aquecedor (HeaterOutput) ---------- */
+enum Saida {
+    SAIDA_PWM_IDEAL,   // potência = duty (bancada com o simulador escravo)
+    SAIDA_LEDC_SSR,    // PWM LEDC de 1 kHz num SSR com disparo em zero
+    SAIDA_BURST        // BurstFireModulator nas passagens por zero
+};
+
+class SaidaAquecedor {
+public:
+    explicit SaidaAquecedor(Saida s, uint8_t bloco = 2) : s_(s), mod_(bloco) {}
+
+    /* potência média entregue (0..1) nos próximos dt segundos */
+    double passo(uint16_t duty, double dt) {
+        if (s_ == SAIDA_PWM_IDEAL) return static_cast<double>(duty) / PWM_MAX_DUTY;
+
+        double fim = t_ + dt, soma = 0;
+        while (zc_ * SEMICICLO <= fim) {
+            double tz = zc_ * SEMICICLO;
+            soma += nivel_ * (tz - t_);
+            t_ = tz;
+            bool novo;
+            if (s_ == SAIDA_BURST) {
+                novo = mod_.step(duty, PWM_MAX_DUTY);
+            } else {
+                // SSR com disparo em zero amostra a entrada PWM na passagem
+                double fase = (tz + FASE_PWM) * PWM_FREQUENCY;
+                novo = (fase - std::floor(fase)) < static_cast<double>(duty) / (PWM_MAX_DUTY + 1);
+            }
+            if (novo != (nivel_ > 0)) ++comutacoes_;
+            nivel_ = novo ? 1.0 : 0.0;
+            ++zc_;
+        }
+        soma += nivel_ * (fim - t_);
+        t_ = fim;
+        return soma / dt;
+    }
+
+    long comutacoes() const { return comutacoes_; }
+
+private:
+    static constexpr double FASE_PWM = 1e-4;   // s, defasagem PWM x rede
+    Saida              s_;
+    BurstFireModulator mod_;
+    double             t_ = 0, nivel_ = 0;
+    long               zc_ = 1, comutacoes_ = 0;
+};
+
+/* ---------- estratificação térmica (diferença entre as sondas) ----------
+ * Cresce com a potência do aquecedor e é desfeita pela convecção
+ * natural e pelo misturador:  dΔ/dt = kS·u − (kD0 + kD1·vel)·Δ
+ * Sem mistura e a plena potência Δ → 3,3 °C; com o misturador a 100 %
+ * Δ → 0,2 °C. */
+struct Estratificacao {
+    double kS = 0.01, kD0 = 0.003, kD1 = 0.05;
+    double delta = 0;
+    void passo(double u, double vel, double dt) {
+        delta += (kS * u - (kD0 + kD1 * vel) * delta) * dt;
+    }
+};
+
+/* ---------- ruído gaussiano determinístico (LCG + Box-Muller) ---------- */
+class Ruido {
+public:
+    explicit Ruido(double sigma, uint32_t semente = 12345) : sigma_(sigma), s_(semente) {}
+    double operator()() {
+        if (sigma_ <= 0) return 0;
+        double u1 = (proximo() + 1.0) / 4294967297.0;
+        double u2 =  proximo()        / 4294967296.0;
+        return sigma_ * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+    }
+    /** Uniforme em [0, 1) (sorteio de leituras com erro). */
+    double uniforme() { return proximo() / 4294967296.0; }
+private:
+    uint32_t proximo() { s_ = s_ * 1664525u + 1013904223u; return s_; }
+    double   sigma_;
+    uint32_t s_;
+};
+
+/* ---------- réplica do algoritmo PID_v1 (v1.2.x) ---------- */
+class PidV1 {
+public:
+    PidV1(double kp, double ki, double kd, double dt)
+        : kp_(kp), ki_(ki * dt), kd_(kd / dt) {}
+
+    /* SetOutputLimits(): em automático também limita o integrador */
+    void limites(double lo, double hi) {
+        lo_ = lo; hi_ = hi;
+        if (auto_) sum_ = clamp(sum_);
+    }
+
+    /* SetMode(): na passagem para automático chama Initialize() */
+    void modo(bool automatico, double in, double out) {
+        if (automatico && !auto_) { sum_ = clamp(out); lastIn_ = in; }
+        auto_ = automatico;
+    }
+    bool automatico() const { return auto_; }
+
+    double compute(double in, double sp) {
+        double err = sp - in;
+        double dIn = in - lastIn_;
+        sum_ += ki_ * err;
+        sum_ = clamp(sum_);
+        double out = clamp(kp_ * err + sum_ - kd_ * dIn);
+        lastIn_ = in;
+        return out;
+    }
+
+private:
+    double clamp(double v) const { return v < lo_ ? lo_ : (v > hi_ ? hi_ : v); }
+    double kp_, ki_, kd_;
+    double lo_ = 0, hi_ = 255;
+    double sum_ = 0, lastIn_ = 0;
+    bool   auto_ = true;
+};
+
+/* ---------- configuração e resultado de uma execução ---------- */
+/* NENHUM: sem estratificação (sondas só diferem pela inércia) */
+enum Mixer { MIXER_NENHUM, MIXER_BINARIO, MIXER_VELOCIDADE };
+
+/* defeito injetado em tFalha (cenário falhas) */
+enum Falha {
+    FALHA_NENHUMA,
+    FALHA_AQUECEDOR,      // resistência aberta: planta não recebe potência
+    FALHA_SSR_CURTO,      // SSR em curto: plena potência sempre
+    FALHA_SONDA1_TRAVADA, // sonda 1 devolve sempre a mesma leitura
+    FALHA_SONDA2_SOLTA,   // sonda 2 fora do líquido: vai para o ambiente (τ 60 s)
+    FALHA_DUTY_PRESO,     // controle travado em plena potência (só o corte age na saída)
+    FALHA_I2C_MUDO,       // nenhuma leitura I²C válida (valores retidos)
+    FALHA_SONDA1_PICOS,   // 2 % das leituras da sonda 1 com um bit trocado
+    FALHA_SONDA1_DEGRADADA, // sonda 1: metade das leituras perdidas, 20 % com bit trocado
+};
+
+/* espelha CtrlMode de ConfigManager.h (que depende da NVS) */
+enum CtrlMode { CTRL_PID = 0, CTRL_APPROACH = 1, CTRL_MPC = 2 };
+
+/* desvio de fábrica de uma sonda (°C) em função da temperatura real:
+ * deslocamento, erro de ganho e curvatura em torno de 50 °C */
+struct ErroSonda {
+    double offset = 0, ganho = 0, curva = 0;
+    double operator()(double c) const {
+        const double u = (c - 50.0) / 50.0;
+        return offset + ganho * (c - 50.0) + curva * u * u;
+    }
+};
+
+struct SimConfig {
+    bool     preheat = false;
+    CtrlMode modo    = CTRL_PID;
+    bool     smith   = false;
+    bool     antiWindup = true; // CTRL_PID: plena potência até a banda e pré-carga (pidWindup)
+    bool     fusao   = true;    // PV = estimador (firmware) ou só a sonda 1
+    double   ruido   = 0;       // desvio-padrão do ruído das sondas, °C
+    bool     ff      = false;   // feed-forward de perdas
+    double   erroModelo = 1.0;  // fator sobre a perda inicial do modelo
+    Saida    saida   = SAIDA_PWM_IDEAL;
+    Mixer    mixer   = MIXER_NENHUM;
+    double   kp = Kp, ki = Ki, kd = Kd;
+    FopdtIdentifier::Params ident;
+    FaultDetector::Params   deteccao;
+    MpcController::Params   mpc;
+    Falha    falha  = FALHA_NENHUMA;
+    double   tFalha = 0;        // s
+    double   perdaX = 1.0;      // perda da planta × perdaX a partir de tPerda (tampa aberta)
+    double   tPerda = -1;       // s (< 0: sem perturbação)
+    double   tFim   = 6 * 3600; // s, limite da execução
+    bool     leitura8 = false;  // sondas de 1 byte (°C inteiros), antes do Q8.8
+    uint16_t acqHz    = 20;     // leituras por sonda por segundo (divisor de 100; 1 = sem filtro)
+    uint8_t  acqOrdem = 1;      // DecimationFilter: 1 = média móvel, 2 = CIC
+    uint8_t  acqIir   = 0;      // IIR na saída (0 = sem)
+    bool     guarda   = true;   // ProbeGuard nas leituras cruas (failover entre sondas)
+    SensorType sonda  = SENSOR_SLAVE_SIM;   // ProbeDriver: como a sonda converte
+    uint8_t  bits     = 0;      // resolução dos TMP75 (0 = a maior que cabe no período)
+    uint32_t i2cHz    = I2C_HZ;
+    ErroSonda erro[2];          // desvio de cada sonda (RF-01 pede ±0,5 °C)
+    int      calPontos = 0;     // pontos de calibração antes da receita (0 = sem)
+};
+
+struct SimResultado {
+    double tempoTotal   = 0;   // s até END_PROCESS
+    double maxAcima     = 0;   // maior (T - sp) com cronômetro correndo
+    double maxAbaixo    = 0;   // maior (sp - T) com cronômetro correndo
+    double foraBanda    = 0;   // s com |T - sp| > 1 e cronômetro correndo
+    double iae          = 0;   // ∫|T - sp|·dt com cronômetro correndo (°C·s)
+    double aproximacao  = 0;   // s com o cronômetro parado (temp_wrong)
+    double energia      = 0;   // s equivalentes a plena potência
+    double atividade    = 0;   // média de |Δduty| por ciclo do PID (contagens)
+    long   comutacoes   = 0;   // liga/desliga do SSR (saídas com SSR)
+    double energiaMixer = 0;   // s equivalentes a velocidade plena (P ∝ vel³)
+    long   partidas     = 0;   // partidas do motor do misturador
+    double estratificado = 0;  // s com estratificação real > 1 °C
+    double maxEstrat    = 0;   // °C
+    EnergyMeter contas{static_cast<float>(PID_DT), PWM_MAX_DUTY};   // RF-10
+    FopdtIdentifier ident;                                           // sonda 1 + duty
+    FaultDetector   deteccao;                                        // RF-07
+    double tDeteccao[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };         // s, por bit de falha
+    double tVisivel   = -1;    // s, a falha injetada passa a contradizer o duty/modelo
+    int    janelaMax  = 0;     // amostras, maior janela do FaultDetector na execução
+    std::vector<float> eta;          // EtaEstimator::remaining() a cada segundo
+    std::vector<float> etaPatamares; // só os patamares restantes (sem rampas)
+    double mpcUsMed = 0;   // custo médio de MpcController::update() no host
+    OverTempGuard::Trip motivoCorte = OverTempGuard::TRIP_NONE;
+    double tCorte     = -1;    // s, corte de segurança (OverTempGuard)
+    double latCorteMs = 0;     // da leitura (ou do fim do timeout) ao corte
+    double tLimite    = -1;    // s, massa passou do limite do corte
+    double picoMassa  = 0;     // °C, máximo da massa na execução
+    double erroLeitura    = 0; // °C, maior |sonda 1 entregue a 1 Hz − sonda 1 real| (RF-01: 0,5)
+    double erroLeituraRms = 0; // °C
+    uint32_t rejeitadas[2] = { 0, 0 };  // ProbeGuard: leituras recusadas por sonda
+    uint32_t perdidas[2]   = { 0, 0 };
+    double tFailover = -1;     // s, primeira vez que uma sonda saiu do controle
+    double tRetorno  = -1;     // s, as duas de volta depois do failover
+    I2cStats i2c;              // contadores e latência por sonda (I2cAcquisition)
+    uint32_t cicloI2cMaxUs = 0;
+};
+
+/* corte de segurança: a ação e o relógio do OverTempGuard são funções
+ * simples, como HeaterOutput::inhibit e esp_timer_get_time no firmware */
+/* leitura I²C de uma sonda em centésimos: 2 bytes Q8.8 (firmware) ou
+ * o byte de °C inteiros de antes (SimConfig::leitura8); `erro` troca
+ * bits da palavra recebida (ruído no barramento); `lsb` > 0 trunca na
+ * resolução do conversor (LM75/TMP75) */
+static centi_t lerSonda(double c, bool leitura8, uint16_t erro = 0, float lsb = 0)
+{
+    if (leitura8) return tempFromC(static_cast<int8_t>(std::lround(c)));
+    if (lsb > 0) c = std::floor(c / lsb) * lsb;
+    const int16_t q = static_cast<int16_t>(tempToQ8_8(static_cast<float>(c)) ^ erro);
+    const uint8_t b[2] = { static_cast<uint8_t>(q >> 8), static_cast<uint8_t>(q & 0xFF) };
+    return tempFromBytes(b);
+}
+
+/* tempo de barramento de uma transação da sonda: bytes de 9 bits
+ * (8 + ACK), início/fim e repetição de início, mais o custo fixo do
+ * driver por transação (fila, ISR). Escravo e LM75: endereço + 2
+ * bytes; TMP75: ponteiro, leitura e, numa segunda transação, o
+ * disparo. NACK: só o endereço. */
+constexpr uint32_t I2C_OVERHEAD_US = 25;     // por transação, estimado
+static uint32_t tempoI2cUs(const ProbeDriver& d, uint32_t hz, bool nack)
+{
+    uint32_t bits = 2 + 9 * (nack ? 1 : 3), partes = 1;
+    if (!nack && d.setPointer()) bits += 1 + 9 * 2;
+    if (!nack && d.oneShot()) {
+        bits += 2 + 9 * 3;
+        ++partes;
+    }
+    return static_cast<uint32_t>((bits * 1000000ull + hz - 1) / hz) + partes * I2C_OVERHEAD_US;
+}
+
+/* calibração como no firmware ("CALxx=TT.TT"): sonda no banho de
+ * referência, média crua da janela de captura (10 s a 20 Hz) e um
+ * ponto por referência */
+static const double CAL_REFS[][4] = { {}, { 65 }, { 20, 95 }, { 20, 65, 95 } };
+static void calibrar(SensorCalibration& cal, const ErroSonda& erro, int pontos, double sigma, uint32_t semente)
+{
+    Ruido ruido(sigma, semente);
+    for (int i = 0; i < pontos && i < 3; ++i) {
+        const double ref = CAL_REFS[pontos][i];
+        CalibrationCapture cap;
+        cap.begin(10 * 20);
+        while (cap.result() == CalibrationCapture::CAP_RUNNING)
+            cap.add(lerSonda(ref + erro(ref) + ruido(), false));
+        if (cap.result() == CalibrationCapture::CAP_DONE)
+            cal.addPoint(cap.mean(), tempFromFloat(static_cast<float>(ref)));
+    }
+}
+
+static bool     g_corte = false;
+static uint32_t g_simUs = 0;
+static void     corteSim()   { g_corte = true; }
+static uint32_t relogioSim() { return g_simUs; }
+
+static SimResultado simular(const SimConfig& cfg, const Receita& rc,
+                            const PlantaParams& pp)
+{
+    PlantaTermica planta(pp);
+    PidV1 pid(cfg.kp, cfg.ki, cfg.kd, PID_DT);
+    pid.limites(0, PWM_MAX_DUTY);
+
+    PreheatLookahead preheat;
+    preheat.setEnabled(cfg.preheat);
+
+    // modelo conhecido exatamente (tempo morto aparente = atraso + sonda)
+    ThermalModel modelo;
+    modelo.heatGain = static_cast<float>(pp.ganho);
+    modelo.lossCoef = static_cast<float>(pp.perda);
+    modelo.ambient  = static_cast<float>(pp.ambiente);
+    modelo.deadTime = static_cast<float>(pp.atraso + pp.tauSonda);
+    modelo.lossCoef *= static_cast<float>(cfg.erroModelo);
+    ApproachController approach;
+    approach.setEnabled(cfg.modo == CTRL_APPROACH);
+    ApproachController pidWindup({ PID_WINDUP_BAND, PID_WINDUP_BAND, false });   // como no PidTask
+    pidWindup.setEnabled(cfg.modo == CTRL_PID && cfg.antiWindup);
+    SmithPredictor smith;
+    smith.setEnabled(cfg.smith);
+    MpcController mpc(cfg.mpc);
+    mpc.setEnabled(cfg.modo == CTRL_MPC);
+    double mpcDuty = 0;
+    long   mpcN = 0;
+    long   nLeituras = 0;
+    SaidaAquecedor saida(cfg.saida);
+    Estratificacao estrat;
+    MixerController mixer;
+    bool   mixerLigado = false;
+    double mixerVel = 0;
+    TempEstimator  estimador;
+    EtaEstimator   eta;
+    LossFeedForward feedForward;
+    feedForward.setEnabled(cfg.ff);
+    double ffAplicado = 0, ffSp = 0;
+    Ruido ruido1(cfg.ruido, 1), ruido2(cfg.ruido, 2);
+    double pidOut = 0;
+    double dutySoma = 0;
+    long   dutyN = 0;
+
+    const std::vector<centi_t> temps = centesimos(rc);   // receita como na NVS
+    OverTempGuard corte(corteSim, relogioSim);
+    corte.setCurve(temps.data(), static_cast<int>(temps.size()));
+    g_corte = false;
+    g_simUs = 0;
+    corte.arm(0);
+
+    SimResultado r;
+    r.ident = FopdtIdentifier(cfg.ident);
+    r.deteccao = FaultDetector(cfg.deteccao);
+    size_t   idx = 0;
+    centi_t  sp = temps[0];         // cb.setPoint / cb.nextSetPoint
+    centi_t  spNext = temps.size() > 1 ? temps[1] : TEMP_INVALID;
+    int32_t  secLeft = static_cast<int32_t>(rc.durs[0]);
+    bool     running = secLeft > 0;
+    bool     avaliado = false;      // TempTask já avaliou a etapa atual
+    centi_t  s1 = lerSonda(planta.sonda(),  cfg.leitura8);   // g_sensor1/2
+    centi_t  s2 = lerSonda(planta.sonda2(), cfg.leitura8);
+    centi_t  l1 = s1, l2 = s2;      // última leitura aceita de cada sonda
+    centi_t  cru1 = s1;             // o que a sonda 1 devolve (fica parado se travada)
+    bool     novas[2] = { false, false };   // leitura aceita no segundo atual
+    // conversão sem espera: one-shot entrega na leitura seguinte o que
+    // disparou nesta (amostrado no disparo); mais lenta que o período,
+    // a sonda é lida a cada `every` leituras
+    ProbeDriver driver[2];
+    for (ProbeDriver& d : driver) d.configure(cfg.sonda, cfg.bits, 1000000u / cfg.acqHz);
+    const float lsb = cfg.sonda == SENSOR_SLAVE_SIM ? 0.0f : driver[0].lsbC();
+    r.deteccao.setResolution(cfg.leitura8 ? 1.0f : driver[0].lsbC());   // como no I2CTask
+    centi_t  conv[2] = { s1, s2 };  // conversão em curso (one-shot)
+    ProbeGuard::Params gp;
+    gp.dt       = static_cast<float>(driver[0].every()) / cfg.acqHz;
+    gp.maxSlope = 2.0f * modelo.heatGain;   // PROBE_SLOPE_K
+    ProbeGuard guarda[2] = { ProbeGuard(gp), ProbeGuard(gp) };
+    corte.setMaxSlope(gp.maxSlope);          // como no I2CTask
+    SensorCalibration cal[2];
+    for (int p = 0; p < 2; ++p) calibrar(cal[p], cfg.erro[p], cfg.calPontos, cfg.ruido, 40 + p);
+    Ruido    erros(0, 7);           // sorteio das leituras com erro
+    uint8_t  emControle = 0x03;
+    DecimationFilter filtro1({ cfg.acqOrdem, cfg.acqHz, cfg.acqIir });
+    DecimationFilter filtro2({ cfg.acqOrdem, cfg.acqHz, cfg.acqIir });
+    const long ticksLeitura = TICKS_PER_S / cfg.acqHz;
+    float    est = tempToC(s1);     // g_tempEst
+    uint16_t duty = 0, dutyAnt = 0;
+
+    r.contas.startBrew();                      // entrada de READY
+    const long maxTicks = std::lround(cfg.tFim * TICKS_PER_S);
+    for (long tick = 0; tick < maxTicks; ++tick) {
+        /* PidTask (100 Hz) */
+        float  pv0   = cfg.fusao ? est : tempToC(s1);
+        float  spC   = tempToC(sp), nextC = tempToC(spNext);   // como no PidTask
+        double pidSp = preheat.controlSetPoint(spC, nextC, pv0, secLeft, running);
+        double pv    = smith.update(pv0, static_cast<float>(duty) / PWM_MAX_DUTY,
+                                    static_cast<float>(PID_DT), modelo);
+        double ff = std::round(feedForward.duty(pidSp, modelo) * PWM_MAX_DUTY);
+        if (ff != ffAplicado) {
+            // modelo reaprendido com o mesmo set-point: o integrador devolve
+            // a parte da diferença que já compensava, como no PidTask
+            const double d = ff - ffAplicado;
+            const double i = pidOut - cfg.kp * (pidSp - pv);   // sem o P (D ~ 0 no patamar)
+            if (pidSp == ffSp && pid.automatico() && i * d > 0) {
+                pidOut = std::fabs(d) >= std::fabs(i) ? 0 : i - d;
+                pid.modo(false, pv, pidOut);
+                pid.limites(-ff, PWM_MAX_DUTY - ff);
+                pid.modo(true, pv, pidOut);
+            }
+            pid.limites(-ff, PWM_MAX_DUTY - ff);
+            ffAplicado = ff;
+        }
+        ffSp = pidSp;
+        if (mpc.enabled()) {
+            // uma decisão por segundo, como no PidTask
+            if (tick % TICKS_PER_S == 0) {
+                auto t0 = std::chrono::steady_clock::now();
+                mpcDuty = mpc.update(spC, nextC, pv0, secLeft, running, modelo);
+                double us = std::chrono::duration<double, std::micro>(
+                                std::chrono::steady_clock::now() - t0).count();
+                r.mpcUsMed += us;
+                ++mpcN;
+            }
+            pid.modo(false, pv, pidOut);
+            pidOut = std::round(mpcDuty * PWM_MAX_DUTY) - ff;
+        } else if (approach.update(spC, pv0, modelo) || pidWindup.update(spC, pv0, modelo)) {
+            pid.modo(false, pv, pidOut);
+            pidOut = PWM_MAX_DUTY - ff;
+        } else {
+            float uss = -1.0f;                       // como no PidTask
+            if (approach.takeHandover())  uss = approach.steadyDuty(pidSp, modelo);
+            if (pidWindup.takeHandover()) uss = pidWindup.steadyDuty(pidSp, modelo);
+            if (uss >= 0.0f) pidOut = uss * PWM_MAX_DUTY - ff;
+            pid.modo(true, pv, pidOut);
+            pidOut = pid.compute(pv, pidSp);
+        }
+        duty = static_cast<uint16_t>(std::min(std::max(pidOut + ff, 0.0), double(PWM_MAX_DUTY)));
+        if (r.deteccao.faults() & FaultDetector::FAULT_HEATER) duty = 0;   // como no PidTask
+        const double t  = (tick + 1) * PID_DT;
+        if (cfg.tPerda >= 0 && t > cfg.tPerda && t <= cfg.tPerda + PID_DT) planta.perda(pp.perda * cfg.perdaX);
+        const bool   emFalha = cfg.falha != FALHA_NENHUMA && t > cfg.tFalha;
+        // a falha só se mostra quando o processo a contradiz: resistência
+        // aberta com duty alto, SSR em curto com duty baixo, sonda travada
+        // numa rampa (no patamar a deriva da malha fechada não segue o
+        // modelo e o FaultDetector não a usa)
+        if (emFalha && r.tVisivel < 0 &&
+            ((cfg.falha == FALHA_AQUECEDOR && duty >= cfg.deteccao.heatDutyMin * PWM_MAX_DUTY) ||
+             (cfg.falha == FALHA_SSR_CURTO && duty <= (1.0f - cfg.deteccao.idleFrac) * PWM_MAX_DUTY) ||
+             (cfg.falha == FALHA_SONDA1_TRAVADA && !running)))
+            r.tVisivel = t;
+        if (emFalha && cfg.falha == FALHA_DUTY_PRESO) duty = PWM_MAX_DUTY;
+        // timer do corte (5 ms no firmware; aqui a cada ciclo) e saída inibida
+        g_simUs = static_cast<uint32_t>(std::llround(tick * PID_DT * 1e6));
+        corte.poll(g_simUs);
+        if (g_corte) duty = 0;
+        double potencia = saida.passo(duty, PID_DT);
+        if (emFalha && cfg.falha == FALHA_AQUECEDOR) potencia = 0.0;
+        if (emFalha && cfg.falha == FALHA_SSR_CURTO) potencia = 1.0;
+        planta.passo(potencia, PID_DT);
+        if (cfg.mixer != MIXER_NENHUM) {
+            estrat.passo(potencia, mixerVel, PID_DT);
+            r.energiaMixer += mixerVel * mixerVel * mixerVel * PID_DT;
+            if (estrat.delta > 1.0) r.estratificado += PID_DT;
+            if (estrat.delta > r.maxEstrat) r.maxEstrat = estrat.delta;
+        }
+        if (planta.bulk() > r.picoMassa) r.picoMassa = planta.bulk();
+        if (planta.bulk() > corte.limit() && r.tLimite < 0) r.tLimite = t;
+        if (corte.tripped() && r.tCorte < 0) {
+            r.tCorte      = t;
+            r.motivoCorte = corte.reason();
+            r.latCorteMs  = corte.latencyUs() / 1000.0;
+        }
+        r.energia   += potencia * PID_DT;
+        r.atividade += std::abs(static_cast<int>(duty) - static_cast<int>(dutyAnt));
+        dutyAnt      = duty;
+        dutySoma    += duty;
+        ++dutyN;
+        r.contas.tick(static_cast<int>(idx), duty, mixerLigado);
+
+        if (running && avaliado) {
+            double e = planta.bulk() - tempToC(sp);
+            if (e > r.maxAcima)   r.maxAcima = e;
+            if (-e > r.maxAbaixo) r.maxAbaixo = -e;
+            if (std::fabs(e) > 1.0) r.foraBanda += PID_DT;
+            r.iae += std::fabs(e) * PID_DT;
+        }
+        if (!running && avaliado) r.aproximacao += PID_DT;
+
+        /* I2CTask (acqHz): leituras cruas → ProbeGuard → corte de segurança → filtro */
+        if ((tick + 1) % ticksLeitura == 0) {
+            // bit trocado e leitura perdida (sorteios só com a falha ativa)
+            const bool picos  = emFalha && cfg.falha == FALHA_SONDA1_PICOS;
+            const bool degrad = emFalha && cfg.falha == FALHA_SONDA1_DEGRADADA;
+            uint16_t erro1  = 0;
+            bool     perdeu = false;
+            if (picos || degrad) {
+                if (erros.uniforme() < (picos ? 0.02 : 0.2))
+                    erro1 = static_cast<uint16_t>(1u << static_cast<int>(erros.uniforme() * 16));
+                perdeu = degrad && erros.uniforme() < 0.5;
+            }
+            centi_t nova1 = lerSonda(planta.sonda() + cfg.erro[0](planta.sonda()) + ruido1(),
+                                     cfg.leitura8, erro1, lsb);
+            double  v2    = planta.sonda2() + estrat.delta;
+            v2 += cfg.erro[1](v2) + ruido2();
+            if (emFalha && cfg.falha == FALHA_SONDA2_SOLTA)
+                v2 = pp.ambiente + (v2 - pp.ambiente) * std::exp(-(t - cfg.tFalha) / 60.0);
+            // sonda solta: as duas passaram de divLimit
+            if (emFalha && r.tVisivel < 0 && cfg.falha == FALHA_SONDA2_SOLTA &&
+                std::fabs(planta.sonda() - v2) >= cfg.deteccao.divLimit)
+                r.tVisivel = t;
+            const bool mudo = emFalha && cfg.falha == FALHA_I2C_MUDO;
+            if (!(emFalha && cfg.falha == FALHA_SONDA1_TRAVADA)) cru1 = nova1;
+            centi_t agora[2] = { cru1, lerSonda(v2, cfg.leitura8, 0, lsb) };
+            ProbeDriver::Step passo[2];
+            for (int p = 0; p < 2; ++p) {
+                passo[p] = driver[p].step();
+                if (passo[p] != ProbeDriver::STEP_IDLE && driver[p].oneShot()) std::swap(conv[p], agora[p]);
+            }
+            centi_t lido[2] = { mudo || perdeu ? TEMP_INVALID : agora[0],
+                                mudo ? TEMP_INVALID : agora[1] };
+            // barramento: leitura perdida = NACK, mudo = prazo estourado
+            uint32_t ciclo = 0;
+            for (int p = 0; p < 2; ++p) {
+                if (passo[p] == ProbeDriver::STEP_IDLE) continue;
+                const I2cStats::Outcome o = mudo ? I2cStats::OUT_TIMEOUT
+                                          : (p == 0 && perdeu) ? I2cStats::OUT_NACK : I2cStats::OUT_OK;
+                const uint32_t us = o == I2cStats::OUT_TIMEOUT ? I2C_TIMEOUT_US
+                                  : tempoI2cUs(driver[p], cfg.i2cHz, o == I2cStats::OUT_NACK);
+                r.i2c.record(p, o, us);
+                ciclo += us;
+            }
+            if (ciclo > r.cicloI2cMaxUs) r.cicloI2cMaxUs = ciclo;
+            // crua passa pelo corte, como no I2CTask (sonda sem saúde só
+            // a aceita); recusada ou perdida (ou sem conversão nova)
+            // repete a anterior
+            g_simUs = static_cast<uint32_t>(std::llround(t * 1e6));
+            for (int p = 0; p < 2; ++p) {
+                if (passo[p] != ProbeDriver::STEP_READ) continue;
+                const centi_t c = cal[p].apply(lido[p]);
+                const centi_t x = cfg.guarda ? guarda[p].sample(c) : c;
+                const centi_t g = !cfg.guarda || guarda[p].healthy() ? c : x;
+                if (g != TEMP_INVALID) corte.sample(p, tempToC(g), g_simUs);
+                if (x == TEMP_INVALID) continue;
+                (p ? l2 : l1) = x;
+                novas[p] = true;
+            }
+            filtro1.push(l1);
+            filtro2.push(l2);
+        }
+
+        if ((tick + 1) % TICKS_PER_S) continue;
+
+        /* I2CTask (1 Hz): saída decimada + estimador com o duty médio do segundo */
+        {
+            // só a sonda com leitura aceita no segundo é atualizada
+            if (novas[1]) s2 = filtro2.output();
+            if (novas[0]) {
+                s1 = filtro1.output();
+                const double e1 = tempToC(s1) - planta.sonda();
+                if (std::fabs(e1) > r.erroLeitura) r.erroLeitura = std::fabs(e1);
+                r.erroLeituraRms += e1 * e1;
+                ++nLeituras;
+            }
+            // saúde das sondas: failover do controle para a saudável
+            const uint8_t saudaveis = (guarda[0].healthy() ? 0x01 : 0) | (guarda[1].healthy() ? 0x02 : 0);
+            const uint8_t antes = emControle;
+            emControle = saudaveis ? saudaveis : 0x03;
+            if (emControle != 0x03 && r.tFailover < 0) r.tFailover = t;
+            if (emControle == 0x03 && antes != 0x03 && r.tFailover >= 0) r.tRetorno = t;
+            const float z[TempEstimator::NUM_PROBES]     = { tempToC(s1), tempToC(s2) };
+            const bool  ok[FaultDetector::NUM_PROBES]    = { novas[0], novas[1] };
+            novas[0] = novas[1] = false;
+            float u = static_cast<float>(dutySoma / dutyN / PWM_MAX_DUTY);
+            dutySoma = 0;
+            dutyN    = 0;
+            r.deteccao.update(z, ok, u, modelo);
+            const int janela = r.deteccao.window(modelo);
+            r.janelaMax = std::max(r.janelaMax, janela);
+            for (int b = 0; b < 8; ++b)
+                if ((r.deteccao.faults() & (1u << b)) && r.tDeteccao[b] < 0) r.tDeteccao[b] = t;
+            estimador.setProbeNoise(r.deteccao.resolution(), r.deteccao.noise());   // como no I2CTask
+            // sonda travada ou degradada sai da fusão, como no I2CTask
+            const bool valid[TempEstimator::NUM_PROBES] = { !r.deteccao.stuck(0) && (emControle & 0x01),
+                                                            !r.deteccao.stuck(1) && (emControle & 0x02) };
+            estimador.update(z, valid, u, 1.0f, modelo);
+            est = estimador.temperature();
+            feedForward.learn(est, u, 1.0f, modelo);
+            r.ident.update(tempToC((emControle & 0x01) ? s1 : s2), u);
+        }
+
+        /* TimerTask (1 Hz): fim do patamar → next_curve / set_next_curve */
+        if (running && --secLeft == 0) {
+            running = false;
+            if (++idx >= rc.temps.size()) {
+                r.tempoTotal = (tick + 1) * PID_DT;
+                r.atividade /= tick + 1;
+                if (mpcN) r.mpcUsMed /= mpcN;
+                r.erroLeituraRms = std::sqrt(r.erroLeituraRms / nLeituras);
+                r.comutacoes = saida.comutacoes();
+                for (int p = 0; p < 2; ++p) {
+                    r.rejeitadas[p] = guarda[p].rejected();
+                    r.perdidas[p]   = guarda[p].missed();
+                }
+                return r;
+            }
+            sp      = temps[idx];
+            spNext  = idx + 1 < temps.size() ? temps[idx + 1] : TEMP_INVALID;
+            secLeft = static_cast<int32_t>(rc.durs[idx]);
+            running  = secLeft > 0;
+            avaliado = false;
+        }
+
+        /* TempTask (1 Hz): temp_wrong / temp_right */
+        running  = secLeft > 0 && !((tempToC(sp) - pv0) > 1);
+        avaliado = true;
+        preheat.updateRate(pv0, static_cast<float>(duty) / PWM_MAX_DUTY, 1.0f);
+
+        /* TempTask (1 Hz): tempo restante da receita */
+        {
+            uint32_t durs[32];
+            const int n = static_cast<int>(std::min<size_t>(temps.size(), 32));
+            float soma = secLeft;
+            for (int i = 0; i < n; ++i) {
+                durs[i]  = rc.durs[i];
+                if (i > static_cast<int>(idx)) soma += durs[i];
+            }
+            eta.learn(pv0, static_cast<float>(duty) / PWM_MAX_DUTY, 1.0f, modelo);
+            eta.setHoldLift(preheat.lift());
+            eta.update(temps.data(), durs, n, static_cast<int>(idx), secLeft, running, pv0, 1.0f, modelo);
+            r.eta.push_back(eta.remaining());
+            r.etaPatamares.push_back(soma);
+        }
+
+        /* TempTask (1 Hz): misturador (sem gradiente com uma sonda só) */
+        bool antes = mixerLigado;
+        if (cfg.mixer == MIXER_BINARIO) {
+            mixerLigado = std::abs(s1 - s2) > tempFromC(1);   // lei original
+            mixerVel    = mixerLigado ? 1.0 : 0.0;
+        } else if (cfg.mixer == MIXER_VELOCIDADE) {
+            if (emControle == 0x03) mixer.update(tempToC(s1), tempToC(s2), 1.0f);
+            else                    mixer.updateBlind(1.0f);
+            mixerLigado = mixer.running();
+            mixerVel    = mixer.speed();
+        }
+        if (mixerLigado && !antes) ++r.partidas;
+    }
+    r.tempoTotal = maxTicks * PID_DT;
+    r.atividade /= maxTicks;
+    if (mpcN) r.mpcUsMed /= mpcN;
+    if (nLeituras) r.erroLeituraRms = std::sqrt(r.erroLeituraRms / nLeituras);
+    r.comutacoes = saida.comutacoes();
+    for (int p = 0; p < 2; ++p) {
+        r.rejeitadas[p] = guarda[p].rejected();
+        r.perdidas[p]   = guarda[p].missed();
+    }
+    return r;
+}
+
+/* ---------- escalonador FreeRTOS simplificado (cenário jitter) ----------
+ * Prioridade fixa preemptiva, tick de 1 ms com fatiamento de tempo
+ * entre tarefas de mesma prioridade, 1 ou 2 núcleos e afinidade
+ * opcional. Cada iteração de uma tarefa é uma sequência de trechos de
+ * CPU e de bloqueio (espera de I²C). vTaskDelay conta a partir do tick
+ * em que a tarefa termina; vTaskDelayUntil a partir da liberação
+ * anterior. Os tempos de execução são estimativas do firmware atual.
+ * printf escreve direto na FIFO de TX da UART (128 bytes, 9600 bd):
+ * com a FIFO cheia a task fica em espera ocupada, segurando a CPU. */
+constexpr uint32_t SCHED_DT_US  = 5;
+constexpr uint32_t TICK_US      = 1000;
+constexpr uint32_t UART_FIFO    = 128;
+constexpr uint32_t US_POR_CHAR  = 1042;        // 10 bits a 9600 bd
+
+struct Trecho { bool cpu; uint32_t us; uint32_t varUs; uint32_t chars = 0; };
+
+struct TarefaSim {
+    const char*         nome;
+    int                 prio;
+    int                 nucleo;        // -1 = qualquer (tskNO_AFFINITY)
+    uint32_t            periodoMs;     // 0 = sempre pronta (loopTask)
+    bool                delayUntil;
+    std::vector<Trecho> trechos;
+    bool                instrumentada = false;   // PidTask
+
+    // estado
+    uint64_t liberacao = 0;
+    size_t   trecho    = 0;
+    int64_t  resta     = 0;
+    uint32_t faltaChars = 0;
+    bool     ativa     = false;       // dentro de uma iteração
+    bool     iniciou   = false;       // já recebeu CPU nesta iteração
+    int      rodandoEm = -1;
+    uint64_t ordemRR   = 0;
+};
+
+class EscalonadorSim {
+public:
+    EscalonadorSim(std::vector<TarefaSim> t, int nucleos)
+        : t_(std::move(t)), nucleos_(nucleos) {}
+
+    void rodar(uint64_t duracaoUs, LoopStats& stats) {
+        for (TarefaSim& t : t_) t.liberacao = 0;
+        for (uint64_t agora = 0; agora < duracaoUs; agora += SCHED_DT_US) {
+            bool tick = (agora % TICK_US) == 0;
+            if (fifo_ && agora >= proxChar_) { --fifo_; proxChar_ = agora + US_POR_CHAR; }
+            if (!fifo_) proxChar_ = agora + US_POR_CHAR;
+            if (tick) fatiar();
+            liberar(agora);
+            escolher(tick);
+            executar(agora, stats);
+        }
+    }
+
+private:
+    uint32_t sorteio(uint32_t var) {
+        s_ = s_ * 1664525u + 1013904223u;
+        return var ? (s_ >> 8) % (2 * var + 1) : 0;
+    }
+
+    void carregaTrecho(TarefaSim& t) {
+        const Trecho& tr = t.trechos[t.trecho];
+        t.resta = static_cast<int64_t>(tr.us) - tr.varUs + sorteio(tr.varUs);
+        t.faltaChars = tr.chars;
+    }
+
+    void liberar(uint64_t agora) {
+        // tarefas acordadas no mesmo tick entram na fila em ordem arbitrária
+        size_t n = t_.size(), ini = sorteio(static_cast<uint32_t>(n)) % n;
+        for (size_t k = 0; k < n; ++k) {
+            TarefaSim& t = t_[(ini + k) % n];
+            if (t.ativa || agora < t.liberacao) continue;
+            t.ativa   = true;
+            t.iniciou = false;
+            t.trecho  = 0;
+            carregaTrecho(t);
+            t.ordemRR = ++rr_;
+        }
+    }
+
+    bool pronta(const TarefaSim& t) const {
+        return t.ativa && t.trechos[t.trecho].cpu;
+    }
+
+    // no tick, a tarefa em execução vai para o fim da fila da sua
+    // prioridade; as acordadas neste tick entram depois dela
+    void fatiar() {
+        for (TarefaSim& t : t_)
+            if (t.rodandoEm >= 0) t.ordemRR = ++rr_;
+    }
+
+    void escolher(bool tick) {
+
+        std::vector<int> dono(nucleos_, -1);
+        std::vector<bool> usada(t_.size(), false);
+        for (int c = 0; c < nucleos_; ++c) {
+            int melhor = -1;
+            for (size_t i = 0; i < t_.size(); ++i) {
+                const TarefaSim& t = t_[i];
+                if (usada[i] || !pronta(t)) continue;
+                if (t.nucleo >= 0 && t.nucleo != c) continue;
+                if (t.rodandoEm >= 0 && t.rodandoEm != c && !tick) continue;   // não migra no meio da fatia
+                if (melhor < 0) { melhor = static_cast<int>(i); continue; }
+                const TarefaSim& m = t_[melhor];
+                bool mantem = !tick && t.rodandoEm == c && t.prio == m.prio;
+                if (t.prio > m.prio || mantem ||
+                    (t.prio == m.prio && m.rodandoEm != c && t.ordemRR < m.ordemRR))
+                    melhor = static_cast<int>(i);
+            }
+            if (melhor >= 0) { dono[c] = melhor; usada[melhor] = true; }
+        }
+        for (TarefaSim& t : t_) t.rodandoEm = -1;
+        for (int c = 0; c < nucleos_; ++c)
+            if (dono[c] >= 0) t_[dono[c]].rodandoEm = c;
+    }
+
+    void executar(uint64_t agora, LoopStats& stats) {
+        for (TarefaSim& t : t_) {
+            if (!t.ativa) continue;
+            bool cpu = t.trechos[t.trecho].cpu;
+            if (cpu && t.rodandoEm < 0) continue;            // pronta, esperando CPU
+            if (cpu && !t.iniciou) {
+                t.iniciou = true;
+                if (t.instrumentada) stats.begin(agora);
+            }
+            if (t.resta > 0)
+                t.resta -= SCHED_DT_US;
+            else if (t.faltaChars && fifo_ < UART_FIFO) {
+                ++fifo_;
+                --t.faltaChars;
+            }
+            if (t.resta > 0 || t.faltaChars) continue;
+
+            if (++t.trecho < t.trechos.size()) { carregaTrecho(t); continue; }
+
+            /* fim da iteração */
+            uint64_t fim = agora + SCHED_DT_US;
+            if (t.instrumentada) stats.end(fim);
+            t.ativa = false;
+            t.rodandoEm = -1;
+            if (t.periodoMs == 0) {
+                t.liberacao = fim;
+            } else if (t.delayUntil) {
+                t.liberacao += t.periodoMs * 1000ull;
+                if (t.liberacao < fim)                         // atrasou: alcança a grade
+                    t.liberacao = (fim / TICK_US + 1) * TICK_US;
+            } else {
+                t.liberacao = (fim / TICK_US + t.periodoMs) * TICK_US;
+            }
+        }
+    }
+
+    std::vector<TarefaSim> t_;
+    int      nucleos_;
+    uint64_t rr_ = 0;
+    uint32_t s_  = 12345;
+    uint32_t fifo_     = 0;             // bytes na FIFO de TX
+    uint64_t proxChar_ = 0;
+};
+
+/* tarefas de app_tasks_init(), com afinidade/prioridades dadas */
+struct LayoutTarefas {
+    bool estNaI2C;                     // printf EST- na I2CTask (firmware anterior)
+    int pidPrio, pidNucleo;
+    int i2cPrio, i2cNucleo;
+    int tempPrio, tempNucleo;
+    int timerPrio, timerNucleo;
+    int uartPrio, uartNucleo;
+};
+
+/* antes: xTaskCreate com prioridades 3–5, sem afinidade, EST- na I2CTask */
+static const LayoutTarefas LAYOUT_ORIGINAL = { true, 4, -1, 4, -1, 4, -1, 5, -1, 3, -1 };
+/* TASK_LAYOUT_PINNED = 1: pid/i2c no núcleo 1, E/S no núcleo 0 */
+static const LayoutTarefas LAYOUT_PARTICIONADO = { false, 7, 1, 6, 1, 4, 0, 5, 0, 3, 0 };
+
+/* cargaES multiplica o volume de texto da serial (telemetria, GUI) */
+static std::vector<TarefaSim> tarefasFirmware(const LayoutTarefas& l, uint32_t cargaES)
+{
+    std::vector<TarefaSim> v;
+    // PID_v1 em double (sem FPU de double no ESP32) + Smith + escrita da saída
+    TarefaSim pid   { "pid",   l.pidPrio,   l.pidNucleo,   10,   true,  { {true, 150, 50} } };
+    pid.instrumentada = true;
+    v.push_back(pid);
+    const uint32_t EST = 40 * cargaES, DATA = 16 * cargaES;      // caracteres
+    // duas leituras I²C (bloqueia no driver) + estimador + feed-forward
+    v.push_back({ "i2c",   l.i2cPrio,   l.i2cNucleo,   1000, false,
+                  { {true, 60, 10}, {false, 250, 50}, {true, 30, 5}, {false, 250, 50},
+                    {true, 150, 30, l.estNaI2C ? EST : 0} } });
+    // statechart (2× withSM) + misturador + printf (EST) DATA
+    v.push_back({ "temp",  l.tempPrio,  l.tempNucleo,  1000, false,
+                  { {true, 600, 150, l.estNaI2C ? DATA : EST + DATA} } });
+    v.push_back({ "timer", l.timerPrio, l.timerNucleo, 1000, false, { {true, 10, 2} } });
+    // sondagem da serial; a cada ~5 s um comando da GUI com resposta
+    // longa (printConfig, pidstats)
+    v.push_back({ "uart",  l.uartPrio,  l.uartNucleo,  10,   false, { {true, 15, 5} } });
+    v.push_back({ "uart_resp", l.uartPrio, l.uartNucleo, 5000, false,
+                  { {true, 300, 100, 300 * cargaES} } });
+    // loop() vazio do Arduino: loopTask sempre pronta no núcleo 1
+    v.push_back({ "loop",  1, 1, 0, false, { {true, 1000, 0} } });
+    return v;
+}
+
+static LoopStats medirJitter(const LayoutTarefas& l, int nucleos, uint64_t duracaoUs,
+                             uint32_t cargaES = 1)
+{
+    LoopStats stats(10000);
+    std::vector<TarefaSim> t = tarefasFirmware(l, cargaES);
+    if (nucleos == 1)
+        for (TarefaSim& x : t) x.nucleo = (x.nucleo >= 0) ? 0 : -1;
+    EscalonadorSim esc(t, nucleos);
+    esc.rodar(duracaoUs, stats);
+    return stats;
+}
+
+static void imprimirJitter(const char* nome, const LoopStats& s)
+{
+    printf("%-28s n=%lu perdas=%lu periodo=[%lu,%lu]us calculo med=%.0fus max=%luus latencia max=%luus\n",
+           nome, (unsigned long)s.count(), (unsigned long)s.misses(),
+           (unsigned long)s.periodMin(), (unsigned long)s.periodMax(),
+           s.computeMean(), (unsigned long)s.computeMax(), (unsigned long)s.latencyMax());
+    printf("%-28s jitter:", "");
+    for (int i = 0; i < LoopStats::BINS; ++i)
+        if (s.jitterHist()[i])
+            printf(" <%lu:%lu", (unsigned long)LoopStats::binFloor(i + 1), (unsigned long)s.jitterHist()[i]);
+    printf("\n");
+}
+
+/* ---------- relatório ---------- */
+/* corte de segurança no meio da receita: ela não termina (total = tFim) */
+static void imprimir(const char* nome, const SimResultado& r)
+{
+    printf("%-22s total=%7.0f s  aprox=%6.0f s  acima=%5.2f  abaixo=%5.2f  fora_banda=%6.1f s  energia=%7.0f s  atividade=%6.1f",
+           nome, r.tempoTotal, r.aproximacao, r.maxAcima, r.maxAbaixo, r.foraBanda, r.energia,
+           r.atividade);
+    if (r.tCorte >= 0) printf("  CORTE em %.0f s", r.tCorte);
+    printf("\n");
+}
+
+/* ---------- verificações ---------- */
+static int g_falhas = 0;
+
+static void conferir(bool ok, const char* fmt, ...)
+{
+    printf("  [%s] ", ok ? "ok" : "FALHOU");
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+    if (!ok) ++g_falhas;
+}
+
+static bool terminou(const SimResultado& r, const SimConfig& cfg) { return r.tempoTotal < cfg.tFim; }
+
+static int cenarioPreheat()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    SimConfig base;
+    SimConfig com;  com.preheat = true;
+    const PreheatLookahead::Params ph;
+
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        for (const Receita* rc : { &RECEITA_PADRAO, &longa }) {
+            if (rc == &longa && !tina) continue;
+            printf("--- planta %s, curva %s ---\n", pp->nome, rc == &longa ? "longa" : "padrao");
+            SimResultado a = simular(base, *rc, *pp);
+            SimResultado b = simular(com,  *rc, *pp);
+            imprimir("PID (sem antecipacao)", a);
+            imprimir("PID + pre-aquecimento", b);
+            const double ganho = a.tempoTotal - b.tempoTotal;
+            printf("ganho: %.0f s (%.1f %%)\n", ganho, 100.0 * ganho / a.tempoTotal);
+            // o degrau antecipado poupa no máximo a rampa de band − bandMargin
+            // a plena potência por etapa: 0,2 s na slave, ~31 s na tina
+            const double rampa = (ph.band - ph.bandMargin) / pp->ganho;
+            if (tina)
+                conferir(ganho >= 0.5 * rampa,
+                         "pre-aquecimento poupa ao menos meia rampa de %.2f C a plena potencia (%.0f >= %.0f s)",
+                         ph.band - ph.bandMargin, ganho, 0.5 * rampa);
+            else
+                conferir(b.tempoTotal <= a.tempoTotal,
+                         "pre-aquecimento nao atrasa a receita (%.0f <= %.0f s; rampa de %.2f C: %.1f s)",
+                         b.tempoTotal, a.tempoTotal, ph.band - ph.bandMargin, rampa);
+            conferir(b.maxAcima < 1.0 && b.foraBanda <= a.foraBanda,
+                     "pre-aquecimento fica na banda de 1 C (acima=%.2f C, fora_banda=%.1f s)",
+                     b.maxAcima, b.foraBanda);
+        }
+    }
+    return 0;
+}
+
+static int cenarioApproach()
+{
+    SimConfig puro; puro.antiWindup = false;
+    SimConfig pid;
+    SimConfig apr;  apr.modo = CTRL_APPROACH;
+
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, curva padrao ---\n", pp->nome);
+        SimResultado p = simular(puro, RECEITA_PADRAO, *pp);
+        SimResultado a = simular(pid, RECEITA_PADRAO, *pp);
+        SimResultado b = simular(apr, RECEITA_PADRAO, *pp);
+        imprimir("PID, sem anti-windup", p);
+        imprimir("PID + anti-windup", a);
+        imprimir("plena potencia + PID", b);
+        // sem o anti-windup o integrador acumula a rampa inteira: mais
+        // rápido na tina, mas fora da banda do RNF-04 a cada etapa
+        conferir(p.foraBanda > 0 && p.maxAcima > a.maxAcima && p.maxAcima > b.maxAcima,
+                 "sem anti-windup o PID sai da banda (acima %.2f C, fora %.0f s)", p.maxAcima, p.foraBanda);
+        conferir(b.tempoTotal <= a.tempoTotal,
+                 "aproximacao nao atrasa a receita em relacao ao PID + anti-windup (%.0f <= %.0f s)",
+                 b.tempoTotal, a.tempoTotal);
+        conferir(a.maxAcima < 1.0 && b.maxAcima < 1.0 && a.foraBanda == 0 && b.foraBanda == 0,
+                 "sobressinal na banda de 1 C (PID + anti-windup %.2f C, aproximacao %.2f C)",
+                 a.maxAcima, b.maxAcima);
+    }
+    return 0;
+}
+
+static int cenarioSmith()
+{
+    SimConfig pid;
+    SimConfig semSmith;  semSmith.kp = Kp_SMITH; semSmith.ki = Ki_SMITH; semSmith.kd = Kd_SMITH;
+    SimConfig smith = semSmith;  smith.smith = true;
+
+    // sem tempo morto no modelo o preditor fica inativo (o PidTask
+    // mantém os ganhos atuais e a UART recusa o smith_on)
+    {
+        ThermalModel m;
+        m.deadTime = 0.0f;
+        SmithPredictor s;
+        s.setEnabled(true);
+        float pv = 50.0f;
+        for (int i = 0; i < 1000; ++i) pv = s.update(50.0f, 1.0f, static_cast<float>(PID_DT), m);
+        conferir(!s.active(m) && pv == 50.0f && s.correction() == 0.0f,
+                 "modelo sem tempo morto: Smith inativo, PV sem correcao");
+    }
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, curva padrao ---\n", pp->nome);
+        const SimResultado a = simular(pid, RECEITA_PADRAO, *pp);
+        const SimResultado b = simular(smith, RECEITA_PADRAO, *pp);
+        imprimir("PID (ganhos atuais)", a);
+        imprimir("ganhos Smith, sem Smith", simular(semSmith, RECEITA_PADRAO, *pp));
+        imprimir("Smith + PID", b);
+        // supera os ganhos atuais: na banda, sem atrasar nem passar mais
+        // por cima (a menos de 0,01 °C, a resolução da PV), e melhor em
+        // ao menos um dos dois
+        conferir(b.foraBanda == 0 && b.tempoTotal <= a.tempoTotal && b.maxAcima <= a.maxAcima + 0.01 &&
+                 (b.tempoTotal < a.tempoTotal || b.maxAcima < a.maxAcima - 0.01),
+                 "Smith supera o PID (ganhos atuais): total %.0f <= %.0f s, acima %.2f <= %.2f C",
+                 b.tempoTotal, a.tempoTotal, b.maxAcima, a.maxAcima);
+    }
+    return 0;
+}
+
+static int cenarioFusao()
+{
+    for (double sigma : { 0.0, 0.5 }) {
+        SimConfig s1;  s1.fusao = false; s1.ruido = sigma;
+        SimConfig est; est.fusao = true; est.ruido = sigma;
+
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C ---\n", pp->nome, sigma);
+            SimResultado a = simular(s1,  RECEITA_PADRAO, *pp);
+            SimResultado b = simular(est, RECEITA_PADRAO, *pp);
+            imprimir("PV = sonda 1", a);
+            imprimir("PV = estimador", b);
+            // sem ruído as duas PV são iguais; com ruído o estimador o filtra
+            conferir((sigma == 0 || b.atividade < a.atividade) && b.foraBanda <= a.foraBanda,
+                     "estimador na banda e, com ruido, agita menos o duty (%.1f x %.1f)",
+                     b.atividade, a.atividade);
+        }
+    }
+    return 0;
+}
+
+static int cenarioFeedForward()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    SimConfig pid;
+    SimConfig semFf;   semFf.kp = Kp_FF; semFf.ki = Ki_FF; semFf.kd = Kd_FF;
+    SimConfig ff = semFf;      ff.ff = true;
+    SimConfig errado = ff;     errado.erroModelo = 2.0;
+    SimConfig errado2 = ff;    errado2.erroModelo = 0.5;
+    SimConfig semFfErrado = semFf;  semFfErrado.erroModelo = 2.0;
+
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, curva padrao ---\n", pp->nome);
+        SimResultado a = simular(pid, RECEITA_PADRAO, *pp);
+        SimResultado b = simular(ff, RECEITA_PADRAO, *pp);
+        SimResultado c = simular(errado, RECEITA_PADRAO, *pp);
+        SimResultado d = simular(errado2, RECEITA_PADRAO, *pp);
+        imprimir("PID (ganhos atuais)", a);
+        imprimir("ganhos ff, sem ff", simular(semFf, RECEITA_PADRAO, *pp));
+        imprimir("PID + ff", b);
+        imprimir("PID + ff (perda 2x)", c);
+        imprimir("PID + ff (perda 0,5x)", d);
+        conferir(b.tempoTotal <= a.tempoTotal && b.foraBanda == 0,
+                 "ff com o modelo certo nao atrasa nem sai da banda (%.0f <= %.0f s)",
+                 b.tempoTotal, a.tempoTotal);
+        conferir(terminou(c, errado) && terminou(d, errado2) && c.foraBanda == 0 && d.foraBanda == 0,
+                 "ff com a perda 2x e 0,5x termina a receita na banda");
+
+        // mesmos ganhos, perda do modelo 2x, várias etapas: com o ff o
+        // aprendizado corrige o modelo (termo de antecipação); sem ele o
+        // integrador lento carrega o erro nos patamares da tina. No slave
+        // os degraus são rápidos e a pré-carga do anti-windup, com a perda
+        // medida nas rampas, já cobre o erro: o ff só não pode piorar
+        // (erro médio a menos de 0,01 °C, a resolução da PV)
+        printf("--- planta %s, curva longa, perda do modelo 2x ---\n", pp->nome);
+        const SimResultado e = simular(semFfErrado, longa, *pp);
+        const SimResultado f = simular(errado, longa, *pp);
+        imprimir("ganhos ff, sem ff", e);
+        imprimir("PID + ff", f);
+        if (pp == &PLANTA_TINA)
+            conferir(f.foraBanda <= e.foraBanda && f.iae < e.iae,
+                     "ff melhora os mesmos ganhos (fora_banda %.1f <= %.1f s, erro integrado %.0f < %.0f C.s)",
+                     f.foraBanda, e.foraBanda, f.iae, e.iae);
+        else
+            conferir(f.foraBanda <= e.foraBanda && f.iae <= e.iae + 0.01 * f.tempoTotal,
+                     "ff nao piora os mesmos ganhos (fora_banda %.1f <= %.1f s, erro integrado %.0f <= %.0f C.s)",
+                     f.foraBanda, e.foraBanda, f.iae, e.iae + 0.01 * f.tempoTotal);
+    }
+    return 0;
+}
+
+static int cenarioSsr()
+{
+    printf("--- linearidade: duty fixo por 60 s ---\n");
+    printf("%6s %9s %10s %10s %10s %12s %12s\n", "duty", "esperado", "LEDC+SSR",
+           "burst/2", "burst/8", "comut/s /2", "comut/s /8");
+    double desvio = 0;             // maior |entregue − esperado| do burst-fire
+    for (uint16_t d : { 0, 5, 20, 100, 200, 300, 341, 400, 512, 682, 800, 1000, 1023 }) {
+        SaidaAquecedor ledc(SAIDA_LEDC_SSR), b2(SAIDA_BURST, 2), b8(SAIDA_BURST, 8);
+        double pl = 0, p2 = 0, p8 = 0;
+        for (int i = 0; i < 60 * TICKS_PER_S; ++i) {
+            pl += ledc.passo(d, PID_DT);
+            p2 += b2.passo(d, PID_DT);
+            p8 += b8.passo(d, PID_DT);
+        }
+        const double n = 60.0 * TICKS_PER_S;
+        const double esperado = static_cast<double>(d) / PWM_MAX_DUTY;
+        desvio = std::max({ desvio, std::fabs(p2 / n - esperado), std::fabs(p8 / n - esperado) });
+        printf("%6u %9.4f %10.4f %10.4f %10.4f %12.2f %12.2f\n", d,
+               static_cast<double>(d) / PWM_MAX_DUTY, pl / n, p2 / n, p8 / n,
+               b2.comutacoes() / 60.0, b8.comutacoes() / 60.0);
+    }
+    conferir(desvio <= 0.002, "burst-fire linear em todo o duty (desvio max %.4f)", desvio);
+
+    SimConfig ideal;
+    SimConfig ledc;   ledc.saida  = SAIDA_LEDC_SSR;
+    SimConfig burst;  burst.saida = SAIDA_BURST;
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, curva padrao ---\n", pp->nome);
+        SimResultado a = simular(ideal, RECEITA_PADRAO, *pp);
+        SimResultado b = simular(ledc,  RECEITA_PADRAO, *pp);
+        SimResultado c = simular(burst, RECEITA_PADRAO, *pp);
+        imprimir("PWM ideal", a);
+        imprimir("LEDC + SSR", b);
+        printf("%22s comutacoes=%ld\n", "", b.comutacoes);
+        imprimir("burst-fire + SSR", c);
+        printf("%22s comutacoes=%ld\n", "", c.comutacoes);
+        conferir(c.tempoTotal <= a.tempoTotal && c.foraBanda == 0 && c.comutacoes < b.comutacoes,
+                 "burst-fire acompanha o PWM ideal com menos comutacoes que o LEDC (%ld < %ld)",
+                 c.comutacoes, b.comutacoes);
+    }
+    return 0;
+}
+
+static int cenarioMixer()
+{
+    SimConfig binario;     binario.mixer    = MIXER_BINARIO;
+    SimConfig velocidade;  velocidade.mixer = MIXER_VELOCIDADE;
+
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, curva padrao ---\n", pp->nome);
+        const SimConfig* cfgs[]  = { &binario, &velocidade };
+        const char*      nomes[] = { "liga/desliga |s1-s2|>1", "velocidade (gradiente)" };
+        SimResultado r[2];
+        for (int i = 0; i < 2; ++i) {
+            r[i] = simular(*cfgs[i], RECEITA_PADRAO, *pp);
+            imprimir(nomes[i], r[i]);
+            printf("%22s mixer: energia=%6.0f s  partidas=%4ld  estratificado=%6.0f s  max=%4.2f C\n",
+                   "", r[i].energiaMixer, r[i].partidas, r[i].estratificado, r[i].maxEstrat);
+        }
+        conferir(r[1].partidas < r[0].partidas && r[1].estratificado <= r[0].estratificado &&
+                 r[1].energiaMixer <= r[0].energiaMixer,
+                 "velocidade parte menos e mistura mais que liga/desliga (%ld < %ld partidas)",
+                 r[1].partidas, r[0].partidas);
+    }
+
+    // RF-09: degrau de ΔT para 1,5 °C; a partida deve vir 5 s depois
+    MixerController m;
+    double partida = -1;
+    for (int s = 1; s <= 30 && partida < 0; ++s)
+        if (m.update(66.5f, 68.0f, 1.0f)) partida = s;
+    printf("--- degrau de 1,5 C entre as sondas: misturador liga em %.0f s (RF-09: 5 s) ---\n", partida);
+    conferir(partida == 5, "misturador liga 5 s depois do degrau (RF-09)");
+    return 0;
+}
+
+/* mesmo formato de CallbackModule::printEnergyReport() */
+static void imprimirConta(const EnergyMeter& m, const char* nome, const EnergyMeter::Account& a)
+{
+    float total = m.seconds(a.ticks);
+    float cheio = m.heaterFullSec(a);
+    printf("%-8s %6.0f s | aquecedor %6.0f s a plena potencia (%3.0f %%)",
+           nome, total, cheio, total > 0 ? 100.0f * cheio / total : 0.0f);
+    if (m.heaterWatts() > 0) printf(", %6.1f Wh", m.heaterWh(a));
+    printf(" | misturador %5.0f s\n", m.seconds(a.mixTicks));
+}
+
+static int cenarioEnergia()
+{
+    SimConfig cfg;  cfg.mixer = MIXER_VELOCIDADE;
+    const float watts[] = { 0.0f, 2500.0f };        // escravo: potência desconhecida
+
+    for (int p = 0; p < 2; ++p) {
+        const PlantaParams& pp = *PLANTAS[p];
+        SimResultado r = simular(cfg, RECEITA_PADRAO, pp);
+        r.contas.stopBrew();
+        r.contas.tick(-1, 0, false);                 // aplica o stop, como a PidTask
+        r.contas.setHeaterWatts(watts[p]);
+        printf("--- planta %s, curva padrao, misturador por velocidade%s ---\n",
+               pp.nome, watts[p] > 0 ? ", aquecedor de 2500 W" : "");
+        char nome[24];
+        for (int i = 0; i < r.contas.steps(); ++i) {
+            snprintf(nome, sizeof(nome), "etapa %d", i);
+            imprimirConta(r.contas, nome, r.contas.step(i));
+        }
+        imprimirConta(r.contas, "TOTAL", r.contas.total());
+        printf("%-8s %6.0f s a plena potencia pela potencia entregue a planta\n",
+               "conferir", r.energia);
+        float etapas = 0;
+        for (int i = 0; i < r.contas.steps(); ++i) etapas += r.contas.heaterFullSec(r.contas.step(i));
+        const float cheio = r.contas.heaterFullSec(r.contas.total());
+        conferir(std::fabs(cheio - r.energia) <= 1.0 && std::fabs(etapas - cheio) <= 1.0f,
+                 "relatorio = energia entregue a planta (%.0f s x %.0f s) e soma das etapas = total",
+                 cheio, r.energia);
+    }
+
+    /* custo por tick (medido no host) */
+    EnergyMeter m(0.01f, PWM_MAX_DUTY);
+    m.startBrew();
+    const int N = 10000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i)
+        m.tick((i >> 16) % 3, static_cast<uint32_t>(i) & PWM_MAX_DUTY, i & 1);
+    auto t1 = std::chrono::steady_clock::now();
+    printf("tick(): %.1f ns (host), total %.0f s\n",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / N,
+           m.seconds(m.total().ticks));
+    return 0;
+}
+
+static void imprimirIdent(const char* nome, const FopdtIdentifier& id)
+{
+    printf("%-24s G=%7.4f C/s  tau=%7.0f s  Ta=%5.1f C  theta=%3.0f s  K=%6.1f C  %s (%lu amostras)\n",
+           nome, id.heatGain(), id.timeConstant(), id.ambient(), id.deadTime(),
+           id.staticGain(), id.valid() ? "valido" : "invalido", (unsigned long)id.samples());
+}
+
+/* identificado válido e perto da planta: G a 5 %, tau a 10 % */
+static void conferirIdent(const FopdtIdentifier& id, const PlantaParams& pp)
+{
+    const double eG = std::fabs(id.heatGain() / pp.ganho - 1.0);
+    const double eTau = std::fabs(id.timeConstant() * pp.perda - 1.0);
+    conferir(id.valid() && eG <= 0.05 && eTau <= 0.10,
+             "curva longa identifica a planta (G %.1f %%, tau %.1f %%)", 100 * eG, 100 * eTau);
+}
+
+static int cenarioIdent()
+{
+    /* curva padrão seguida de uma curva longa (duas brassagens) */
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s: G=%.4f C/s  tau=%.0f s  Ta=%.1f C  theta=%.0f s (atraso+sonda)  K=%.1f C ---\n",
+               pp->nome, pp->ganho, 1.0 / pp->perda, pp->ambiente, pp->atraso + pp->tauSonda,
+               pp->ganho / pp->perda);
+        SimConfig limpo;
+        SimConfig ruidoso;  ruidoso.ruido = 0.5;
+        imprimirIdent("curva padrao",            simular(limpo,   RECEITA_PADRAO, *pp).ident);
+        imprimirIdent("curva padrao, ruido 0.5", simular(ruidoso, RECEITA_PADRAO, *pp).ident);
+        const FopdtIdentifier a = simular(limpo,   longa, *pp).ident;
+        const FopdtIdentifier b = simular(ruidoso, longa, *pp).ident;
+        imprimirIdent("curva longa",             a);
+        imprimirIdent("curva longa, ruido 0.5",  b);
+        conferirIdent(a, *pp);
+        conferirIdent(b, *pp);
+    }
+    return 0;
+}
+
+/* tempo de detecção de cada falha (após a injeção) e alarmes antes dela;
+ * o prazo conta de quando a falha fica visível (tVisivel) */
+static void imprimirDeteccao(const char* nome, const SimConfig& cfg, const SimResultado& r, double prazo)
+{
+    static const char* const BIT[] = { "aquecedor", "sonda1_travada", "sonda2_travada", "divergencia" };
+    printf("%-20s", nome);
+    bool algum = false;
+    for (int b = 0; b < 4; ++b) {
+        if (r.tDeteccao[b] < 0) continue;
+        algum = true;
+        if (cfg.falha == FALHA_NENHUMA || r.tDeteccao[b] < cfg.tFalha)
+            printf("  %s: FALSO ALARME em %.0f s", BIT[b], r.tDeteccao[b]);
+        else
+            printf("  %s: +%.0f s", BIT[b], r.tDeteccao[b] - cfg.tFalha);
+    }
+    if (!algum) printf("  nenhuma falha detectada");
+    if (r.tVisivel >= 0) printf("  (visivel em +%.0f s, prazo %.0f s)", r.tVisivel - cfg.tFalha, prazo);
+    printf("\n");
+}
+
+/* prazo de detecção por tipo de falha, contado de quando ela fica
+ * visível: aquecedor e sonda travada em tempo morto + janela +
+ * confirmação; divergência em divSec + 2 amostras (leitura e filtro) */
+static double prazoDeteccao(const SimConfig& cfg, const SimResultado& r, const PlantaParams& pp)
+{
+    const FaultDetector::Params& d = cfg.deteccao;
+    if (cfg.falha == FALHA_SONDA2_SOLTA) return d.divSec + 2 * d.dt;
+    return pp.atraso + pp.tauSonda + (r.janelaMax + d.confirm) * d.dt;
+}
+
+/* sem alarme antes da falha (nem sem falha) e a falha esperada (bit)
+ * detectada até `prazo` s depois de ficar visível (antes dela, vale) */
+static bool deteccaoOk(const SimConfig& cfg, const SimResultado& r, int bit, double prazo)
+{
+    for (int b = 0; b < 4; ++b)
+        if (r.tDeteccao[b] >= 0 && (cfg.falha == FALHA_NENHUMA || r.tDeteccao[b] < cfg.tFalha)) return false;
+    return bit < 0 || (r.tDeteccao[bit] >= 0 &&
+                       (r.tVisivel < 0 || r.tDeteccao[bit] - r.tVisivel <= prazo));
+}
+
+static int cenarioFalhas()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    struct Caso { const char* nome; Falha falha; int bit; };     // bit esperado em tDeteccao
+    static const Caso CASOS[] = {
+        { "sem falha",         FALHA_NENHUMA,        -1 },
+        { "resistencia aberta", FALHA_AQUECEDOR,      0 },
+        { "SSR em curto",      FALHA_SSR_CURTO,       0 },
+        { "sonda 1 travada",   FALHA_SONDA1_TRAVADA,  1 },
+        { "sonda 2 solta",     FALHA_SONDA2_SOLTA,    3 },
+    };
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        for (double sigma : { 0.0, 0.5 }) {
+            printf("--- planta %s, ruido %.1f C, falha em %s ---\n", pp->nome, sigma,
+                   tina ? "1800 s (curva longa)" : "60 s / 200 s (curva padrao)");
+            int erros = 0;
+            for (const Caso& c : CASOS) {
+                SimConfig cfg;
+                cfg.ruido  = sigma;
+                cfg.mixer  = MIXER_VELOCIDADE;     // estratificação real entre as sondas
+                cfg.falha  = c.falha;
+                // slave: patamar de 67 °C (60 s) e rampa para 78 °C (200 s)
+                for (double tf : tina ? std::vector<double>{ 1800 } : std::vector<double>{ 60, 200 }) {
+                    cfg.tFalha = tf;
+                    char nome[32];
+                    snprintf(nome, sizeof nome, "%s%s", c.nome, tina || tf < 100 ? "" : " (rampa)");
+                    const SimResultado r = simular(cfg, tina ? longa : RECEITA_PADRAO, *pp);
+                    const double prazo = prazoDeteccao(cfg, r, *pp);
+                    imprimirDeteccao(nome, cfg, r, prazo);
+                    erros += !deteccaoOk(cfg, r, c.bit, prazo);
+                    if (c.falha == FALHA_NENHUMA) break;
+                }
+            }
+            conferir(erros == 0, "sem falso alarme e cada falha detectada no prazo do seu tipo (%d fora)",
+                     erros);
+        }
+    }
+    return 0;
+}
+
+/* previsão x tempo real restante em frações da receita; erro médio e
+ * máximo sobre a receita inteira */
+struct EtaErro { double med, max, patamaresMed; };
+
+static EtaErro imprimirEta(const char* nome, const SimResultado& r)
+{
+    const size_t n = r.eta.size();
+    double errMed = 0, errMax = 0, ingMed = 0, ingMax = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double real = n - 1 - i;
+        const double e = std::fabs(r.eta[i] - real), g = std::fabs(r.etaPatamares[i] - real);
+        errMed += e; ingMed += g;
+        errMax = std::max(errMax, e); ingMax = std::max(ingMax, g);
+    }
+    printf("%-26s total %5.0f s |", nome, r.tempoTotal);
+    for (double f : { 0.0, 0.25, 0.5, 0.75 }) {
+        const size_t i = static_cast<size_t>(f * (n - 1));
+        printf(" %2.0f%%: %5.0f/%5.0f", 100 * f, r.eta[i], double(n - 1 - i));
+    }
+    printf(" | erro med %4.0f max %4.0f s (so patamares: med %4.0f max %4.0f s)",
+           errMed / n, errMax, ingMed / n, ingMax);
+    if (r.tCorte >= 0) printf("  CORTE em %.0f s", r.tCorte);
+    printf("\n");
+    return { errMed / n, errMax, ingMed / n };
+}
+
+/* previsão melhor que somar os patamares e a no máximo `max` s do real */
+static void conferirEta(const EtaErro& e, double max)
+{
+    conferir(e.med < e.patamaresMed && e.max <= max,
+             "ETA melhor que so patamares (med %.0f < %.0f s) e erro max %.0f <= %.0f s",
+             e.med, e.patamaresMed, e.max, max);
+}
+
+static int cenarioEta()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        const Receita& rc = tina ? longa : RECEITA_PADRAO;
+        printf("--- planta %s, %s (previsto/real em %% da receita) ---\n", pp->nome,
+               tina ? "curva longa" : "curva padrao");
+        SimConfig cfg;
+        conferirEta(imprimirEta("modelo certo", simular(cfg, rc, *pp)), 60);
+        cfg.ruido = 0.5;
+        conferirEta(imprimirEta("ruido 0.5", simular(cfg, rc, *pp)), 60);
+        cfg.ruido = 0;
+        // no slave, perda x2 deixa 78 °C fora do alcance do modelo: a ETA
+        // não tem rampa finita (o controle com esse erro é conferido em corte)
+        cfg.erroModelo = 2.0;
+        const EtaErro e = imprimirEta("perda do modelo x2", simular(cfg, rc, *pp));
+        if (tina) conferirEta(e, 300);
+        cfg.erroModelo = 0.5;
+        conferirEta(imprimirEta("perda do modelo x0.5", simular(cfg, rc, *pp)), 300);
+        cfg.erroModelo = 1.0;
+        cfg.preheat = true;
+        // O quanto o pré-aquecimento adianta cada etapa só é medido na primeira
+        // troca para uma etapa mais quente; até lá a ETA não conta com o ganho
+        // (~13 s por etapa mais quente na tina).
+        conferirEta(imprimirEta("com pre-aquecimento", simular(cfg, rc, *pp)), 100);
+    }
+    return 0;
+}
+
+static int cenarioMpc()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    SimConfig pid;
+    SimConfig apr;  apr.modo = CTRL_APPROACH;
+    SimConfig ff;   ff.ff = true; ff.kp = Kp_FF; ff.ki = Ki_FF; ff.kd = Kd_FF;
+    SimConfig mpc;  mpc.modo = CTRL_MPC;
+    SimConfig mpcErro = mpc;  mpcErro.erroModelo = 2.0;
+    SimConfig mpcRuido = mpc; mpcRuido.ruido = 0.5;
+    SimResultado pidTina;
+
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        for (const Receita* rc : { &RECEITA_PADRAO, &longa }) {
+            if (!tina && rc == &longa) continue;
+            printf("--- planta %s, curva %s ---\n", pp->nome, rc == &longa ? "longa" : "padrao");
+            const SimResultado a = simular(pid, *rc, *pp);
+            imprimir("PID", a);
+            if (tina && rc == &RECEITA_PADRAO) pidTina = a;
+            imprimir("plena potencia + PID", simular(apr, *rc, *pp));
+            imprimir("PID + feed-forward", simular(ff, *rc, *pp));
+            const SimResultado r = simular(mpc, *rc, *pp);
+            imprimir("MPC", r);
+            const SimResultado e = simular(mpcErro, *rc, *pp);
+            imprimir("MPC, perda x2", e);
+            const SimResultado n = simular(mpcRuido, *rc, *pp);
+            imprimir("MPC, ruido 0.5", n);
+            printf("%22s custo medio por decisao no host: %.1f us (horizonte %d, %d blocos)\n",
+                   "", r.mpcUsMed, mpc.mpc.horizon, mpc.mpc.blocks);
+            // nas duas plantas: termina sem corte, na banda e sem gastar
+            // mais que o PID, também com perda x2 e com ruído
+            bool ok = true;
+            for (const SimResultado* x : { &r, &e, &n })
+                ok = ok && terminou(*x, mpc) && x->tCorte < 0 && x->foraBanda == 0 &&
+                     x->energia <= a.energia;
+            conferir(ok, "MPC na banda e energia <= PID (%.1f, %.1f, %.1f <= %.1f s), com perda x2 e ruido",
+                     r.energia, e.energia, n.energia, a.energia);
+            // na tina (tempo morto, inércia) o MPC também encurta a receita
+            if (tina)
+                conferir(r.tempoTotal < a.tempoTotal, "MPC mais rapido que o PID (%.0f < %.0f s)",
+                         r.tempoTotal, a.tempoTotal);
+        }
+    }
+    // pior caso de custo: horizonte e blocos no máximo
+    SimConfig pior = mpc;
+    pior.mpc.horizon = MpcController::MAX_HORIZON;
+    pior.mpc.blocks  = MpcController::MAX_BLOCKS;
+    SimResultado r = simular(pior, RECEITA_PADRAO, PLANTA_TINA);
+    imprimir("MPC, horizonte maximo", r);
+    printf("%22s custo medio por decisao no host: %.1f us (horizonte %d, %d blocos)\n",
+           "", r.mpcUsMed, pior.mpc.horizon, pior.mpc.blocks);
+    conferir(terminou(r, pior) && r.foraBanda == 0 && r.energia <= pidTina.energia,
+             "horizonte maximo na banda e energia <= PID (%.0f <= %.0f s)", r.energia, pidTina.energia);
+    return 0;
+}
+
+/* corte de segurança: instante em relação à falha e à massa passar
+ * do limite, latência medida pelo próprio OverTempGuard e pico */
+static void imprimirCorte(const char* nome, const SimConfig& cfg, const SimResultado& r,
+                          float limite)
+{
+    static const char* const MOTIVO[] = { "-", "sobretemperatura", "sem leitura" };
+    printf("%-22s", nome);
+    if (r.tCorte < 0) {
+        printf("  sem corte  pico=%5.1f C (limite %.0f C)\n", r.picoMassa, limite);
+        return;
+    }
+    const double ref = cfg.falha == FALHA_NENHUMA ? 0 : cfg.tFalha;
+    printf("  %-16s em +%6.1f s", MOTIVO[r.motivoCorte], r.tCorte - ref);
+    if (r.tLimite >= 0 && r.tLimite <= r.tCorte)
+        printf(" (massa no limite +%5.1f s antes)", r.tCorte - r.tLimite);
+    else if (r.tLimite >= 0)                   // ruído da sonda chegou antes da massa
+        printf(" (massa no limite %6.1f s depois)", r.tLimite - r.tCorte);
+    printf("  latencia=%5.1f ms  pico=%5.1f C (limite %.0f C)\n", r.latCorteMs, r.picoMassa, limite);
+}
+
+/* RF-07 / RNF-09: sem falha não corta e fica abaixo do limite; com o
+ * controle travado corta por sobretemperatura até 30 s da massa
+ * chegar ao limite (ou antes, pelo ruído), em até `prazo` s da falha,
+ * sem ruído na primeira leitura acima (latência 0 no relógio da
+ * simulação), com ruído em até (confirm − 1) leituras (100 ms a 20
+ * leituras/s) e a massa no máximo 1 °C acima; I²C mudo corta pelo
+ * timeout (3 s) em até um ciclo do timer (10 ms aqui, 5 ms no
+ * firmware) */
+static void conferirCorte(const SimConfig& cfg, const SimResultado& r, float limite, double prazo)
+{
+    const double t = r.tCorte - cfg.tFalha;
+    switch (cfg.falha) {
+    case FALHA_NENHUMA:
+        conferir(r.tCorte < 0 && r.picoMassa <= limite, "sem corte e pico %.1f <= %.0f C",
+                 r.picoMassa, limite);
+        break;
+    case FALHA_DUTY_PRESO:
+        conferir(r.motivoCorte == OverTempGuard::TRIP_OVERTEMP && t <= prazo &&
+                 (r.tLimite < 0 || r.tCorte - r.tLimite <= 30),
+                 "corte por sobretemperatura em +%.0f s (<= %.0f s), ate 30 s da massa no limite",
+                 t, prazo);
+    {
+        const double lat = cfg.ruido > 0 ? (OverTempGuard::Params{}.confirm - 1) * 1000.0 / cfg.acqHz : 0;
+        conferir(r.latCorteMs <= lat + 5 && r.picoMassa <= limite + 1.0,
+                 "latencia %.1f ms <= %.0f ms (%s) e pico %.1f <= %.0f C", r.latCorteMs, lat + 5,
+                 cfg.ruido > 0 ? "leituras confirmadas" : "primeira leitura acima",
+                 r.picoMassa, limite + 1.0);
+        break;
+    }
+    default:
+        conferir(r.motivoCorte == OverTempGuard::TRIP_TIMEOUT && t <= 3.5 && r.latCorteMs <= PID_DT * 1000,
+                 "corte sem leitura em +%.1f s (timeout de 3 s), latencia %.1f ms <= %.0f ms",
+                 t, r.latCorteMs, PID_DT * 1000);
+        break;
+    }
+}
+
+static int cenarioCorte()
+{
+    const Receita longa = { {45, 55, 63, 67, 72, 78}, {900, 900, 1800, 1800, 900, 600} };
+    // perda do modelo errada: o anti-windup do PID pré-carrega o
+    // integrador com a perda medida na rampa, não com a do modelo
+    struct Caso { const char* nome; Falha falha; CtrlMode modo; double erroModelo; };
+    static const Caso CASOS[] = {
+        { "sem falha, PID",     FALHA_NENHUMA,    CTRL_PID, 1.0 },
+        { "PID, perda x0.5",    FALHA_NENHUMA,    CTRL_PID, 0.5 },
+        { "PID, perda x2",      FALHA_NENHUMA,    CTRL_PID, 2.0 },
+        { "sem falha, MPC",     FALHA_NENHUMA,    CTRL_MPC, 1.0 },
+        { "controle travado",   FALHA_DUTY_PRESO, CTRL_PID, 1.0 },
+        { "I2C mudo",           FALHA_I2C_MUDO,   CTRL_PID, 1.0 },
+    };
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        const Receita& rc = tina ? longa : RECEITA_PADRAO;
+        OverTempGuard g(nullptr, nullptr);
+        const std::vector<centi_t> temps = centesimos(rc);
+        g.setCurve(temps.data(), static_cast<int>(temps.size()));
+        // RF-07: etapa mais quente + 2 °C, independente dos Params do guarda
+        const float limite = *std::max_element(rc.temps.begin(), rc.temps.end()) + 2.0f;
+        conferir(std::fabs(g.limit() - limite) < 0.01f, "limite do corte %.2f C = Max + 2 C (RF-07)",
+                 g.limit());
+        // direto no guarda, a 20 leituras/s e sem ruído: bit trocado
+        // (salto de 16 °C) acima do limite não corta; subida real corta
+        // na primeira leitura acima; salto que se repete (a leitura
+        // seguinte é alcançável dele) corta na segunda
+        {
+            const uint32_t dt = 50000;
+            const float    v  = limite - 0.05f;
+            const float    h1[] = { v, v + 16.0f, v, v + 0.1f };
+            const float    h2[] = { v, v + 16.0f, v + 16.0f, v + 16.0f };
+            OverTempGuard h(corteSim, relogioSim), k(corteSim, relogioSim);
+            h.setCurve(temps.data(), static_cast<int>(temps.size()));
+            k.setCurve(temps.data(), static_cast<int>(temps.size()));
+            bool picoIgnorado = false;
+            for (int i = 0; i < 4; ++i) {
+                g_simUs = i * dt;
+                h.sample(0, h1[i], g_simUs);
+                k.sample(0, h2[i], g_simUs);
+                if (i == 1) picoIgnorado = !h.tripped() && !k.tripped();
+            }
+            conferir(picoIgnorado && h.tripped() && h.latencyUs() == 0 &&
+                     k.tripped() && k.latencyUs() == dt,
+                     "bit trocado nao corta; subida real corta na 1a leitura acima (%u us); "
+                     "salto que se repete corta %u ms depois", (unsigned)h.latencyUs(),
+                     (unsigned)(k.latencyUs() / 1000));
+            g_simUs = 0;
+        }
+        for (double sigma : { 0.0, 0.5 }) {
+            printf("--- planta %s, ruido %.1f C, falha em %s ---\n", pp->nome, sigma,
+                   tina ? "1800 s (curva longa)" : "60 s (curva padrao)");
+            // no slave a curva longa tem degraus de rampa curta demais para
+            // medir a perda: o pré-carregamento usa a das rampas anteriores.
+            // Com ruído a PV é a do estimador, que prevê com o modelo: parte
+            // do erro chega à perda medida (~4 %) e o sobressinal de ~2 °C
+            // dos degraus rápidos fica mais tempo acima de 1 °C (até 30 s
+            // a mais numa receita de quase 2 h)
+            SimConfig ref;
+            ref.ruido = sigma;
+            const SimResultado rl = tina ? SimResultado{} : simular(ref, longa, *pp);
+            for (const Caso& c : CASOS) {
+                SimConfig cfg;
+                cfg.ruido  = sigma;
+                cfg.modo   = c.modo;
+                cfg.falha  = c.falha;
+                cfg.tFalha = tina ? 1800 : 60;
+                cfg.erroModelo = c.erroModelo;
+                if (c.falha != FALHA_NENHUMA) cfg.tFim = cfg.tFalha + (tina ? 7200 : 900);
+                const SimResultado r = simular(cfg, rc, *pp);
+                imprimirCorte(c.nome, cfg, r, limite);
+                conferirCorte(cfg, r, limite, tina ? 1800 : 120);
+                if (c.erroModelo != 1.0)
+                    conferir(terminou(r, cfg) && r.maxAcima < 1.0 && r.foraBanda == 0,
+                             "receita na banda com a perda do modelo x%.1f (acima %.2f C, fora %.1f s)",
+                             c.erroModelo, r.maxAcima, r.foraBanda);
+                if (c.erroModelo != 1.0 && !tina) {
+                    const SimResultado l = simular(cfg, longa, *pp);
+                    imprimir("  curva longa", l);
+                    const double fora = rl.foraBanda + (sigma > 0 ? 30.0 : 1.0);
+                    const double acima = rl.maxAcima + (sigma > 0 ? 0.25 : 0.1);
+                    conferir(terminou(l, cfg) && l.tCorte < 0 && l.maxAcima <= acima && l.foraBanda <= fora,
+                             "curva longa com a perda do modelo x%.1f como com a certa "
+                             "(acima %.2f <= %.2f C, fora %.1f <= %.1f s)", c.erroModelo,
+                             l.maxAcima, acima, l.foraBanda, fora);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* O modelo mostra de onde vem o jitter da distribuição original
+ * (fatiamento com tasks de mesma prioridade e printf em espera ocupada
+ * na FIFO da UART). Na particionada o PidTask é a task de maior
+ * prioridade e o modelo não tem ISRs, cache/flash nem spinlocks entre
+ * núcleos: jitter zero ali é consequência do modelo, não prova do
+ * particionamento. A medida vale na placa, com `pidstats`. */
+static int cenarioJitter()
+{
+    const uint64_t DURACAO = 60ull * 1000000;      // 60 s
+    struct Caso { const char* nome; int nucleos; uint32_t cargaES; };
+    static const Caso CASOS[] = { { "2 nucleos", 2, 1 }, { "serial x4", 2, 4 }, { "1 nucleo", 1, 1 } };
+    for (const Caso& c : CASOS) {
+        char nome[32];
+        snprintf(nome, sizeof(nome), "original, %s", c.nome);
+        const LoopStats a = medirJitter(LAYOUT_ORIGINAL, c.nucleos, DURACAO, c.cargaES);
+        imprimirJitter(nome, a);
+        snprintf(nome, sizeof(nome), "particionado, %s", c.nome);
+        const LoopStats b = medirJitter(LAYOUT_PARTICIONADO, c.nucleos, DURACAO, c.cargaES);
+        imprimirJitter(nome, b);
+    }
+    printf("(particionado: PidTask na maior prioridade, sem ISRs nem cache no modelo; medir na placa com pidstats)\n");
+    return 0;
+}
+
+/* Resolução da leitura: o byte de °C inteiros de antes (erro de até
+ * 0,5 °C só de quantização, degraus de 1 °C no PID) x os 2 bytes Q8.8
+ * levados em centésimos até o controle. */
+static int cenarioResolucao()
+{
+    for (double sigma : { 0.0, 0.1 }) {
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C ---\n", pp->nome, sigma);
+            double rms[2] = { 0, 0 };      // 1 byte, Q8.8 (PID)
+            int alarmes = 0;
+            for (bool byte : { true, false }) {
+                for (CtrlMode m : { CTRL_PID, CTRL_MPC }) {
+                    SimConfig cfg;  cfg.leitura8 = byte; cfg.ruido = sigma; cfg.modo = m;
+                    SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+                    if (m == CTRL_PID) rms[byte ? 0 : 1] = r.erroLeituraRms;
+                    alarmes += r.deteccao.faults() != 0 || !terminou(r, cfg);
+                    char nome[32];
+                    snprintf(nome, sizeof(nome), "%s %s", byte ? "1 byte" : "Q8.8", m == CTRL_PID ? "PID" : "MPC");
+                    imprimir(nome, r);
+                    printf("%-22s erro de leitura max=%.3f C rms=%.3f C\n", "", r.erroLeitura,
+                           r.erroLeituraRms);
+                }
+            }
+            conferir(alarmes == 0, "receita termina sem alarme do RF-07 nas duas resolucoes");
+            // no slave o erro é o atraso do filtro, não a quantização
+            if (pp == &PLANTA_TINA)
+                conferir(rms[1] < rms[0], "Q8.8 le melhor que 1 byte (rms %.3f < %.3f C)", rms[1], rms[0]);
+        }
+    }
+    return 0;
+}
+
+/* Aquisição: leitura única por segundo x sobreamostrada e decimada
+ * (DecimationFilter), com ruído nas sondas. O PID (termo derivativo)
+ * e a lei liga/desliga do misturador reagem ao ruído de cada leitura;
+ * o filtro troca esse ruído por atraso (média: (ratio − 1)/2 leituras). */
+struct AcqCaso { const char* nome; uint16_t hz; uint8_t ordem; uint8_t iir; };
+static const AcqCaso ACQ_CASOS[] = {
+    { "1 Hz (sem filtro)",   1, 1, 0 },
+    { "10 Hz media",        10, 1, 0 },
+    { "20 Hz media",        20, 1, 0 },
+    { "50 Hz media",        50, 1, 0 },
+    { "20 Hz CIC2",         20, 2, 0 },
+    { "20 Hz media + IIR",  20, 1, 1 },
+};
+
+static int cenarioAquisicao()
+{
+    for (double sigma : { 0.1, 0.5 }) {
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C, misturador liga/desliga ---\n", pp->nome, sigma);
+            long partidas1Hz = 0, partidas20Hz = 0;
+            int  incompletas = 0;
+            for (const AcqCaso& c : ACQ_CASOS) {
+                SimConfig cfg;  cfg.ruido = sigma; cfg.mixer = MIXER_BINARIO;
+                cfg.acqHz = c.hz; cfg.acqOrdem = c.ordem; cfg.acqIir = c.iir;
+                SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+                imprimir(c.nome, r);
+                printf("%22s erro de leitura rms=%.3f C max=%.3f C  mixer: partidas=%4ld\n",
+                       "", r.erroLeituraRms, r.erroLeitura, r.partidas);
+                incompletas += !terminou(r, cfg);
+                if (c.hz == 1)                       partidas1Hz  = r.partidas;
+                if (c.hz == 20 && c.ordem == 1 && !c.iir) partidas20Hz = r.partidas;
+            }
+            conferir(incompletas == 0, "todas as aquisicoes terminam a receita");
+            conferir(partidas20Hz <= partidas1Hz, "media a 20 Hz parte o misturador menos que 1 Hz (%ld <= %ld)",
+                     partidas20Hz, partidas1Hz);
+        }
+    }
+
+    // custo por leitura no host (push + decimação amortizada)
+    printf("--- custo do filtro por leitura (host) ---\n");
+    constexpr int N = 20000000;
+    for (const AcqCaso& c : ACQ_CASOS) {
+        DecimationFilter f({ c.ordem, c.hz, c.iir });
+        Ruido ruido(0.5, 3);
+        std::vector<centi_t> x(1024);
+        for (centi_t& v : x) v = tempFromFloat(static_cast<float>(67.0 + ruido()));
+        long soma = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; ++i)
+            if (f.push(x[i & 1023])) soma += f.output();
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - t0).count() / N;
+        printf("%-22s %.2f ns/leitura (saida media %.2f C)\n", c.nome, ns,
+               tempToC(static_cast<centi_t>(soma / (N / c.hz))));
+    }
+    return 0;
+}
+
+/* Leituras espúrias e sonda degradada: sem ProbeGuard um bit trocado
+ * entra direto no filtro, no estimador e no corte de segurança; com
+ * ele a leitura é recusada e, com a saúde baixa, o controle passa
+ * para a outra sonda. */
+static void imprimirSondas(const SimConfig& cfg, const SimResultado& r)
+{
+    printf("%22s sondas: recusadas=%lu/%lu perdidas=%lu/%lu", "",
+           (unsigned long)r.rejeitadas[0], (unsigned long)r.rejeitadas[1],
+           (unsigned long)r.perdidas[0], (unsigned long)r.perdidas[1]);
+    const double ref = cfg.falha == FALHA_NENHUMA ? 0 : cfg.tFalha;
+    if (r.tFailover >= 0) printf("  failover +%.0f s", r.tFailover - ref);
+    if (r.tRetorno >= 0)  printf("  retorno +%.0f s", r.tRetorno - ref);
+    printf("  erro de leitura rms=%.3f C max=%.3f C\n", r.erroLeituraRms, r.erroLeitura);
+}
+
+static int cenarioSondas()
+{
+    struct Caso { const char* nome; Falha falha; bool guarda; };
+    static const Caso CASOS[] = {
+        { "sem falha, sem guarda", FALHA_NENHUMA,          false },
+        { "sem falha",             FALHA_NENHUMA,          true  },
+        { "picos, sem guarda",     FALHA_SONDA1_PICOS,     false },
+        { "picos",                 FALHA_SONDA1_PICOS,     true  },
+        { "degradada, sem guarda", FALHA_SONDA1_DEGRADADA, false },
+        { "degradada",             FALHA_SONDA1_DEGRADADA, true  },
+    };
+    for (double sigma : { 0.1, 0.5 }) {
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C, falha na sonda 1 em 60 s ---\n", pp->nome, sigma);
+            double semGuarda = 0;            // erro rms do caso anterior, sem guarda
+            int    erros     = 0;
+            for (const Caso& c : CASOS) {
+                SimConfig cfg;  cfg.ruido = sigma; cfg.mixer = MIXER_VELOCIDADE;
+                cfg.falha = c.falha; cfg.tFalha = 60; cfg.guarda = c.guarda;
+                SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+                imprimir(c.nome, r);
+                imprimirSondas(cfg, r);
+                if (!c.guarda) { semGuarda = r.erroLeituraRms; continue; }
+                erros += r.tCorte >= 0 || !terminou(r, cfg);
+                if (c.falha != FALHA_NENHUMA) erros += r.erroLeituraRms >= semGuarda;
+                if (c.falha == FALHA_SONDA1_DEGRADADA)
+                    erros += r.tFailover < 0 || r.tFailover - cfg.tFalha > 10;
+            }
+            conferir(erros == 0, "com a guarda: sem corte, erro menor que sem ela e failover "
+                                 "da degradada em ate 10 s");
+        }
+    }
+
+    // custo por leitura no host
+    constexpr int N = 20000000;
+    ProbeGuard g;
+    Ruido ruido(0.5, 3);
+    std::vector<centi_t> x(1024);
+    for (centi_t& v : x) v = tempFromFloat(static_cast<float>(67.0 + ruido()));
+    long soma = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) soma += g.sample(x[i & 1023]);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - t0).count() / N;
+    printf("--- custo de ProbeGuard::sample() no host: %.2f ns/leitura (%ld) ---\n", ns, soma & 1);
+    return 0;
+}
+
+/* Sondas reais: LM75 (9 bits contínuo, ~100 ms) e TMP75 em one-shot
+ * de 9 a 12 bits, a 20 leituras/s. A conversão nunca é esperada: a
+ * leitura traz a disparada na anterior, e a sonda mais lenta que o
+ * período é lida a cada `every` ciclos. Esperar a conversão dentro do
+ * ciclo bloquearia o I2CTask por conv ms e limitaria a taxa a 1/conv. */
+static int cenarioConversao()
+{
+    struct Caso { const char* nome; SensorType tipo; uint8_t bits; uint16_t hz; };
+    static const Caso CASOS[] = {
+        { "escravo Q8.8 20 Hz", SENSOR_SLAVE_SIM,  0, 20 },
+        { "LM75 20 Hz",         SENSOR_LM75,       0, 20 },
+        { "TMP75 auto 20 Hz",   SENSOR_TMP75,      0, 20 },
+        { "TMP75 10b 20 Hz",    SENSOR_TMP75,     10, 20 },
+        { "TMP75 11b 20 Hz",    SENSOR_TMP75,     11, 20 },
+        { "TMP75 12b 20 Hz",    SENSOR_TMP75,     12, 20 },
+        { "TMP75 auto 10 Hz",   SENSOR_TMP75,      0, 10 },
+    };
+    for (double sigma : { 0.0, 0.1 }) {
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C ---\n", pp->nome, sigma);
+            int erros = 0;
+            for (const Caso& c : CASOS) {
+                SimConfig cfg;  cfg.ruido = sigma; cfg.sonda = c.tipo; cfg.bits = c.bits; cfg.acqHz = c.hz;
+                SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+                imprimir(c.nome, r);
+                erros += !terminou(r, cfg) || r.foraBanda > 0;
+                ProbeDriver d;
+                d.configure(c.tipo, c.bits, 1000000u / c.hz);
+                const double convMs = d.convUs() / 1000.0;
+                char maxHz[8] = "-";
+                if (convMs > 0) snprintf(maxHz, sizeof(maxHz), "%.1f", 1000.0 / convMs);
+                printf("%22s %2ub passo=%.4f C conv=%5.1f ms cada=%u (%4.1f leituras/s)  "
+                       "esperando: %5.1f ms/ciclo, max %s Hz  erro rms=%.3f max=%.3f C\n", "",
+                       d.bits(), c.tipo == SENSOR_SLAVE_SIM ? 1.0 / 256 : d.lsbC(), convMs, d.every(),
+                       static_cast<double>(c.hz) / d.every(), convMs,
+                       maxHz,
+                       r.erroLeituraRms, r.erroLeitura);
+                // a leitura nunca pega uma conversão em curso
+                erros += d.every() * 1000000u / c.hz < d.convUs();
+            }
+            conferir(erros == 0, "todas as sondas terminam a receita na banda, sem ler conversao em curso");
+        }
+    }
+    return 0;
+}
+
+/* Dimensionamento do barramento: tempo de um ciclo com N sondas (as
+ * transações saem em fila, uma após a outra) como fração do período
+ * da aquisição, a 100 e 400 kHz; e os contadores do I2cStats com a
+ * sonda degradada (leituras perdidas) e o barramento mudo. */
+static void imprimirI2c(const SimResultado& r)
+{
+    for (int p = 0; p < 2; ++p) {
+        const I2cStats::Device& d = r.i2c.device(p);
+        printf("%22s sonda %d: n=%lu ok=%lu nack=%lu timeout=%lu seq=%lu lat=[%lu,%.0f,%lu]us  hist:",
+               "", p + 1, (unsigned long)d.attempts, (unsigned long)d.ok(),
+               (unsigned long)d.outcome[I2cStats::OUT_NACK],
+               (unsigned long)d.outcome[I2cStats::OUT_TIMEOUT], (unsigned long)d.failRunMax,
+               (unsigned long)(d.attempts ? d.latMin : 0), d.latMean(), (unsigned long)d.latMax);
+        for (int b = 0; b < I2cStats::BINS; ++b)
+            if (d.hist[b]) printf(" %s%lu:%lu", b == I2cStats::BINS - 1 ? ">=" : "<",
+                                  (unsigned long)(b == I2cStats::BINS - 1 ? I2cStats::binFloor(b)
+                                                                          : I2cStats::binFloor(b + 1)),
+                                  (unsigned long)d.hist[b]);
+        printf("\n");
+    }
+    printf("%22s ciclo max=%lu us\n", "", (unsigned long)r.cicloI2cMaxUs);
+}
+
+static int cenarioI2c()
+{
+    struct Tipo { const char* nome; SensorType tipo; };
+    static const Tipo TIPOS[] = { { "escravo", SENSOR_SLAVE_SIM }, { "LM75", SENSOR_LM75 },
+                                  { "TMP75", SENSOR_TMP75 } };
+    constexpr uint16_t HZ = 20;
+    printf("--- ciclo de aquisicao a %u Hz (periodo %lu us) ---\n", HZ, 1000000ul / HZ);
+    bool cabem = true;
+    for (uint32_t bus : { 100000u, 400000u }) {
+        for (const Tipo& t : TIPOS) {
+            ProbeDriver d;
+            d.configure(t.tipo, 0, 1000000u / HZ);
+            const uint32_t us = tempoI2cUs(d, bus, false);
+            printf("%3lu kHz %-8s %5lu us/leitura:", (unsigned long)(bus / 1000), t.nome, (unsigned long)us);
+            cabem &= 16 * us < 1000000u / HZ;
+            for (int n : { 2, 8, 16 }) {
+                // pior ciclo: todas as sondas lidas juntas
+                const uint32_t ciclo = n * us;
+                printf("  %2d sondas %6lu us (%4.1f %%, max %4.0f Hz)", n, (unsigned long)ciclo,
+                       100.0 * ciclo * HZ / 1e6, 1e6 / ciclo);
+            }
+            printf("\n");
+        }
+    }
+    conferir(cabem, "16 sondas de qualquer tipo cabem no periodo a 100 e 400 kHz");
+
+    struct Caso { const char* nome; Falha falha; SensorType tipo; uint32_t bus; };
+    static const Caso CASOS[] = {
+        { "escravo 100k",          FALHA_NENHUMA,          SENSOR_SLAVE_SIM, 100000 },
+        { "TMP75 100k",            FALHA_NENHUMA,          SENSOR_TMP75,     100000 },
+        { "TMP75 400k",            FALHA_NENHUMA,          SENSOR_TMP75,     400000 },
+        { "TMP75 100k, degradada", FALHA_SONDA1_DEGRADADA, SENSOR_TMP75,     100000 },
+        { "TMP75 100k, mudo",      FALHA_I2C_MUDO,         SENSOR_TMP75,     100000 },
+    };
+    for (const PlantaParams* pp : PLANTAS) {
+        printf("--- planta %s, falha em 60 s ---\n", pp->nome);
+        for (const Caso& c : CASOS) {
+            SimConfig cfg;  cfg.ruido = 0.1; cfg.sonda = c.tipo; cfg.i2cHz = c.bus;
+            cfg.falha = c.falha; cfg.tFalha = 60;
+            if (c.falha == FALHA_I2C_MUDO) cfg.tFim = 600;    // sem leituras não termina
+            SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+            imprimir(c.nome, r);
+            imprimirI2c(r);
+            if (c.falha == FALHA_I2C_MUDO)
+                conferir(r.motivoCorte == OverTempGuard::TRIP_TIMEOUT &&
+                         r.i2c.device(0).outcome[I2cStats::OUT_TIMEOUT] > 0,
+                         "barramento mudo: timeouts contados e corte sem leitura");
+            else
+                conferir(terminou(r, cfg) && r.tCorte < 0 && r.cicloI2cMaxUs < 1000000u / cfg.acqHz,
+                         "termina sem corte, ciclo max %lu us dentro do periodo", (unsigned long)r.cicloI2cMaxUs);
+        }
+    }
+    return 0;
+}
+
+/* maior |apply() − correção linear por partes exata| (centésimos) de
+ * uma calibração, da borda inferior à superior da grade e além */
+static double erroTabela(const SensorCalibration& c)
+{
+    const int n = c.points();
+    double pior = 0;
+    for (int raw = SensorCalibration::GRID_MIN - 500; raw <= 12788 + 500; ++raw) {
+        double off = 0;
+        if (n > 0) {
+            const CalPoint& a = c.point(0);
+            const CalPoint& b = c.point(n - 1);
+            if (raw <= a.raw)      off = a.ref - a.raw;
+            else if (raw >= b.raw) off = b.ref - b.raw;
+            for (int i = 0; i + 1 < n; ++i) {
+                const CalPoint& p = c.point(i);
+                const CalPoint& q = c.point(i + 1);
+                if (raw < p.raw || raw >= q.raw) continue;
+                off = (p.ref - p.raw) + double((q.ref - q.raw) - (p.ref - p.raw)) * (raw - p.raw) / (q.raw - p.raw);
+            }
+        }
+        pior = std::max(pior, std::fabs(c.apply(static_cast<centi_t>(raw)) - (raw + off)));
+    }
+    return pior;
+}
+
+/* Sondas com desvio de fábrica (sonda 1: +0,94 °C a 20 °C, +0,35 °C
+ * a 65 °C, −0,32 °C a 95 °C; sonda 2: −0,52 a −0,22 °C), fora do
+ * ±0,5 °C do RF-01: sem calibração e com 1, 2 e 3 pontos de
+ * referência. O erro de leitura é o da sonda 1 entregue a 1 Hz contra
+ * a real (na planta slave, dominado pelo atraso do filtro). */
+static int cenarioCalibracao()
+{
+    SimConfig base;
+    base.erro[0].offset = 0.6;  base.erro[0].ganho = -0.015; base.erro[0].curva = -0.3;
+    base.erro[1].offset = -0.4; base.erro[1].ganho = 0.004;
+    for (double sigma : { 0.0, 0.1 }) {
+        for (const PlantaParams* pp : PLANTAS) {
+            printf("--- planta %s, ruido %.1f C ---\n", pp->nome, sigma);
+            double rms[4] = {}, desvio = 0;     // por pontos; pior desvio a 67 °C calibrado
+            double noPonto = 0, naReta = 0;     // centésimos, tabelas de 1 a 3 pontos
+            for (int n : { -1, 0, 1, 2, 3 }) {
+                SimConfig cfg = base;  cfg.ruido = sigma;
+                if (n < 0) cfg.erro[0] = cfg.erro[1] = ErroSonda();
+                else       cfg.calPontos = n;
+                char nome[32];
+                if (n < 0) snprintf(nome, sizeof(nome), "sondas exatas");
+                else       snprintf(nome, sizeof(nome), "desvio, %d pontos", n);
+                SimResultado r = simular(cfg, RECEITA_PADRAO, *pp);
+                imprimir(nome, r);
+                SensorCalibration c;
+                calibrar(c, cfg.erro[0], cfg.calPontos, sigma, 40);
+                const double a67 = cfg.erro[0](67.0) + c.offsetAt(tempFromFloat(
+                                   static_cast<float>(67.0 + cfg.erro[0](67.0))));
+                if (n >= 0) rms[n] = r.erroLeituraRms;
+                if (n >= 1) desvio = std::max(desvio, std::fabs(a67));
+                for (int i = 0; i < c.points(); ++i)
+                    noPonto = std::max(noPonto, std::fabs(c.apply(c.point(i).raw) - c.point(i).ref));
+                naReta = std::max(naReta, erroTabela(c));
+                printf("%22s erro de leitura rms=%.3f C max=%.3f C  sonda 1 a 67 C: %+.2f C  pontos:", "",
+                       r.erroLeituraRms, r.erroLeitura, a67);
+                for (int i = 0; i < c.points(); ++i)
+                    printf(" %.2f->%.2f", tempToC(c.point(i).raw), tempToC(c.point(i).ref));
+                printf("\n");
+            }
+            conferir(desvio <= 0.5, "calibrada (1 a 3 pontos), sonda 1 a 67 C dentro de 0,5 C (RF-01): %.2f C",
+                     desvio);
+            conferir(noPonto == 0 && naReta <= 1, "correcao exata nos pontos ajustados e a <= 0,01 C "
+                     "da reta entre eles (%.2f C)", naReta / TEMP_SCALE);
+            // no slave o erro é o atraso do filtro, não o desvio
+            if (pp == &PLANTA_TINA)
+                conferir(rms[3] < rms[0], "3 pontos leem melhor que sem calibracao (rms %.3f < %.3f C)",
+                         rms[3], rms[0]);
+        }
+    }
+
+    // 6 pontos com inclinação trocando de sinal e dois a um passo da
+    // grade (2,56 °C); um ponto a menos de um passo substitui o vizinho
+    {
+        SensorCalibration t;
+        const CalPoint P[] = { { 2000, 1906 }, { 2256, 2200 }, { 4500, 4480 },
+                               { 6535, 6500 }, { 7000, 7030 }, { 9468, 9500 } };
+        t.load(P, 6);
+        int noPonto = 0;
+        for (const CalPoint& q : P) noPonto = std::max(noPonto, std::abs(t.apply(q.raw) - q.ref));
+        const double reta = erroTabela(t);
+        t.addPoint(6770, 6760);
+        conferir(noPonto == 0 && reta <= 1 && t.points() == 5 && t.apply(6770) == 6760,
+                 "6 pontos: exata nos pontos, <= 0,01 C da reta entre eles (%.2f C); "
+                 "ponto a menos de 2,56 C de outros dois substitui os dois (%d pontos)", reta / TEMP_SCALE, t.points());
+    }
+
+    // custo por leitura no host
+    constexpr int N = 20000000;
+    SensorCalibration c;
+    calibrar(c, base.erro[0], 3, 0.1, 40);
+    std::vector<centi_t> x(1024);
+    Ruido ruido(20.0, 3);
+    for (centi_t& v : x) v = tempFromFloat(static_cast<float>(60.0 + ruido()));
+    long soma = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) soma += c.apply(x[i & 1023]);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - t0).count() / N;
+    printf("--- custo de SensorCalibration::apply() no host: %.2f ns/leitura (%ld) ---\n", ns, soma & 1);
+    return 0;
+}
+
+/* Planta simulada do firmware (SimProbeBackend, SENSOR_BACKEND_SIM):
+ * com o mesmo duty, as leituras do backend devem seguir a
+ * PlantaTermica do host; depois a mesma malha fechada (PID do firmware
+ * a 100 Hz, leituras a 20 Hz, média móvel para 1 Hz) sobre as duas,
+ * sem I²C. Os dois integram a 10 ms; o backend só vê o duty a cada
+ * leitura (50 ms), o que na planta slave (3,75 °C/s) dá até ~0,19 °C. */
+static uint32_t g_backendUs = 0;
+static uint32_t relogioBackend() { return g_backendUs; }
+static void lidoBackend(int dev, const uint8_t* data, uint8_t len, uint32_t, void* arg)
+{
+    if (data && len == 2) static_cast<centi_t*>(arg)[dev] = tempFromBytes(data);
+}
+
+static SimProbeBackend::Params paramsBackend(const PlantaParams& pp, double sigma)
+{
+    SimProbeBackend::Params bp;
+    bp.plant.heatGain = static_cast<float>(pp.ganho);
+    bp.plant.lossCoef = static_cast<float>(pp.perda);
+    bp.plant.ambient  = static_cast<float>(pp.ambiente);
+    bp.plant.deadTime = static_cast<float>(pp.atraso);
+    bp.probeTau = static_cast<float>(pp.tauSonda);
+    bp.noiseC   = static_cast<float>(sigma);
+    bp.startC   = static_cast<float>(pp.tInicial);
+    return bp;
+}
+
+struct MalhaResultado { double tChegada = -1, acima = 0, rms = 0, energia = 0; };
+
+static MalhaResultado malhaFechada(const PlantaParams& pp, bool backend, double sigma, double tFim)
+{
+    SensorRegistry reg;
+    reg.add(0x08, SENSOR_SLAVE_SIM);                // controle
+    reg.add(0x09, SENSOR_SLAVE_SIM);                // estratificação
+    g_backendUs = 0;
+    SimProbeBackend sim(reg, relogioBackend, paramsBackend(pp, sigma));
+    PlantaTermica planta(pp);
+    Ruido ruido(sigma, 1);
+    PidV1 pid(Kp, Ki, Kd, PID_DT);
+    pid.limites(0, PWM_MAX_DUTY);
+    DecimationFilter filtro({ 1, 20, 0 });
+    constexpr double SP = 67.0;
+    centi_t lido[2] = { tempFromFloat(static_cast<float>(pp.tInicial)), 0 };
+    double  pv = pp.tInicial, soma2 = 0;
+    long    n2 = 0;
+    MalhaResultado r;
+    const long ticks = std::lround(tFim * TICKS_PER_S);
+    for (long tick = 0; tick < ticks; ++tick) {
+        const double u = pid.compute(pv, SP) / PWM_MAX_DUTY;
+        r.energia += u * PID_DT;
+        g_backendUs = static_cast<uint32_t>(std::llround((tick + 1) * PID_DT * 1e6));
+        planta.passo(u, PID_DT);
+        const double t = (tick + 1) * PID_DT;
+        if ((tick + 1) % (TICKS_PER_S / 20)) continue;
+        if (backend) {
+            sim.heater(static_cast<float>(u));
+            sim.read(0x03, lidoBackend, lido);
+        } else {
+            lido[0] = lerSonda(planta.sonda() + ruido(), false);
+        }
+        if (!filtro.push(lido[0])) continue;
+        pv = tempToC(filtro.output());
+        const double massa = backend ? sim.bulk() : planta.bulk();
+        if (r.tChegada < 0 && massa >= SP - 0.5) r.tChegada = t;
+        if (r.tChegada >= 0) {
+            r.acima = std::max(r.acima, massa - SP);
+            if (t > tFim / 2) { soma2 += (massa - SP) * (massa - SP); ++n2; }
+        }
+    }
+    if (n2) r.rms = std::sqrt(soma2 / n2);
+    return r;
+}
+
+static int cenarioBackend()
+{
+    for (const PlantaParams* pp : PLANTAS) {
+        const bool tina = pp == &PLANTA_TINA;
+        const double tFim = tina ? 7200 : 600;
+        // malha aberta: plena potência, 30 % e desligado, um terço cada
+        SensorRegistry reg;
+        reg.add(0x08, SENSOR_SLAVE_SIM);
+        g_backendUs = 0;
+        SimProbeBackend sim(reg, relogioBackend, paramsBackend(*pp, 0));
+        PlantaTermica planta(*pp);
+        centi_t lido[1] = { 0 };
+        double  erroMax = 0, erroMassa = 0;
+        const long ticks = std::lround(tFim * TICKS_PER_S);
+        for (long tick = 0; tick < ticks; ++tick) {
+            const double u = tick < ticks / 3 ? 1.0 : tick < 2 * ticks / 3 ? 0.3 : 0.0;
+            planta.passo(u, PID_DT);
+            sim.heater(static_cast<float>(u));
+            g_backendUs = static_cast<uint32_t>(std::llround((tick + 1) * PID_DT * 1e6));
+            if ((tick + 1) % (TICKS_PER_S / 20)) continue;
+            sim.read(0x01, lidoBackend, lido);
+            erroMax   = std::max(erroMax, std::fabs(tempToC(lido[0]) - planta.sonda()));
+            erroMassa = std::max(erroMassa, std::fabs(sim.bulk() - planta.bulk()));
+        }
+        printf("--- planta %s: malha aberta %.0f s (100 %% / 30 %% / 0 %%) ---\n", pp->nome, tFim);
+        printf("%22s backend x host: massa max %.3f C, sonda max %.3f C (Q8.8 incluso)\n", "",
+               erroMassa, erroMax);
+        conferir(erroMassa <= 0.25 && erroMax <= 0.25, "malha aberta: backend segue a planta do host a 0,25 C");
+        printf("--- planta %s: PID a 67 C por %.0f s ---\n", pp->nome, tFim);
+        for (double sigma : { 0.0, 0.1 }) {
+            MalhaResultado m[2];
+            for (bool backend : { false, true }) {
+                m[backend] = malhaFechada(*pp, backend, sigma, tFim);
+                printf("%-22s ruido %.1f C  chegada=%6.0f s  acima=%5.2f C  rms(2a metade)=%.3f C  energia=%6.0f s\n",
+                       backend ? "SimProbeBackend" : "PlantaTermica", sigma, m[backend].tChegada,
+                       m[backend].acima, m[backend].rms, m[backend].energia);
+            }
+            conferir(std::fabs(m[1].tChegada - m[0].tChegada) <= 1 && std::fabs(m[1].acima - m[0].acima) <= 0.1 &&
+                     std::fabs(m[1].energia / m[0].energia - 1) <= 0.01,
+                     "malha fechada: mesma chegada, sobressinal e energia nas duas plantas");
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* cenario = argc > 1 ? argv[1] : "preheat";
+    int rc = -1;
+    if      (strcmp(cenario, "preheat") == 0)    rc = cenarioPreheat();
+    else if (strcmp(cenario, "approach") == 0)   rc = cenarioApproach();
+    else if (strcmp(cenario, "smith") == 0)      rc = cenarioSmith();
+    else if (strcmp(cenario, "fusao") == 0)      rc = cenarioFusao();
+    else if (strcmp(cenario, "ff") == 0)         rc = cenarioFeedForward();
+    else if (strcmp(cenario, "ssr") == 0)        rc = cenarioSsr();
+    else if (strcmp(cenario, "mixer") == 0)      rc = cenarioMixer();
+    else if (strcmp(cenario, "jitter") == 0)     rc = cenarioJitter();
+    else if (strcmp(cenario, "energia") == 0)    rc = cenarioEnergia();
+    else if (strcmp(cenario, "ident") == 0)      rc = cenarioIdent();
+    else if (strcmp(cenario, "falhas") == 0)     rc = cenarioFalhas();
+    else if (strcmp(cenario, "eta") == 0)        rc = cenarioEta();
+    else if (strcmp(cenario, "mpc") == 0)        rc = cenarioMpc();
+    else if (strcmp(cenario, "corte") == 0)      rc = cenarioCorte();
+    else if (strcmp(cenario, "resolucao") == 0)  rc = cenarioResolucao();
+    else if (strcmp(cenario, "aquisicao") == 0)  rc = cenarioAquisicao();
+    else if (strcmp(cenario, "sondas") == 0)     rc = cenarioSondas();
+    else if (strcmp(cenario, "conversao") == 0)  rc = cenarioConversao();
+    else if (strcmp(cenario, "i2c") == 0)        rc = cenarioI2c();
+    else if (strcmp(cenario, "calibracao") == 0) rc = cenarioCalibracao();
+    else if (strcmp(cenario, "backend") == 0)    rc = cenarioBackend();
+
+    if (rc < 0) {
+        fprintf(stderr, "cenario desconhecido: %s\n", cenario);
+        return 1;
+    }
+    if (g_falhas) {
+        printf("verificacoes com falha: %d\n", g_falhas);
+        return 1;
+    }
+    return rc;
+}